@@ -2,16 +2,18 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <memory>
 #include <mutex>
 
 #include "AudioCommon/AlsaSoundStream.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/Thread.h"
+#include "Core/ConfigManager.h"
 
 AlsaSound::AlsaSound()
     : m_thread_status(ALSAThreadStatus::STOPPED), handle(nullptr),
-      frames_to_deliver(FRAME_COUNT_MIN)
+      frames_to_deliver(FRAME_COUNT_MIN), sample_rate(0), buffer_size(0)
 {
 }
 
@@ -47,12 +49,34 @@ void AlsaSound::Update()
 void AlsaSound::SoundLoop()
 {
   Common::SetCurrentThreadName("Audio thread - alsa");
+  const u32 buffer_latency = static_cast<u32>(buffer_size * 1000 / sample_rate);
+  bool adaptive = false;
   while (m_thread_status.load() != ALSAThreadStatus::STOPPING)
   {
     while (m_thread_status.load() == ALSAThreadStatus::RUNNING)
     {
+      // Without adaptive latency, the whole hardware buffer is kept filled.
+      if (adaptive != SConfig::GetInstance().m_audio_adaptive_latency)
+      {
+        adaptive = !adaptive;
+        m_backend_latency->Reset(adaptive ? buffer_latency / 4 : buffer_latency);
+      }
+
+      snd_pcm_sframes_t delay = 0;
+      if (snd_pcm_delay(handle, &delay) < 0 || delay < 0)
+        delay = 0;
+      const snd_pcm_sframes_t target = m_backend_latency->GetTarget() * sample_rate / 1000;
+      if (adaptive && delay > target)
+      {
+        Common::SleepCurrentThread(static_cast<int>((delay - target) * 1000 / sample_rate));
+        if (snd_pcm_delay(handle, &delay) < 0 || delay < 0)
+          delay = 0;
+      }
+
       m_mixer->Mix(mix_buffer, frames_to_deliver);
       int rc = snd_pcm_writei(handle, mix_buffer, frames_to_deliver);
+      m_backend_latency->Update(delay * 1000.0f / sample_rate,
+                                frames_to_deliver * 1000.0f / sample_rate, rc == -EPIPE, adaptive);
       if (rc == -EPIPE)
       {
         // Underrun
@@ -87,12 +111,12 @@ bool AlsaSound::SetRunning(bool running)
 
 bool AlsaSound::AlsaInit()
 {
-  unsigned int sample_rate = m_mixer->GetSampleRate();
+  sample_rate = m_mixer->GetSampleRate();
   int err;
   int dir;
   snd_pcm_sw_params_t* swparams;
   snd_pcm_hw_params_t* hwparams;
-  snd_pcm_uframes_t buffer_size, buffer_size_max;
+  snd_pcm_uframes_t buffer_size_max;
   unsigned int periods;
 
   err = snd_pcm_open(&handle, "default", SND_PCM_STREAM_PLAYBACK, 0);
@@ -191,6 +215,13 @@ bool AlsaSound::AlsaInit()
              "samples per fragments.",
              buffer_size, periods, frames_to_deliver);
 
+  // The latency controller limits how much of the hardware buffer is used, down to two
+  // transfers.
+  const u32 buffer_latency = static_cast<u32>(buffer_size * 1000 / sample_rate);
+  m_backend_latency = std::make_unique<AudioCommon::LatencyController>(
+      "ALSA", frames_to_deliver * 2 * 1000 / sample_rate + 1, buffer_latency);
+  m_backend_latency->Reset(buffer_latency);
+
   snd_pcm_sw_params_alloca(&swparams);
 
   err = snd_pcm_sw_params_current(handle, swparams);
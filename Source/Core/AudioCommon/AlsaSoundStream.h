@@ -59,5 +59,7 @@ private:
 
   snd_pcm_t* handle;
   unsigned int frames_to_deliver;
+  unsigned int sample_rate;
+  snd_pcm_uframes_t buffer_size;
 #endif
 };
@@ -145,6 +145,8 @@ void UpdateSoundStream()
   {
     int volume = SConfig::GetInstance().m_IsMuted ? 0 : SConfig::GetInstance().m_Volume;
     g_sound_stream->SetVolume(volume);
+    g_sound_stream->GetMixer()->SetResamplerQuality(
+        static_cast<Mixer::ResamplerQuality>(SConfig::GetInstance().m_audio_resampler_quality));
   }
 }
 
@@ -187,8 +189,9 @@ void SendAIBuffer(const short* samples, unsigned int num_samples)
 
 void StartAudioDump()
 {
-  std::string audio_file_name_dtk = File::GetUserPath(D_DUMPAUDIO_IDX) + "dtkdump.wav";
-  std::string audio_file_name_dsp = File::GetUserPath(D_DUMPAUDIO_IDX) + "dspdump.wav";
+  const std::string extension = SConfig::GetInstance().m_DumpAudioFlac ? ".flac" : ".wav";
+  std::string audio_file_name_dtk = File::GetUserPath(D_DUMPAUDIO_IDX) + "dtkdump" + extension;
+  std::string audio_file_name_dsp = File::GetUserPath(D_DUMPAUDIO_IDX) + "dspdump" + extension;
   File::CreateFullPath(audio_file_name_dtk);
   File::CreateFullPath(audio_file_name_dsp);
   g_sound_stream->GetMixer()->StartLogDTKAudio(audio_file_name_dtk);
@@ -231,4 +234,19 @@ void ToggleMuteVolume()
   isMuted = !isMuted;
   UpdateSoundStream();
 }
+
+LatencyStats GetLatencyStats()
+{
+  LatencyStats stats{};
+  if (!g_sound_stream)
+    return stats;
+
+  stats.mixer = g_sound_stream->GetMixer()->GetLatencyStats();
+  if (const LatencyController* backend = g_sound_stream->GetBackendLatency())
+  {
+    stats.has_backend = true;
+    stats.backend = backend->GetStats();
+  }
+  return stats;
+}
 }
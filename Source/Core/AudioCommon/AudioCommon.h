@@ -8,6 +8,7 @@
 #include <string>
 #include <vector>
 
+#include "AudioCommon/LatencyController.h"
 #include "AudioCommon/SoundStream.h"
 
 class Mixer;
@@ -16,6 +17,14 @@ extern std::unique_ptr<SoundStream> g_sound_stream;
 
 namespace AudioCommon
 {
+struct LatencyStats
+{
+  LatencyController::Stats mixer;
+  // The backend stats are only valid for backends which resize the buffer of the audio device.
+  bool has_backend;
+  LatencyController::Stats backend;
+};
+
 void InitSoundStream();
 void ShutdownSoundStream();
 std::string GetDefaultSoundBackend();
@@ -31,4 +40,5 @@ void StopAudioDump();
 void IncreaseVolume(unsigned short offset);
 void DecreaseVolume(unsigned short offset);
 void ToggleMuteVolume();
+LatencyStats GetLatencyStats();
 }
@@ -8,7 +8,6 @@
 
 #include "AudioCommon/AudioStretcher.h"
 #include "Common/Logging/Log.h"
-#include "Core/ConfigManager.h"
 
 namespace AudioCommon
 {
@@ -29,14 +28,14 @@ void AudioStretcher::Clear()
   m_sound_touch.clear();
 }
 
-void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsigned int num_out)
+void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsigned int num_out,
+                                    unsigned int max_latency)
 {
   const double time_delta = static_cast<double>(num_out) / m_sample_rate;  // seconds
 
   // We were given actual_samples number of samples, and num_samples were requested from us.
   double current_ratio = static_cast<double>(num_in) / static_cast<double>(num_out);
 
-  const double max_latency = SConfig::GetInstance().m_audio_stretch_max_latency;
   const double max_backlog = m_sample_rate * max_latency / 1000.0 / m_stretch_ratio;
   const double backlog_fullness = m_sound_touch.numSamples() / max_backlog;
   if (backlog_fullness > 5.0)
@@ -68,9 +67,9 @@ void AudioStretcher::ProcessSamples(const short* in, unsigned int num_in, unsign
   m_sound_touch.putSamples(in, num_in);
 }
 
-void AudioStretcher::GetStretchedSamples(short* out, unsigned int num_out)
+unsigned int AudioStretcher::GetStretchedSamples(short* out, unsigned int num_out)
 {
-  const size_t samples_received = m_sound_touch.receiveSamples(out, num_out);
+  const unsigned int samples_received = m_sound_touch.receiveSamples(out, num_out);
 
   if (samples_received != 0)
   {
@@ -84,6 +83,13 @@ void AudioStretcher::GetStretchedSamples(short* out, unsigned int num_out)
     out[i * 2 + 0] = m_last_stretched_sample[0];
     out[i * 2 + 1] = m_last_stretched_sample[1];
   }
+
+  return samples_received;
+}
+
+unsigned int AudioStretcher::GetBufferedSamples() const
+{
+  return m_sound_touch.numSamples();
 }
 
 }  // namespace AudioCommon
@@ -14,8 +14,11 @@ class AudioStretcher
 {
 public:
   explicit AudioStretcher(unsigned int sample_rate);
-  void ProcessSamples(const short* in, unsigned int num_in, unsigned int num_out);
-  void GetStretchedSamples(short* out, unsigned int num_out);
+  void ProcessSamples(const short* in, unsigned int num_in, unsigned int num_out,
+                      unsigned int max_latency);
+  // Returns the number of samples which were available, the rest is padding.
+  unsigned int GetStretchedSamples(short* out, unsigned int num_out);
+  unsigned int GetBufferedSamples() const;
   void Clear();
 
 private:
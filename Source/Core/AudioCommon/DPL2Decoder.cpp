@@ -10,11 +10,12 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
-#include <cstring>
-#include <functional>
-#include <numeric>
 #include <vector>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <xmmintrin.h>
+#endif
+
 #include "AudioCommon/DPL2Decoder.h"
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
@@ -34,41 +35,50 @@ static float l_fwr, r_fwr, lpr_fwr, lmr_fwr;
 static std::vector<float> fwrbuf_l, fwrbuf_r;
 static float adapt_l_gain, adapt_r_gain, adapt_lpr_gain, adapt_lmr_gain;
 static std::vector<float> lf, rf, lr, rr, cf, cr;
-static float LFE_buf[256];
-static unsigned int lfe_pos;
+// The matrix decoder adapts its gains from sample to sample, but the LFE lowpass only depends on
+// its output, so it is run over blocks of this many samples.
+static constexpr int DECODE_BLOCK_SIZE = 256;
+// Input of the LFE lowpass: the last len125 - 1 samples of the previous block, followed by the
+// samples of the current block in chronological order.
+static std::vector<float> lfe_history;
 static std::vector<float> filter_coefs_lfe;
 static unsigned int len125;
 
-template <class T>
-static float DotProduct(int count, const T* buf, const std::vector<float>& coeffs, int offset)
+// count must be a multiple of 16.
+static float DotProduct(const float* a, const float* b, unsigned int count)
 {
-  return std::inner_product(buf, buf + count, coeffs.begin() + offset, T(0));
-}
-
-template <class T>
-static T FIRFilter(const T* buf, int pos, int len, int count, const std::vector<float>& coeffs)
-{
-  int count1, count2;
-
-  if (pos >= count)
+#if defined(_M_X86) || defined(_M_X86_64)
+  __m128 sum0 = _mm_setzero_ps();
+  __m128 sum1 = _mm_setzero_ps();
+  __m128 sum2 = _mm_setzero_ps();
+  __m128 sum3 = _mm_setzero_ps();
+  for (unsigned int i = 0; i < count; i += 16)
   {
-    pos -= count;
-    count1 = count;
-    count2 = 0;
+    sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(a + i + 8), _mm_loadu_ps(b + i + 8)));
+    sum3 = _mm_add_ps(sum3, _mm_mul_ps(_mm_loadu_ps(a + i + 12), _mm_loadu_ps(b + i + 12)));
   }
-  else
+  __m128 sum = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+  return _mm_cvtss_f32(sum);
+#else
+  float sums[4] = {};
+  for (unsigned int i = 0; i < count; i += 4)
   {
-    count2 = pos;
-    count1 = count - pos;
-    pos = len - count1;
+    for (unsigned int j = 0; j < 4; ++j)
+      sums[j] += a[i + j] * b[i + j];
   }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+#endif
+}
 
-  // high part of window
-  const T* ptr = &buf[pos];
-
-  float r1 = DotProduct(count1, ptr, coeffs, 0);
-  float r2 = DotProduct(count2, buf, coeffs, count1);
-  return T(r1 + r2);
+// Filters count samples of lfe_history and stores them in every 6th float of out.
+static void LowpassLFE(int count, float* out)
+{
+  for (int i = 0; i < count; ++i)
+    out[i * 6] = DotProduct(&lfe_history[i], filter_coefs_lfe.data(), len125);
 }
 
 /*
@@ -167,8 +177,7 @@ static void OnSeek()
   std::fill(rr.begin(), rr.end(), 0.0f);
   std::fill(cf.begin(), cf.end(), 0.0f);
   std::fill(cr.begin(), cr.end(), 0.0f);
-  lfe_pos = 0;
-  memset(LFE_buf, 0, sizeof(LFE_buf));
+  std::fill(lfe_history.begin(), lfe_history.end(), 0.0f);
 }
 
 static void Done()
@@ -188,6 +197,11 @@ static std::vector<float> CalculateCoefficients125HzLowpass(int rate)
   {
     coeffs[i] *= M3_01DB;
   }
+
+  // The filter used to run over a ring buffer, starting at the newest sample with the first tap,
+  // and continuing with the oldest sample and the second tap. Store the taps in that order for
+  // samples in chronological order.
+  std::rotate(coeffs.begin(), coeffs.begin() + 1, coeffs.end());
   return coeffs;
 }
 
@@ -287,7 +301,6 @@ void DPL2Decode(float* samples, int numsamples, float* out)
   static const unsigned int FWRDURATION = 240;  // FWR average duration (samples)
   static const int cfg_delay = 0;
   static const unsigned int fmt_freq = 48000;
-  static const unsigned int fmt_nchannels = 2;  // input channels
 
   int cur = 0;
 
@@ -307,52 +320,54 @@ void DPL2Decode(float* samples, int numsamples, float* out)
     cf.resize(dlbuflen);
     cr.resize(dlbuflen);
     filter_coefs_lfe = CalculateCoefficients125HzLowpass(fmt_freq);
-    lfe_pos = 0;
-    memset(LFE_buf, 0, sizeof(LFE_buf));
+    lfe_history.assign(len125 - 1 + DECODE_BLOCK_SIZE, 0.0f);
   }
 
-  float* in = samples;                           // Input audio data
-  float* end = in + numsamples * fmt_nchannels;  // Loop end
+  float* in = samples;  // Input audio data
 
-  while (in < end)
+  while (numsamples > 0)
   {
-    const int k = cyc_pos;
-
-    const int fwr_pos = (k + FWRDURATION) % dlbuflen;
-    /* Update the full wave rectified total amplitude */
-    /* Input matrix decoder */
-    l_fwr += fabs(in[0]) - fabs(fwrbuf_l[fwr_pos]);
-    r_fwr += fabs(in[1]) - fabs(fwrbuf_r[fwr_pos]);
-    lpr_fwr += fabs(in[0] + in[1]) - fabs(fwrbuf_l[fwr_pos] + fwrbuf_r[fwr_pos]);
-    lmr_fwr += fabs(in[0] - in[1]) - fabs(fwrbuf_l[fwr_pos] - fwrbuf_r[fwr_pos]);
-
-    /* Matrix encoded 2 channel sources */
-    fwrbuf_l[k] = in[0];
-    fwrbuf_r[k] = in[1];
-    MatrixDecode(in, k, 0, 1, true, dlbuflen, l_fwr, r_fwr, lpr_fwr, lmr_fwr, &adapt_l_gain,
-                 &adapt_r_gain, &adapt_lpr_gain, &adapt_lmr_gain, &lf[0], &rf[0], &lr[0], &rr[0],
-                 &cf[0]);
-
-    out[cur + 0] = lf[k];
-    out[cur + 1] = rf[k];
-    out[cur + 2] = cf[k];
-    LFE_buf[lfe_pos] = (lf[k] + rf[k] + 2.0f * cf[k] + lr[k] + rr[k]) / 2.0f;
-    out[cur + 3] = FIRFilter(LFE_buf, lfe_pos, len125, len125, filter_coefs_lfe);
-    lfe_pos++;
-    if (lfe_pos == len125)
+    const int block_size = std::min(numsamples, DECODE_BLOCK_SIZE);
+    float* lfe_in = &lfe_history[len125 - 1];
+    for (int i = 0; i < block_size; ++i)
     {
-      lfe_pos = 0;
-    }
-    out[cur + 4] = lr[k];
-    out[cur + 5] = rr[k];
-    // Next sample...
-    in += 2;
-    cur += 6;
-    cyc_pos--;
-    if (cyc_pos < 0)
-    {
-      cyc_pos += dlbuflen;
+      const int k = cyc_pos;
+
+      const int fwr_pos = (k + FWRDURATION) % dlbuflen;
+      /* Update the full wave rectified total amplitude */
+      /* Input matrix decoder */
+      l_fwr += fabs(in[0]) - fabs(fwrbuf_l[fwr_pos]);
+      r_fwr += fabs(in[1]) - fabs(fwrbuf_r[fwr_pos]);
+      lpr_fwr += fabs(in[0] + in[1]) - fabs(fwrbuf_l[fwr_pos] + fwrbuf_r[fwr_pos]);
+      lmr_fwr += fabs(in[0] - in[1]) - fabs(fwrbuf_l[fwr_pos] - fwrbuf_r[fwr_pos]);
+
+      /* Matrix encoded 2 channel sources */
+      fwrbuf_l[k] = in[0];
+      fwrbuf_r[k] = in[1];
+      MatrixDecode(in, k, 0, 1, true, dlbuflen, l_fwr, r_fwr, lpr_fwr, lmr_fwr, &adapt_l_gain,
+                   &adapt_r_gain, &adapt_lpr_gain, &adapt_lmr_gain, &lf[0], &rf[0], &lr[0], &rr[0],
+                   &cf[0]);
+
+      out[cur + 0] = lf[k];
+      out[cur + 1] = rf[k];
+      out[cur + 2] = cf[k];
+      lfe_in[i] = (lf[k] + rf[k] + 2.0f * cf[k] + lr[k] + rr[k]) / 2.0f;
+      out[cur + 4] = lr[k];
+      out[cur + 5] = rr[k];
+      // Next sample...
+      in += 2;
+      cur += 6;
+      cyc_pos--;
+      if (cyc_pos < 0)
+      {
+        cyc_pos += dlbuflen;
+      }
     }
+
+    LowpassLFE(block_size, &out[cur - block_size * 6 + 3]);
+    std::copy(lfe_history.begin() + block_size, lfe_history.begin() + block_size + len125 - 1,
+              lfe_history.begin());
+    numsamples -= block_size;
   }
 }
 
@@ -0,0 +1,482 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "AudioCommon/FlacEncoder.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace AudioCommon
+{
+namespace
+{
+constexpr u32 MAX_FIXED_ORDER = 4;
+constexpr u32 MAX_PARTITION_ORDER = 8;
+constexpr u32 MAX_PARTITIONS = 1 << MAX_PARTITION_ORDER;
+// The largest parameter of the 4-bit Rice coding method, 15 is reserved as an escape code.
+constexpr u32 MAX_RICE_PARAMETER = 14;
+
+enum Channel
+{
+  LEFT,
+  RIGHT,
+  MID,
+  SIDE,
+};
+
+// Stereo decorrelation modes of the frame header.
+enum ChannelAssignment : u32
+{
+  INDEPENDENT = 0x1,
+  LEFT_SIDE = 0x8,
+  SIDE_RIGHT = 0x9,
+  MID_SIDE = 0xA,
+};
+
+class BitWriter final
+{
+public:
+  explicit BitWriter(std::vector<u8>* output) : m_output(output) {}
+
+  // Writes the lowest bits of value, most significant bit first.
+  void Write(u32 value, u32 bits)
+  {
+    m_buffer = (m_buffer << bits) | (value & ((u64{1} << bits) - 1));
+    m_bits += bits;
+    while (m_bits >= 8)
+    {
+      m_bits -= 8;
+      m_output->push_back(static_cast<u8>(m_buffer >> m_bits));
+    }
+  }
+
+  void WriteRice(u32 value, u32 parameter)
+  {
+    u32 quotient = value >> parameter;
+    const u32 remainder = value & ((1u << parameter) - 1);
+    for (; quotient + 1 + parameter > 32; quotient -= 16)
+      Write(0, 16);
+    // The quotient in unary, terminated by a one, followed by the remainder.
+    Write((1u << parameter) | remainder, quotient + 1 + parameter);
+  }
+
+  void AlignToByte()
+  {
+    if (m_bits != 0)
+      Write(0, 8 - m_bits);
+  }
+
+private:
+  std::vector<u8>* m_output;
+  u64 m_buffer = 0;
+  u32 m_bits = 0;
+};
+
+u8 CRC8(const u8* data, size_t size)
+{
+  u32 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+  }
+  return static_cast<u8>(crc);
+}
+
+u16 CRC16(const u8* data, size_t size)
+{
+  u32 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc ^= u32{data[i]} << 8;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x8005 : crc << 1;
+  }
+  return static_cast<u16>(crc);
+}
+
+u32 SampleRateCode(u32 sample_rate)
+{
+  switch (sample_rate)
+  {
+  case 88200:
+    return 0x1;
+  case 176400:
+    return 0x2;
+  case 192000:
+    return 0x3;
+  case 8000:
+    return 0x4;
+  case 16000:
+    return 0x5;
+  case 22050:
+    return 0x6;
+  case 24000:
+    return 0x7;
+  case 32000:
+    return 0x8;
+  case 44100:
+    return 0x9;
+  case 48000:
+    return 0xA;
+  case 96000:
+    return 0xB;
+  default:
+    // Stored in Hz after the block size, or only in STREAMINFO if it does not fit.
+    return sample_rate <= 0xFFFF ? 0xD : 0x0;
+  }
+}
+
+void WriteFrameNumber(BitWriter* writer, u32 number)
+{
+  // Coded like UTF-8 characters.
+  if (number < 0x80)
+  {
+    writer->Write(number, 8);
+    return;
+  }
+
+  u32 continuation_bytes = 1;
+  while (continuation_bytes < 5 && number >= (1u << (5 * continuation_bytes + 6)))
+    ++continuation_bytes;
+  const u32 prefix = (0xFF00 >> (continuation_bytes + 1)) & 0xFF;
+  writer->Write(prefix | (number >> (6 * continuation_bytes)), 8);
+  for (u32 i = continuation_bytes; i-- > 0;)
+    writer->Write(0x80 | ((number >> (6 * i)) & 0x3F), 8);
+}
+
+// Residual of a fixed polynomial predictor, folded to an unsigned value for Rice coding.
+void ComputeResidual(const s32* samples, u32 count, u32 order, u32* residual)
+{
+  for (u32 i = order; i < count; ++i)
+  {
+    s32 value;
+    switch (order)
+    {
+    case 0:
+      value = samples[i];
+      break;
+    case 1:
+      value = samples[i] - samples[i - 1];
+      break;
+    case 2:
+      value = samples[i] - 2 * samples[i - 1] + samples[i - 2];
+      break;
+    case 3:
+      value = samples[i] - 3 * samples[i - 1] + 3 * samples[i - 2] - samples[i - 3];
+      break;
+    default:
+      value = samples[i] - 4 * samples[i - 1] + 6 * samples[i - 2] - 4 * samples[i - 3] +
+              samples[i - 4];
+      break;
+    }
+    residual[i] = (static_cast<u32>(value) << 1) ^ static_cast<u32>(value >> 31);
+  }
+}
+
+// Estimates the size of count values with the given sum for the best Rice parameter.
+u64 RiceBits(u64 sum, u32 count, u32* parameter)
+{
+  u64 best_bits = std::numeric_limits<u64>::max();
+  for (u32 k = 0; k <= MAX_RICE_PARAMETER; ++k)
+  {
+    const u64 bits = u64{count} * (k + 1) + (sum >> k);
+    if (bits < best_bits)
+    {
+      best_bits = bits;
+      *parameter = k;
+    }
+  }
+  return best_bits;
+}
+
+struct Subframe
+{
+  enum class Type
+  {
+    Constant,
+    Verbatim,
+    Fixed,
+  };
+
+  Type type;
+  u32 order;
+  u32 partition_order;
+  std::array<u8, MAX_PARTITIONS> parameters;
+  u64 bits;
+};
+
+// Picks the partition order and the Rice parameters which code the residual in the fewest bits.
+u64 ChooseRiceParameters(const u32* residual, u32 count, u32 order, Subframe* subframe)
+{
+  u32 max_partition_order = 0;
+  while (max_partition_order < MAX_PARTITION_ORDER &&
+         ((count >> (max_partition_order + 1)) << (max_partition_order + 1)) == count &&
+         (count >> (max_partition_order + 1)) > order)
+  {
+    ++max_partition_order;
+  }
+
+  std::array<u64, MAX_PARTITIONS> sums;
+  const u32 max_partition_size = count >> max_partition_order;
+  for (u32 partition = 0; partition < (1u << max_partition_order); ++partition)
+  {
+    u64 sum = 0;
+    const u32 end = (partition + 1) * max_partition_size;
+    for (u32 i = std::max(partition * max_partition_size, order); i < end; ++i)
+      sum += residual[i];
+    sums[partition] = sum;
+  }
+
+  // Halve the number of partitions at every step by merging their sums.
+  u64 best_bits = std::numeric_limits<u64>::max();
+  for (u32 partition_order = max_partition_order;; --partition_order)
+  {
+    const u32 partitions = 1u << partition_order;
+    const u32 partition_size = count >> partition_order;
+    std::array<u8, MAX_PARTITIONS> parameters;
+    u64 bits = 0;
+    for (u32 partition = 0; partition < partitions; ++partition)
+    {
+      u32 parameter = 0;
+      const u32 size = partition_size - (partition == 0 ? order : 0);
+      bits += 4 + RiceBits(sums[partition], size, &parameter);
+      parameters[partition] = static_cast<u8>(parameter);
+    }
+    if (bits < best_bits)
+    {
+      best_bits = bits;
+      subframe->partition_order = partition_order;
+      subframe->parameters = parameters;
+    }
+
+    if (partition_order == 0)
+      break;
+    for (u32 partition = 0; partition < partitions / 2; ++partition)
+      sums[partition] = sums[partition * 2] + sums[partition * 2 + 1];
+  }
+
+  // Coding method and partition order.
+  return best_bits + 6;
+}
+
+Subframe AnalyzeSubframe(const s32* samples, u32 count, u32 bits_per_sample,
+                         std::vector<u32>* residual)
+{
+  // The subframe header is 8 bits for all types.
+  Subframe best;
+  best.type = Subframe::Type::Verbatim;
+  best.bits = 8 + u64{bits_per_sample} * count;
+
+  if (std::all_of(samples, samples + count, [&](s32 sample) { return sample == samples[0]; }))
+  {
+    best.type = Subframe::Type::Constant;
+    best.bits = 8 + bits_per_sample;
+    return best;
+  }
+
+  Subframe fixed;
+  fixed.type = Subframe::Type::Fixed;
+  for (u32 order = 0; order <= MAX_FIXED_ORDER && order < count; ++order)
+  {
+    ComputeResidual(samples, count, order, residual->data());
+    fixed.order = order;
+    fixed.bits = 8 + order * bits_per_sample +
+                 ChooseRiceParameters(residual->data(), count, order, &fixed);
+    if (fixed.bits < best.bits)
+      best = fixed;
+  }
+  return best;
+}
+
+void WriteSubframe(BitWriter* writer, const s32* samples, u32 count, u32 bits_per_sample,
+                   const Subframe& subframe, std::vector<u32>* residual)
+{
+  switch (subframe.type)
+  {
+  case Subframe::Type::Constant:
+    writer->Write(0x00, 8);
+    writer->Write(static_cast<u32>(samples[0]), bits_per_sample);
+    break;
+
+  case Subframe::Type::Verbatim:
+    writer->Write(0x02, 8);
+    for (u32 i = 0; i < count; ++i)
+      writer->Write(static_cast<u32>(samples[i]), bits_per_sample);
+    break;
+
+  case Subframe::Type::Fixed:
+  {
+    writer->Write((0x08 | subframe.order) << 1, 8);
+    for (u32 i = 0; i < subframe.order; ++i)
+      writer->Write(static_cast<u32>(samples[i]), bits_per_sample);
+
+    ComputeResidual(samples, count, subframe.order, residual->data());
+    writer->Write(0, 2);
+    writer->Write(subframe.partition_order, 4);
+    const u32 partition_size = count >> subframe.partition_order;
+    for (u32 partition = 0; partition < (1u << subframe.partition_order); ++partition)
+    {
+      const u32 parameter = subframe.parameters[partition];
+      writer->Write(parameter, 4);
+      const u32 end = (partition + 1) * partition_size;
+      for (u32 i = std::max(partition * partition_size, subframe.order); i < end; ++i)
+        writer->WriteRice((*residual)[i], parameter);
+    }
+    break;
+  }
+  }
+}
+}  // Anonymous namespace
+
+constexpr u32 FlacEncoder::BLOCK_SIZE;
+constexpr size_t FlacEncoder::HEADER_SIZE;
+
+FlacEncoder::FlacEncoder(u32 sample_rate) : m_sample_rate(sample_rate)
+{
+  m_pending.reserve(BLOCK_SIZE * 2);
+  for (std::vector<s32>& channel : m_channels)
+    channel.reserve(BLOCK_SIZE);
+  m_residual.resize(BLOCK_SIZE);
+}
+
+std::array<u8, FlacEncoder::HEADER_SIZE> FlacEncoder::GetHeader() const
+{
+  std::vector<u8> bytes{'f', 'L', 'a', 'C'};
+  BitWriter writer(&bytes);
+
+  // Last metadata block flag, STREAMINFO type and length.
+  writer.Write(0x80, 8);
+  writer.Write(34, 24);
+
+  writer.Write(BLOCK_SIZE, 16);
+  writer.Write(BLOCK_SIZE, 16);
+  writer.Write(m_min_frame_size, 24);
+  writer.Write(m_max_frame_size, 24);
+  writer.Write(m_sample_rate, 20);
+  // Two channels, 16 bits per sample.
+  writer.Write(2 - 1, 3);
+  writer.Write(16 - 1, 5);
+  writer.Write(static_cast<u32>(m_total_frames >> 32), 4);
+  writer.Write(static_cast<u32>(m_total_frames), 32);
+  // The MD5 signature of the audio is optional, all zeroes means that it was not computed.
+  bytes.resize(HEADER_SIZE);
+
+  std::array<u8, HEADER_SIZE> header;
+  std::copy(bytes.begin(), bytes.end(), header.begin());
+  return header;
+}
+
+void FlacEncoder::AddFrames(const s16* frames, u32 count, std::vector<u8>* output)
+{
+  while (count > 0)
+  {
+    if (m_pending.empty() && count >= BLOCK_SIZE)
+    {
+      EncodeBlock(frames, BLOCK_SIZE, output);
+      frames += BLOCK_SIZE * 2;
+      count -= BLOCK_SIZE;
+      continue;
+    }
+
+    const u32 pending_count = static_cast<u32>(m_pending.size() / 2);
+    const u32 added = std::min(count, BLOCK_SIZE - pending_count);
+    m_pending.insert(m_pending.end(), frames, frames + added * 2);
+    frames += added * 2;
+    count -= added;
+    if (m_pending.size() == BLOCK_SIZE * 2)
+    {
+      EncodeBlock(m_pending.data(), BLOCK_SIZE, output);
+      m_pending.clear();
+    }
+  }
+}
+
+void FlacEncoder::Finish(std::vector<u8>* output)
+{
+  if (m_pending.empty())
+    return;
+
+  EncodeBlock(m_pending.data(), static_cast<u32>(m_pending.size() / 2), output);
+  m_pending.clear();
+}
+
+void FlacEncoder::EncodeBlock(const s16* frames, u32 count, std::vector<u8>* output)
+{
+  for (std::vector<s32>& channel : m_channels)
+    channel.resize(count);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s32 left = frames[i * 2];
+    const s32 right = frames[i * 2 + 1];
+    m_channels[LEFT][i] = left;
+    m_channels[RIGHT][i] = right;
+    m_channels[MID][i] = (left + right) >> 1;
+    m_channels[SIDE][i] = left - right;
+  }
+
+  // The side channel needs one more bit.
+  const std::array<u32, 4> bits_per_sample{{16, 16, 16, 17}};
+  std::array<Subframe, 4> subframes;
+  for (size_t channel = 0; channel < m_channels.size(); ++channel)
+  {
+    subframes[channel] =
+        AnalyzeSubframe(m_channels[channel].data(), count, bits_per_sample[channel], &m_residual);
+  }
+
+  struct Mode
+  {
+    ChannelAssignment assignment;
+    Channel first;
+    Channel second;
+  };
+  static constexpr std::array<Mode, 4> modes{{{INDEPENDENT, LEFT, RIGHT},
+                                              {LEFT_SIDE, LEFT, SIDE},
+                                              {SIDE_RIGHT, SIDE, RIGHT},
+                                              {MID_SIDE, MID, SIDE}}};
+  const Mode& mode = *std::min_element(modes.begin(), modes.end(), [&](const Mode& a,
+                                                                       const Mode& b) {
+    return subframes[a.first].bits + subframes[a.second].bits <
+           subframes[b.first].bits + subframes[b.second].bits;
+  });
+
+  const size_t frame_start = output->size();
+  output->reserve(frame_start + (subframes[mode.first].bits + subframes[mode.second].bits) / 8 +
+                  32);
+  BitWriter writer(output);
+
+  // Sync code, fixed block size stream.
+  writer.Write(0x3FFE, 14);
+  writer.Write(0, 2);
+  // Block size as a 16-bit value after the frame number.
+  writer.Write(0x7, 4);
+  const u32 sample_rate_code = SampleRateCode(m_sample_rate);
+  writer.Write(sample_rate_code, 4);
+  writer.Write(mode.assignment, 4);
+  // 16 bits per sample.
+  writer.Write(0x4, 3);
+  writer.Write(0, 1);
+  WriteFrameNumber(&writer, m_block_index);
+  writer.Write(count - 1, 16);
+  if (sample_rate_code == 0xD)
+    writer.Write(m_sample_rate, 16);
+  writer.Write(CRC8(output->data() + frame_start, output->size() - frame_start), 8);
+
+  for (Channel channel : {mode.first, mode.second})
+  {
+    WriteSubframe(&writer, m_channels[channel].data(), count, bits_per_sample[channel],
+                  subframes[channel], &m_residual);
+  }
+
+  writer.AlignToByte();
+  writer.Write(CRC16(output->data() + frame_start, output->size() - frame_start), 16);
+
+  const u32 frame_size = static_cast<u32>(output->size() - frame_start);
+  m_min_frame_size = m_min_frame_size == 0 ? frame_size : std::min(m_min_frame_size, frame_size);
+  m_max_frame_size = std::max(m_max_frame_size, frame_size);
+  m_total_frames += count;
+  ++m_block_index;
+}
+}  // namespace AudioCommon
@@ -0,0 +1,53 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// Minimal encoder for 16-bit stereo FLAC streams, used to shrink audio dumps. Every frame is
+// coded with the best of the fixed polynomial predictors and Rice coded residuals, which is
+// roughly what "flac -3" produces, and fast enough to keep up with the emulated audio.
+//
+// The encoder only produces bytes; the caller writes them to disk. Since the total sample count is
+// only known at the end, the caller rewrites the header returned by GetHeader() after Finish().
+class FlacEncoder final
+{
+public:
+  // Frames per FLAC block.
+  static constexpr u32 BLOCK_SIZE = 4096;
+  // Size of the "fLaC" marker and the STREAMINFO metadata block.
+  static constexpr size_t HEADER_SIZE = 42;
+
+  explicit FlacEncoder(u32 sample_rate);
+
+  std::array<u8, HEADER_SIZE> GetHeader() const;
+
+  // Appends interleaved left/right frames in native endianness, and the encoded frames to output.
+  void AddFrames(const s16* frames, u32 count, std::vector<u8>* output);
+  // Encodes the last, possibly shorter block.
+  void Finish(std::vector<u8>* output);
+
+  u64 GetFrameCount() const { return m_total_frames; }
+
+private:
+  void EncodeBlock(const s16* frames, u32 count, std::vector<u8>* output);
+
+  u32 m_sample_rate;
+  u64 m_total_frames = 0;
+  u32 m_block_index = 0;
+  u32 m_min_frame_size = 0;
+  u32 m_max_frame_size = 0;
+
+  std::vector<s16> m_pending;
+  std::array<std::vector<s32>, 4> m_channels;
+  std::vector<u32> m_residual;
+};
+}  // namespace AudioCommon
@@ -0,0 +1,130 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "AudioCommon/LatencyController.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
+
+namespace AudioCommon
+{
+// The fill level is summarized over windows of this length.
+static constexpr float WINDOW_MS = 1000.0f;
+// Windows in a row without underruns before the target is lowered.
+static constexpr u32 QUIET_WINDOWS_BEFORE_LOWERING = 10;
+// Underruns come in bursts, which should only raise the target once.
+static constexpr float RAISE_HOLDOFF_MS = 200.0f;
+// Part of the lowest fill level which is kept as headroom when lowering the target.
+static constexpr float LOWERING_HEADROOM = 0.5f;
+
+LatencyController::LatencyController(const char* name, u32 min_ms, u32 max_ms)
+    : m_name(name), m_min_ms(min_ms), m_max_ms(max_ms), m_target_ms(min_ms)
+{
+}
+
+void LatencyController::Reset(u32 target_ms)
+{
+  m_target_ms.store(MathUtil::Clamp(target_ms, m_min_ms, m_max_ms), std::memory_order_relaxed);
+  m_window_elapsed_ms = 0.0f;
+  m_window_underrun = false;
+  m_quiet_windows = 0;
+  m_quiet_min_ms = 0.0f;
+  m_since_raise_ms = RAISE_HOLDOFF_MS;
+}
+
+void LatencyController::ReportUnderrun()
+{
+  m_pending_underrun.store(true, std::memory_order_relaxed);
+}
+
+void LatencyController::Update(float buffered_ms, float elapsed_ms, bool underrun, bool adaptive)
+{
+  if (m_pending_underrun.exchange(false, std::memory_order_relaxed))
+    underrun = true;
+
+  m_since_raise_ms += elapsed_ms;
+  if (underrun)
+  {
+    m_underruns.fetch_add(1, std::memory_order_relaxed);
+    m_window_underrun = true;
+    m_quiet_windows = 0;
+    m_quiet_min_ms = 0.0f;
+    if (adaptive && m_since_raise_ms >= RAISE_HOLDOFF_MS)
+      Raise();
+  }
+
+  if (m_window_elapsed_ms == 0.0f)
+  {
+    m_window_min_ms = buffered_ms;
+    m_window_max_ms = buffered_ms;
+    m_window_weighted_sum = 0.0f;
+  }
+  m_window_min_ms = std::min(m_window_min_ms, buffered_ms);
+  m_window_max_ms = std::max(m_window_max_ms, buffered_ms);
+  m_window_weighted_sum += buffered_ms * elapsed_ms;
+  m_window_elapsed_ms += elapsed_ms;
+  if (m_window_elapsed_ms < WINDOW_MS)
+    return;
+
+  m_buffered_ms.store(static_cast<u32>(m_window_weighted_sum / m_window_elapsed_ms),
+                      std::memory_order_relaxed);
+  m_jitter_ms.store(static_cast<u32>(m_window_max_ms - m_window_min_ms),
+                    std::memory_order_relaxed);
+
+  if (!m_window_underrun)
+  {
+    m_quiet_min_ms =
+        m_quiet_windows == 0 ? m_window_min_ms : std::min(m_quiet_min_ms, m_window_min_ms);
+    if (++m_quiet_windows >= QUIET_WINDOWS_BEFORE_LOWERING)
+    {
+      if (adaptive)
+        Lower();
+      m_quiet_windows = 0;
+      m_quiet_min_ms = 0.0f;
+    }
+  }
+  m_window_elapsed_ms = 0.0f;
+  m_window_underrun = false;
+}
+
+void LatencyController::Raise()
+{
+  const u32 target = GetTarget();
+  const u32 new_target = std::min(m_max_ms, target + std::max(target / 4, 2u));
+  m_since_raise_ms = 0.0f;
+  if (new_target == target)
+    return;
+
+  m_target_ms.store(new_target, std::memory_order_relaxed);
+  WARN_LOG(AUDIO, "%s underrun, raising the latency to %u ms", m_name, new_target);
+}
+
+void LatencyController::Lower()
+{
+  // Only give up part of the headroom which the buffer has not needed, so that the jitter of the
+  // fill level is still covered.
+  const u32 target = GetTarget();
+  const u32 unused = static_cast<u32>(std::floor(m_quiet_min_ms * LOWERING_HEADROOM));
+  const u32 step = std::min(std::max(target / 8, 1u), unused);
+  const u32 new_target = std::max(m_min_ms, target - std::min(step, target));
+  if (new_target == target)
+    return;
+
+  m_target_ms.store(new_target, std::memory_order_relaxed);
+  INFO_LOG(AUDIO, "%s is stable, lowering the latency to %u ms", m_name, new_target);
+}
+
+LatencyController::Stats LatencyController::GetStats() const
+{
+  Stats stats;
+  stats.target_ms = GetTarget();
+  stats.buffered_ms = m_buffered_ms.load(std::memory_order_relaxed);
+  stats.jitter_ms = m_jitter_ms.load(std::memory_order_relaxed);
+  stats.underruns = m_underruns.load(std::memory_order_relaxed);
+  return stats;
+}
+}  // namespace AudioCommon
@@ -0,0 +1,71 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+
+#include "Common/CommonTypes.h"
+
+namespace AudioCommon
+{
+// Sizes an audio buffer from how it is actually drained. Underruns raise the target latency right
+// away. While the buffer never runs low for a while, the target is lowered step by step, but it
+// keeps enough headroom for the lowest fill level seen over that quiet period.
+//
+// Update() and ReportUnderrun() must be called from the thread which drains the buffer, except
+// that ReportUnderrun() may also be called from an audio API callback on another thread. The
+// getters may be called from any thread.
+class LatencyController final
+{
+public:
+  struct Stats
+  {
+    // Current target of the buffer, in milliseconds.
+    u32 target_ms;
+    // Average and spread of the fill level over the last measurement window.
+    u32 buffered_ms;
+    u32 jitter_ms;
+    u64 underruns;
+  };
+
+  LatencyController(const char* name, u32 min_ms, u32 max_ms);
+
+  // Starts over from the given target. The underrun count is kept.
+  void Reset(u32 target_ms);
+
+  // Called after every transfer with the amount of audio which was buffered before it, and the
+  // duration of the transfer. The target is only changed when adaptive is set.
+  void Update(float buffered_ms, float elapsed_ms, bool underrun, bool adaptive);
+  void ReportUnderrun();
+
+  u32 GetTarget() const { return m_target_ms.load(std::memory_order_relaxed); }
+  Stats GetStats() const;
+
+private:
+  void Raise();
+  void Lower();
+
+  const char* m_name;
+  u32 m_min_ms;
+  u32 m_max_ms;
+
+  // State of the draining thread.
+  float m_window_elapsed_ms = 0.0f;
+  float m_window_weighted_sum = 0.0f;
+  float m_window_min_ms = 0.0f;
+  float m_window_max_ms = 0.0f;
+  bool m_window_underrun = false;
+  u32 m_quiet_windows = 0;
+  // Lowest fill level over the quiet windows so far.
+  float m_quiet_min_ms = 0.0f;
+  float m_since_raise_ms = 0.0f;
+
+  std::atomic<u32> m_target_ms;
+  std::atomic<u32> m_buffered_ms{0};
+  std::atomic<u32> m_jitter_ms{0};
+  std::atomic<u64> m_underruns{0};
+  std::atomic<bool> m_pending_underrun{false};
+};
+}  // namespace AudioCommon
@@ -4,9 +4,14 @@
 
 #include "AudioCommon/Mixer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
+
 #include "AudioCommon/DPL2Decoder.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
@@ -33,21 +38,234 @@ void Mixer::DoState(PointerWrap& p)
   m_wiimote_speaker_mixer.DoState(p);
 }
 
+// The windowed sinc filter uses the 8 input frames around the output position, with one set of
+// coefficients for each 1/256th of a frame.
+static constexpr u32 SINC_TAPS = 8;
+static constexpr u32 SINC_PHASES = 256;
+using SincTable = std::array<std::array<float, SINC_TAPS>, SINC_PHASES>;
+
+static SincTable CreateSincTable()
+{
+  // A slightly lower cutoff than the input Nyquist frequency keeps the short filter from ringing.
+  constexpr double CUTOFF = 0.9;
+  constexpr double PI = 3.14159265358979323846;
+  SincTable table;
+  for (u32 phase = 0; phase < SINC_PHASES; ++phase)
+  {
+    double sum = 0.0;
+    std::array<double, SINC_TAPS> taps;
+    for (u32 tap = 0; tap < SINC_TAPS; ++tap)
+    {
+      // Distance from the output position, from -4 to 4 frames.
+      const double x = static_cast<double>(tap) - (SINC_TAPS / 2 - 1) -
+                       static_cast<double>(phase) / SINC_PHASES;
+      const double sinc = x == 0.0 ? 1.0 : std::sin(PI * CUTOFF * x) / (PI * CUTOFF * x);
+      const double window = 0.42 + 0.5 * std::cos(PI * x / (SINC_TAPS / 2)) +
+                            0.08 * std::cos(2 * PI * x / (SINC_TAPS / 2));
+      taps[tap] = sinc * window;
+      sum += taps[tap];
+    }
+    // Normalize every phase so that constant signals keep their level.
+    for (u32 tap = 0; tap < SINC_TAPS; ++tap)
+      table[phase][tap] = static_cast<float>(taps[tap] / sum);
+  }
+  return table;
+}
+
+alignas(16) static const SincTable s_sinc_table = CreateSincTable();
+
+// Number of input frames after the interpolated position which each resampler reads.
+static u32 GetResamplerTapsAfter(Mixer::ResamplerQuality quality)
+{
+  switch (quality)
+  {
+  case Mixer::ResamplerQuality::Cubic:
+    return 2;
+  case Mixer::ResamplerQuality::Sinc:
+    return SINC_TAPS / 2;
+  case Mixer::ResamplerQuality::Linear:
+  default:
+    return 1;
+  }
+}
+
+// The resamplers write count frames of interleaved right and left samples to output. left and
+// right point at the input frame at the read position, and frac is the position of the first
+// output frame after it. Returns the number of input frames which have been consumed.
+static u32 ResampleLinear(const s16* left, const s16* right, s16* output, u32 count, u32* frac,
+                          u32 ratio)
+{
+  u32 index = 0;
+  u32 position = *frac;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const s32 l1 = left[index];
+    const s32 l2 = left[index + 1];
+    output[i * 2 + 1] = ((l1 << 16) + (l2 - l1) * (u16)position) >> 16;
+
+    const s32 r1 = right[index];
+    const s32 r2 = right[index + 1];
+    output[i * 2] = ((r1 << 16) + (r2 - r1) * (u16)position) >> 16;
+
+    position += ratio;
+    index += position >> 16;
+    position &= 0xffff;
+  }
+  *frac = position;
+  return index;
+}
+
+#if defined(_M_X86) || defined(_M_X86_64)
+// Sums the lanes of the per-channel products, and stores them as one output frame.
+static void StoreFrame(s16* output, __m128 products_left, __m128 products_right)
+{
+  // The left sum ends up in the first lane and the right one in the second.
+  __m128 sums = _mm_add_ps(_mm_unpacklo_ps(products_left, products_right),
+                           _mm_unpackhi_ps(products_left, products_right));
+  sums = _mm_add_ps(sums, _mm_movehl_ps(sums, sums));
+  const __m128i results = _mm_packs_epi32(_mm_cvtps_epi32(sums), _mm_setzero_si128());
+  output[1] = static_cast<s16>(_mm_extract_epi16(results, 0));
+  output[0] = static_cast<s16>(_mm_extract_epi16(results, 1));
+}
+
+static __m128 SignExtendToFloat(__m128i samples)
+{
+  return _mm_cvtepi32_ps(_mm_srai_epi32(samples, 16));
+}
+#else
+static s16 RoundToSample(float value)
+{
+  return static_cast<s16>(MathUtil::Clamp<long>(std::lrint(value), -32768, 32767));
+}
+#endif
+
+// Catmull-Rom spline through the two frames before and after the position.
+static u32 ResampleCubic(const s16* left, const s16* right, s16* output, u32 count, u32* frac,
+                         u32 ratio)
+{
+  u32 index = 0;
+  u32 position = *frac;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const float t = position / 65536.0f;
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    const float weights[4] = {0.5f * (-t3 + 2.0f * t2 - t), 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f),
+                              0.5f * (-3.0f * t3 + 4.0f * t2 + t), 0.5f * (t3 - t2)};
+    const s16* left_taps = left + index - 1;
+    const s16* right_taps = right + index - 1;
+#if defined(_M_X86) || defined(_M_X86_64)
+    const __m128 w = _mm_loadu_ps(weights);
+    const __m128i l = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(left_taps));
+    const __m128i r = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(right_taps));
+    StoreFrame(&output[i * 2], _mm_mul_ps(SignExtendToFloat(_mm_unpacklo_epi16(l, l)), w),
+               _mm_mul_ps(SignExtendToFloat(_mm_unpacklo_epi16(r, r)), w));
+#else
+    float sum_left = 0.0f;
+    float sum_right = 0.0f;
+    for (u32 tap = 0; tap < 4; ++tap)
+    {
+      sum_left += left_taps[tap] * weights[tap];
+      sum_right += right_taps[tap] * weights[tap];
+    }
+    output[i * 2 + 1] = RoundToSample(sum_left);
+    output[i * 2] = RoundToSample(sum_right);
+#endif
+
+    position += ratio;
+    index += position >> 16;
+    position &= 0xffff;
+  }
+  *frac = position;
+  return index;
+}
+
+static u32 ResampleSinc(const s16* left, const s16* right, s16* output, u32 count, u32* frac,
+                        u32 ratio)
+{
+  u32 index = 0;
+  u32 position = *frac;
+  for (u32 i = 0; i < count; ++i)
+  {
+    const float* coefficients = s_sinc_table[position >> 8].data();
+    const s16* left_taps = left + index - (SINC_TAPS / 2 - 1);
+    const s16* right_taps = right + index - (SINC_TAPS / 2 - 1);
+#if defined(_M_X86) || defined(_M_X86_64)
+    const __m128 c0 = _mm_load_ps(coefficients);
+    const __m128 c1 = _mm_load_ps(coefficients + 4);
+    const auto dot = [&](const s16* taps) {
+      const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps));
+      return _mm_add_ps(_mm_mul_ps(SignExtendToFloat(_mm_unpacklo_epi16(samples, samples)), c0),
+                        _mm_mul_ps(SignExtendToFloat(_mm_unpackhi_epi16(samples, samples)), c1));
+    };
+    StoreFrame(&output[i * 2], dot(left_taps), dot(right_taps));
+#else
+    float sum_left = 0.0f;
+    float sum_right = 0.0f;
+    for (u32 tap = 0; tap < SINC_TAPS; ++tap)
+    {
+      sum_left += left_taps[tap] * coefficients[tap];
+      sum_right += right_taps[tap] * coefficients[tap];
+    }
+    output[i * 2 + 1] = RoundToSample(sum_left);
+    output[i * 2] = RoundToSample(sum_right);
+#endif
+
+    position += ratio;
+    index += position >> 16;
+    position &= 0xffff;
+  }
+  *frac = position;
+  return index;
+}
+
+// Scales the resampled frames by the volume and adds them to the output with saturation.
+static void MixWithVolume(short* samples, const s16* resampled, u32 count, s32 lvolume,
+                          s32 rvolume)
+{
+  u32 i = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  if (lvolume >= 0 && lvolume <= 0x7fff && rvolume >= 0 && rvolume <= 0x7fff)
+  {
+    const __m128i volume = _mm_set_epi16(lvolume, rvolume, lvolume, rvolume, lvolume, rvolume,
+                                         lvolume, rvolume);
+    const __m128i minimum = _mm_set1_epi16(-32767);
+    for (; i + 8 <= count * 2; i += 8)
+    {
+      const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(resampled + i));
+      const __m128i product_lo = _mm_mullo_epi16(input, volume);
+      const __m128i product_hi = _mm_mulhi_epi16(input, volume);
+      __m128i first = _mm_srai_epi32(_mm_unpacklo_epi16(product_lo, product_hi), 8);
+      __m128i second = _mm_srai_epi32(_mm_unpackhi_epi16(product_lo, product_hi), 8);
+
+      const __m128i existing = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+      first = _mm_add_epi32(first, _mm_srai_epi32(_mm_unpacklo_epi16(existing, existing), 16));
+      second = _mm_add_epi32(second, _mm_srai_epi32(_mm_unpackhi_epi16(existing, existing), 16));
+
+      const __m128i mixed = _mm_max_epi16(_mm_packs_epi32(first, second), minimum);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), mixed);
+    }
+  }
+#endif
+  for (; i < count * 2; ++i)
+  {
+    int sample = (resampled[i] * ((i & 1) ? lvolume : rvolume)) >> 8;
+    sample += samples[i];
+    samples[i] = MathUtil::Clamp(sample, -32767, 32767);
+  }
+}
+
 // Executed from sound stream thread
 unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
                                    bool consider_framelimit)
 {
   unsigned int currentSample = 0;
 
-  // Cache access in non-volatile variable
-  // This is the only function changing the read value, so it's safe to
-  // cache it locally although it's written here.
-  // The writing pointer will be modified outside, but it will only increase,
-  // so we will just ignore new written data while interpolating.
-  // Without this cache, the compiler wouldn't be allowed to optimize the
-  // interpolation loop.
-  u32 indexR = m_indexR.load();
-  u32 indexW = m_indexW.load();
+  // This is the only function changing the read index. The write index only increases, so new
+  // data written while interpolating is simply picked up by the next call. The acquire load makes
+  // the samples before the write index visible to this thread.
+  u32 indexR = m_indexR.load(std::memory_order_relaxed);
+  u32 indexW = m_indexW.load(std::memory_order_acquire);
 
   // render numleft sample pairs to samples[]
   // advance indexR with sample position
@@ -59,7 +277,7 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   {
     float numLeft = static_cast<float>(((indexW - indexR) & INDEX_MASK) / 2);
 
-    u32 low_waterwark = m_input_sample_rate * SConfig::GetInstance().iTimingVariance / 1000;
+    u32 low_waterwark = m_input_sample_rate * m_mixer->m_latency.GetTarget() / 1000;
     low_waterwark = std::min(low_waterwark, MAX_SAMPLES / 2);
 
     m_numLeftI = (numLeft + m_numLeftI * (CONTROL_AVG - 1)) / CONTROL_AVG;
@@ -77,28 +295,58 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
   s32 lvolume = m_LVolume.load();
   s32 rvolume = m_RVolume.load();
 
-  // TODO: consider a higher-quality resampling algorithm.
-  for (; currentSample < numSamples * 2 && ((indexW - indexR) & INDEX_MASK) > 2; currentSample += 2)
+  const ResamplerQuality quality = m_mixer->m_resampler_quality.load();
+  const u32 taps_after = GetResamplerTapsAfter(quality);
+
+  // Resample in blocks: find how many frames can be produced from the available input, copy the
+  // input frames they need out of the ring buffer, then interpolate and mix them.
+  while (currentSample < numSamples * 2)
   {
-    u32 indexR2 = indexR + 2;  // next sample
-
-    s16 l1 = Common::swap16(m_buffer[indexR & INDEX_MASK]);   // current
-    s16 l2 = Common::swap16(m_buffer[indexR2 & INDEX_MASK]);  // next
-    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)m_frac) >> 16;
-    sampleL = (sampleL * lvolume) >> 8;
-    sampleL += samples[currentSample + 1];
-    samples[currentSample + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
-
-    s16 r1 = Common::swap16(m_buffer[(indexR + 1) & INDEX_MASK]);   // current
-    s16 r2 = Common::swap16(m_buffer[(indexR2 + 1) & INDEX_MASK]);  // next
-    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)m_frac) >> 16;
-    sampleR = (sampleR * rvolume) >> 8;
-    sampleR += samples[currentSample];
-    samples[currentSample] = MathUtil::Clamp(sampleR, -32767, 32767);
-
-    m_frac += ratio;
-    indexR += 2 * (u16)(m_frac >> 16);
-    m_frac &= 0xffff;
+    const u32 available = ((indexW - indexR) & INDEX_MASK) / 2;
+    const u32 block_size = std::min(numSamples - currentSample / 2, MIX_BLOCK_FRAMES);
+    u32 count = 0;
+    u32 last_index = 0;
+    for (u32 index = 0, frac = m_frac; count < block_size && index + taps_after < available;
+         ++count)
+    {
+      last_index = index;
+      frac += ratio;
+      index += frac >> 16;
+      frac &= 0xffff;
+    }
+    if (count == 0)
+      break;
+
+    const u32 input_frames = last_index + taps_after + 1;
+    for (u32 i = 0; i < RESAMPLER_HISTORY + input_frames; ++i)
+    {
+      const u32 index = indexR + (i - RESAMPLER_HISTORY) * 2;
+      m_left_input[i] = Common::swap16(m_buffer[index & INDEX_MASK]);
+      m_right_input[i] = Common::swap16(m_buffer[(index + 1) & INDEX_MASK]);
+    }
+
+    const s16* left = &m_left_input[RESAMPLER_HISTORY];
+    const s16* right = &m_right_input[RESAMPLER_HISTORY];
+    u32 consumed;
+    switch (quality)
+    {
+    case ResamplerQuality::Cubic:
+      consumed = ResampleCubic(left, right, m_resampled.data(), count, &m_frac, ratio);
+      break;
+    case ResamplerQuality::Sinc:
+      consumed = ResampleSinc(left, right, m_resampled.data(), count, &m_frac, ratio);
+      break;
+    case ResamplerQuality::Linear:
+    default:
+      consumed = ResampleLinear(left, right, m_resampled.data(), count, &m_frac, ratio);
+      break;
+    }
+
+    MixWithVolume(&samples[currentSample], m_resampled.data(), count, lvolume, rvolume);
+    indexR += consumed * 2;
+    currentSample += count * 2;
+    if (count < block_size)
+      break;
   }
 
   // Actual number of samples written to the buffer without padding.
@@ -119,8 +367,8 @@ unsigned int Mixer::MixerFifo::Mix(short* samples, unsigned int numSamples,
     samples[currentSample + 1] = sampleL;
   }
 
-  // Flush cached variable
-  m_indexR.store(indexR);
+  // Releases the consumed part of the buffer to the producer.
+  m_indexR.store(indexR, std::memory_order_release);
 
   return actual_sample_count;
 }
@@ -132,8 +380,26 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
 
   memset(samples, 0, num_samples * 2 * sizeof(short));
 
-  if (SConfig::GetInstance().m_audio_stretch)
+  const SConfig& config = SConfig::GetInstance();
+  const bool stretch = config.m_audio_stretch;
+  const bool adaptive = config.m_audio_adaptive_latency;
+  const int configured_latency =
+      stretch ? config.m_audio_stretch_max_latency : config.iTimingVariance;
+  if (stretch != m_is_stretching || adaptive != m_adaptive_latency ||
+      configured_latency != m_configured_latency)
   {
+    // Start over from the configured latency whenever the settings change.
+    m_latency.Reset(configured_latency);
+    m_configured_latency = configured_latency;
+    m_adaptive_latency = adaptive;
+  }
+
+  float buffered_ms;
+  unsigned int mixed_samples;
+  if (stretch)
+  {
+    buffered_ms = m_stretcher.GetBufferedSamples() * 1000.0f / m_sampleRate;
+
     unsigned int available_samples =
         std::min(m_dma_mixer.AvailableSamples(), m_streaming_mixer.AvailableSamples());
 
@@ -148,17 +414,24 @@ unsigned int Mixer::Mix(short* samples, unsigned int num_samples)
       m_stretcher.Clear();
       m_is_stretching = true;
     }
-    m_stretcher.ProcessSamples(m_scratch_buffer.data(), available_samples, num_samples);
-    m_stretcher.GetStretchedSamples(samples, num_samples);
+    m_stretcher.ProcessSamples(m_scratch_buffer.data(), available_samples, num_samples,
+                               m_latency.GetTarget());
+    mixed_samples = m_stretcher.GetStretchedSamples(samples, num_samples);
   }
   else
   {
-    m_dma_mixer.Mix(samples, num_samples, true);
+    buffered_ms = m_dma_mixer.AvailableSamples() * 1000.0f / m_sampleRate;
+
+    mixed_samples = m_dma_mixer.Mix(samples, num_samples, true);
     m_streaming_mixer.Mix(samples, num_samples, true);
     m_wiimote_speaker_mixer.Mix(samples, num_samples, true);
     m_is_stretching = false;
   }
 
+  const bool underrun = m_was_mixing && mixed_samples < num_samples;
+  m_was_mixing = mixed_samples == num_samples;
+  m_latency.Update(buffered_ms, num_samples * 1000.0f / m_sampleRate, underrun, adaptive);
+
   return num_samples;
 }
 
@@ -185,15 +458,19 @@ unsigned int Mixer::MixSurround(float* samples, unsigned int num_samples)
 
 void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_samples)
 {
-  // Cache access in non-volatile variable
-  // indexR isn't allowed to cache in the audio throttling loop as it
-  // needs to get updates to not deadlock.
-  u32 indexW = m_indexW.load();
+  // This is the only function changing the write index. The acquire load of the read index
+  // makes sure that the audio thread is done with the samples which are about to be overwritten.
+  u32 indexW = m_indexW.load(std::memory_order_relaxed);
 
   // Check if we have enough free space
-  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW
-  if (num_samples * 2 + ((indexW - m_indexR.load()) & INDEX_MASK) >= MAX_SAMPLES * 2)
+  // indexW == m_indexR results in empty buffer, so indexR must always be smaller than indexW.
+  // The frames right before the read index are kept for the interpolation filters.
+  if (num_samples * 2 + ((indexW - m_indexR.load(std::memory_order_acquire)) & INDEX_MASK) +
+          RESAMPLER_HISTORY * 2 >=
+      MAX_SAMPLES * 2)
+  {
     return;
+  }
 
   // AyuanX: Actual re-sampling work has been moved to sound thread
   // to alleviate the workload on main thread
@@ -209,7 +486,8 @@ void Mixer::MixerFifo::PushSamples(const short* samples, unsigned int num_sample
     memcpy(&m_buffer[indexW & INDEX_MASK], samples, num_samples * 4);
   }
 
-  m_indexW.fetch_add(num_samples * 2);
+  // Publishes the new samples to the audio thread.
+  m_indexW.store(indexW + num_samples * 2, std::memory_order_release);
 }
 
 void Mixer::PushSamples(const short* samples, unsigned int num_samples)
@@ -267,6 +545,11 @@ void Mixer::SetWiimoteSpeakerVolume(unsigned int lvolume, unsigned int rvolume)
   m_wiimote_speaker_mixer.SetVolume(lvolume, rvolume);
 }
 
+void Mixer::SetResamplerQuality(ResamplerQuality quality)
+{
+  m_resampler_quality.store(quality);
+}
+
 void Mixer::StartLogDTKAudio(const std::string& filename)
 {
   if (!m_log_dtk_audio)
@@ -8,6 +8,7 @@
 #include <atomic>
 
 #include "AudioCommon/AudioStretcher.h"
+#include "AudioCommon/LatencyController.h"
 #include "AudioCommon/WaveFile.h"
 #include "Common/CommonTypes.h"
 
@@ -16,6 +17,15 @@ class PointerWrap;
 class Mixer final
 {
 public:
+  // Interpolation used to convert the sample rate of the FIFOs to the output sample rate, set
+  // from SConfig::m_audio_resampler_quality.
+  enum class ResamplerQuality
+  {
+    Linear,
+    Cubic,
+    Sinc,
+  };
+
   explicit Mixer(unsigned int BackendSampleRate);
   ~Mixer();
 
@@ -35,6 +45,7 @@ public:
   void SetStreamInputSampleRate(unsigned int rate);
   void SetStreamingVolume(unsigned int lvolume, unsigned int rvolume);
   void SetWiimoteSpeakerVolume(unsigned int lvolume, unsigned int rvolume);
+  void SetResamplerQuality(ResamplerQuality quality);
 
   void StartLogDTKAudio(const std::string& filename);
   void StopLogDTKAudio();
@@ -45,12 +56,22 @@ public:
   float GetCurrentSpeed() const { return m_speed.load(); }
   void UpdateSpeed(float val) { m_speed.store(val); }
 
+  // Buffering of the FIFOs, or of the stretcher when audio stretching is enabled.
+  AudioCommon::LatencyController::Stats GetLatencyStats() const { return m_latency.GetStats(); }
+
 private:
   static constexpr u32 MAX_SAMPLES = 1024 * 4;  // 128 ms
   static constexpr u32 INDEX_MASK = MAX_SAMPLES * 2 - 1;
   static constexpr int MAX_FREQ_SHIFT = 200;  // Per 32000 Hz
   static constexpr float CONTROL_FACTOR = 0.2f;
   static constexpr u32 CONTROL_AVG = 32;  // In freq_shift per FIFO size offset
+  static constexpr u32 MIN_LATENCY = 5;     // In ms
+  static constexpr u32 MAX_LATENCY = 200;   // In ms
+  // Frames before the read position which the producer never overwrites, so that the
+  // interpolation filters can look back at them.
+  static constexpr u32 RESAMPLER_HISTORY = 3;
+  // Output frames which are interpolated at a time before being mixed.
+  static constexpr u32 MIX_BLOCK_FRAMES = 256;
 
   class MixerFifo final
   {
@@ -70,15 +91,23 @@ private:
     Mixer* m_mixer;
     unsigned m_input_sample_rate;
     std::array<short, MAX_SAMPLES * 2> m_buffer{};
-    std::atomic<u32> m_indexW{0};
-    std::atomic<u32> m_indexR{0};
+    // The producer only writes m_indexW and the audio thread only writes m_indexR, so they are
+    // kept on separate cache lines.
+    alignas(64) std::atomic<u32> m_indexW{0};
+    alignas(64) std::atomic<u32> m_indexR{0};
     // Volume ranges from 0-256
     std::atomic<s32> m_LVolume{256};
     std::atomic<s32> m_RVolume{256};
     float m_numLeftI = 0.0f;
     u32 m_frac = 0;
+    // Byte-swapped input frames of the block being resampled, preceded by the history frames.
+    std::array<s16, RESAMPLER_HISTORY + MAX_SAMPLES> m_left_input;
+    std::array<s16, RESAMPLER_HISTORY + MAX_SAMPLES> m_right_input;
+    std::array<short, MIX_BLOCK_FRAMES * 2> m_resampled;
   };
 
+  std::atomic<ResamplerQuality> m_resampler_quality{ResamplerQuality::Linear};
+
   MixerFifo m_dma_mixer{this, 32000};
   MixerFifo m_streaming_mixer{this, 48000};
   MixerFifo m_wiimote_speaker_mixer{this, 3000};
@@ -86,6 +115,14 @@ private:
 
   bool m_is_stretching = false;
   AudioCommon::AudioStretcher m_stretcher;
+
+  // The target is the low watermark of the FIFOs, or the maximum backlog of the stretcher.
+  AudioCommon::LatencyController m_latency{"Audio mixer", MIN_LATENCY, MAX_LATENCY};
+  int m_configured_latency = -1;
+  bool m_adaptive_latency = false;
+  // Whether the last mix had enough samples, so that running out is an underrun rather than
+  // the game not producing any audio.
+  bool m_was_mixing = false;
   std::array<short, MAX_SAMPLES * 2> m_scratch_buffer;
   std::array<float, MAX_SAMPLES * 2> m_float_conversion_buffer;
 
@@ -2,7 +2,9 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
+#include <memory>
 
 #include "AudioCommon/PulseAudioStream.h"
 #include "Common/CommonTypes.h"
@@ -13,6 +15,7 @@
 namespace
 {
 const size_t BUFFER_SAMPLES = 512;  // ~10 ms - needs to be at least 240 for surround
+const u32 MAX_LATENCY = 500;        // In ms
 }
 
 PulseAudio::PulseAudio() : m_thread(), m_run_thread()
@@ -26,6 +29,11 @@ bool PulseAudio::Init()
 
   NOTICE_LOG(AUDIO, "PulseAudio backend using %d channels", m_channels);
 
+  const u32 min_latency = BUFFER_SAMPLES * 1000 / m_mixer->GetSampleRate();
+  m_backend_latency =
+      std::make_unique<AudioCommon::LatencyController>("PulseAudio", min_latency, MAX_LATENCY);
+  m_backend_latency->Reset(min_latency);
+
   m_run_thread.Set();
   m_thread = std::thread(&PulseAudio::SoundLoop, this);
 
@@ -116,9 +124,8 @@ bool PulseAudio::PulseInit()
   m_pa_ba.maxlength = -1;  // max buffer, so also max latency
   m_pa_ba.minreq = -1;     // don't read every byte, try to group them _a bit_
   m_pa_ba.prebuf = -1;     // start as early as possible
-  m_pa_ba.tlength =
-      BUFFER_SAMPLES * m_channels *
-      m_bytespersample;  // designed latency, only change this flag for low latency output
+  // designed latency, only change this flag for low latency output
+  m_pa_ba.tlength = LatencyToBytes(m_backend_latency->GetTarget());
   pa_stream_flags flags = pa_stream_flags(PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_ADJUST_LATENCY |
                                           PA_STREAM_AUTO_TIMING_UPDATE);
   m_pa_error = pa_stream_connect_playback(m_pa_s, nullptr, &m_pa_ba, flags, nullptr, nullptr);
@@ -155,9 +162,21 @@ void PulseAudio::StateCallback(pa_context* c)
     break;
   }
 }
-// on underflow, increase pulseaudio latency in ~10ms steps
+u32 PulseAudio::LatencyToBytes(u32 latency_ms) const
+{
+  const size_t frames =
+      std::max<size_t>(BUFFER_SAMPLES, m_mixer->GetSampleRate() * latency_ms / 1000);
+  return static_cast<u32>(frames * m_channels * m_bytespersample);
+}
+
+// on underflow, increase pulseaudio latency in ~10ms steps, unless the latency controller sizes
+// the buffer, which then raises it in the next write callback
 void PulseAudio::UnderflowCallback(pa_stream* s)
 {
+  m_backend_latency->ReportUnderrun();
+  if (SConfig::GetInstance().m_audio_adaptive_latency)
+    return;
+
   m_pa_ba.tlength += BUFFER_SAMPLES * m_channels * m_bytespersample;
   pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
   pa_operation_unref(op);
@@ -210,6 +229,25 @@ void PulseAudio::WriteCallback(pa_stream* s, size_t length)
   }
 
   m_pa_error = pa_stream_write(s, buffer, trunc_length, nullptr, 0, PA_SEEK_RELATIVE);
+
+  // Without adaptive latency, the buffer only grows on underflows, as it always did.
+  const bool adaptive = SConfig::GetInstance().m_audio_adaptive_latency;
+  pa_usec_t latency = 0;
+  int negative = 0;
+  if (pa_stream_get_latency(s, &latency, &negative) < 0 || negative)
+    latency = 0;
+  m_backend_latency->Update(latency / 1000.0f, frames * 1000.0f / m_mixer->GetSampleRate(), false,
+                            adaptive);
+  if (!adaptive)
+    return;
+
+  const u32 tlength = LatencyToBytes(m_backend_latency->GetTarget());
+  if (tlength != m_pa_ba.tlength)
+  {
+    m_pa_ba.tlength = tlength;
+    pa_operation* op = pa_stream_set_buffer_attr(s, &m_pa_ba, nullptr, nullptr);
+    pa_operation_unref(op);
+  }
 }
 
 // Callbacks that forward to internal methods (required because PulseAudio is a C API).
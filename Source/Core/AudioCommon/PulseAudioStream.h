@@ -32,6 +32,7 @@ private:
 
   bool PulseInit();
   void PulseShutdown();
+  u32 LatencyToBytes(u32 latency_ms) const;
 
   // wrapper callback functions, last parameter _must_ be PulseAudio*
   static void StateCallback(pa_context* c, void* userdata);
@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "AudioCommon/LatencyController.h"
 #include "AudioCommon/Mixer.h"
 #include "Common/CommonTypes.h"
 
@@ -13,12 +14,18 @@ class SoundStream
 {
 protected:
   std::unique_ptr<Mixer> m_mixer;
+  // Only set by the backends which resize the buffer of the audio device.
+  std::unique_ptr<AudioCommon::LatencyController> m_backend_latency;
 
 public:
   SoundStream() : m_mixer(new Mixer(48000)) {}
   virtual ~SoundStream() {}
   static bool isValid() { return false; }
   Mixer* GetMixer() const { return m_mixer.get(); }
+  const AudioCommon::LatencyController* GetBackendLatency() const
+  {
+    return m_backend_latency.get();
+  }
   virtual bool Init() { return false; }
   virtual void SetVolume(int) {}
   virtual void SoundLoop() {}
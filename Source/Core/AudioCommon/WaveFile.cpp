@@ -4,17 +4,23 @@
 
 #include "AudioCommon/WaveFile.h"
 
+#include <algorithm>
+#include <cstring>
 #include <string>
 
+#include "AudioCommon/FlacEncoder.h"
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
+#include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
 #include "Common/StringUtil.h"
 #include "Common/Swap.h"
+#include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 
-constexpr size_t WaveFileWriter::BUFFER_SIZE;
+constexpr size_t WaveFileWriter::WRITE_BUFFER_SIZE;
+constexpr size_t WaveFileWriter::WRITE_BUFFER_ALIGNMENT;
 
 WaveFileWriter::WaveFileWriter()
 {
@@ -23,9 +29,52 @@ WaveFileWriter::WaveFileWriter()
 WaveFileWriter::~WaveFileWriter()
 {
   Stop();
+  if (write_buffer)
+    Common::FreeAlignedMemory(write_buffer);
 }
 
 bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRate)
+{
+  if (writer_thread.joinable())
+  {
+    PanicAlertT("The file %s was already open, the file header will not be written.",
+                filename.c_str());
+    return false;
+  }
+
+  std::string name;
+  SplitPath(filename, nullptr, &name, &extension);
+  if (basename.empty())
+    basename = name;
+
+  if (!write_buffer)
+  {
+    write_buffer = static_cast<u8*>(
+        Common::AllocateAlignedMemory(WRITE_BUFFER_SIZE, WRITE_BUFFER_ALIGNMENT));
+  }
+
+  if (!OpenFile(filename, HLESampleRate))
+    return false;
+
+  writer_running.Set();
+  writer_thread = std::thread(&WaveFileWriter::WriterThread, this);
+  return true;
+}
+
+void WaveFileWriter::Stop()
+{
+  if (writer_thread.joinable())
+  {
+    // The writer thread writes the remaining chunks before it exits.
+    writer_running.Clear();
+    writer_wakeup.Set();
+    writer_thread.join();
+  }
+
+  CloseFile();
+}
+
+bool WaveFileWriter::OpenFile(const std::string& filename, unsigned int sample_rate)
 {
   // Ask to delete file
   if (File::Exists(filename))
@@ -60,11 +109,17 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
   }
 
   audio_size = 0;
+  write_buffer_used = 0;
+  current_sample_rate = sample_rate;
 
-  if (basename.empty())
-    SplitPath(filename, nullptr, &basename, nullptr);
-
-  current_sample_rate = HLESampleRate;
+  if (extension == ".flac")
+  {
+    // The header is rewritten with the final sizes when the file is closed.
+    flac_encoder = std::make_unique<AudioCommon::FlacEncoder>(sample_rate);
+    const auto header = flac_encoder->GetHeader();
+    file.WriteBytes(header.data(), header.size());
+    return true;
+  }
 
   // -----------------
   // Write file header
@@ -77,7 +132,6 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
   Write(16);          // size of fmt block
   Write(0x00020001);  // two channels, uncompressed
 
-  const u32 sample_rate = HLESampleRate;
   Write(sample_rate);
   Write(sample_rate * 2 * 2);  // two channels, 16bit
 
@@ -92,14 +146,34 @@ bool WaveFileWriter::Start(const std::string& filename, unsigned int HLESampleRa
   return true;
 }
 
-void WaveFileWriter::Stop()
+void WaveFileWriter::CloseFile()
 {
-  // u32 file_size = (u32)ftello(file);
-  file.Seek(4, SEEK_SET);
-  Write(audio_size + 36);
+  if (!file)
+    return;
+
+  if (flac_encoder)
+  {
+    encoded_buffer.clear();
+    flac_encoder->Finish(&encoded_buffer);
+    WriteBuffered(encoded_buffer.data(), encoded_buffer.size());
+    FlushWriteBuffer();
+
+    const auto header = flac_encoder->GetHeader();
+    file.Seek(0, SEEK_SET);
+    file.WriteBytes(header.data(), header.size());
+    flac_encoder.reset();
+  }
+  else
+  {
+    FlushWriteBuffer();
+
+    // u32 file_size = (u32)ftello(file);
+    file.Seek(4, SEEK_SET);
+    Write(audio_size + 36);
 
-  file.Seek(40, SEEK_SET);
-  Write(audio_size);
+    file.Seek(40, SEEK_SET);
+    Write(audio_size);
+  }
 
   file.Close();
 }
@@ -116,11 +190,11 @@ void WaveFileWriter::Write4(const char* ptr)
 
 void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int sample_rate)
 {
-  if (!file)
+  if (!writer_thread.joinable())
+  {
     PanicAlertT("WaveFileWriter - file not open.");
-
-  if (count > BUFFER_SIZE * 2)
-    PanicAlert("WaveFileWriter - buffer too small (count = %u).", count);
+    return;
+  }
 
   if (skip_silence)
   {
@@ -136,23 +210,95 @@ void WaveFileWriter::AddStereoSamplesBE(const short* sample_data, u32 count, int
       return;
   }
 
-  for (u32 i = 0; i < count; i++)
+  // Only copy the samples here, the conversion and the disk I/O are done on the writer thread.
+  Chunk chunk;
+  free_buffers.Pop(chunk.samples);
+  chunk.samples.assign(sample_data, sample_data + count * 2);
+  chunk.count = count;
+  chunk.sample_rate = sample_rate;
+  pending_chunks.Push(std::move(chunk));
+  writer_wakeup.Set();
+}
+
+void WaveFileWriter::WriterThread()
+{
+  Common::SetCurrentThreadName("Audio dump writer");
+
+  while (true)
   {
-    // Flip the audio channels from RL to LR
-    conv_buffer[2 * i] = Common::swap16((u16)sample_data[2 * i + 1]);
-    conv_buffer[2 * i + 1] = Common::swap16((u16)sample_data[2 * i]);
+    writer_wakeup.Wait();
+    // Checked before draining the queue, so that chunks added before Stop() are still written.
+    const bool running = writer_running.IsSet();
+
+    Chunk chunk;
+    while (pending_chunks.Pop(chunk))
+    {
+      WriteChunk(chunk);
+      free_buffers.Push(std::move(chunk.samples));
+    }
+
+    if (!running)
+      break;
   }
+}
 
-  if (sample_rate != current_sample_rate)
+void WaveFileWriter::WriteChunk(const Chunk& chunk)
+{
+  if (chunk.sample_rate != current_sample_rate)
   {
-    Stop();
+    CloseFile();
     file_index++;
     std::stringstream filename;
-    filename << File::GetUserPath(D_DUMPAUDIO_IDX) << basename << file_index << ".wav";
-    Start(filename.str(), sample_rate);
-    current_sample_rate = sample_rate;
+    filename << File::GetUserPath(D_DUMPAUDIO_IDX) << basename << file_index << extension;
+    OpenFile(filename.str(), chunk.sample_rate);
+    current_sample_rate = chunk.sample_rate;
+  }
+
+  if (!file)
+    return;
+
+  conv_buffer.resize(chunk.count * 2);
+  for (u32 i = 0; i < chunk.count; i++)
+  {
+    // Flip the audio channels from RL to LR
+    conv_buffer[2 * i] = Common::swap16((u16)chunk.samples[2 * i + 1]);
+    conv_buffer[2 * i + 1] = Common::swap16((u16)chunk.samples[2 * i]);
+  }
+
+  if (flac_encoder)
+  {
+    encoded_buffer.clear();
+    flac_encoder->AddFrames(conv_buffer.data(), chunk.count, &encoded_buffer);
+    WriteBuffered(encoded_buffer.data(), encoded_buffer.size());
+  }
+  else
+  {
+    WriteBuffered(conv_buffer.data(), chunk.count * 4);
   }
+  audio_size += chunk.count * 4;
+}
+
+void WaveFileWriter::WriteBuffered(const void* data, size_t size)
+{
+  const u8* bytes = static_cast<const u8*>(data);
+  while (size > 0)
+  {
+    const size_t copied = std::min(size, WRITE_BUFFER_SIZE - write_buffer_used);
+    std::memcpy(write_buffer + write_buffer_used, bytes, copied);
+    write_buffer_used += copied;
+    bytes += copied;
+    size -= copied;
+
+    if (write_buffer_used == WRITE_BUFFER_SIZE)
+      FlushWriteBuffer();
+  }
+}
+
+void WaveFileWriter::FlushWriteBuffer()
+{
+  if (write_buffer_used == 0)
+    return;
 
-  file.WriteBytes(conv_buffer.data(), count * 4);
-  audio_size += count * 4;
+  file.WriteBytes(write_buffer, write_buffer_used);
+  write_buffer_used = 0;
 }
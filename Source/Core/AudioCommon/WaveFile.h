@@ -6,19 +6,31 @@
 // Class: WaveFileWriter
 // Description: Simple utility class to make it easy to write long 16-bit stereo
 // audio streams to disk.
-// Use Start() to start recording to a file, and AddStereoSamples to add wave data.
-// The float variant will convert from -1.0-1.0 range and clamp.
-// Alternatively, AddSamplesBE for big endian wave data.
+// Use Start() to start recording to a file, and AddStereoSamplesBE to add big endian wave data.
+// If the file name ends in .flac, the audio is compressed with FLAC instead of written as WAV.
+// The samples are queued and written to disk by a separate thread, so that slow disks don't
+// block the emulated audio.
 // If Stop is not called when it destructs, the destructor will call Stop().
 // ---------------------------------------------------------------------------------
 
 #pragma once
 
-#include <array>
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/Event.h"
 #include "Common/File.h"
+#include "Common/Flag.h"
+#include "Common/SPSCQueue.h"
+
+namespace AudioCommon
+{
+class FlacEncoder;
+}
 
 class WaveFileWriter
 {
@@ -39,15 +51,46 @@ public:
   u32 GetAudioSize() const { return audio_size; }
 
 private:
-  static constexpr size_t BUFFER_SIZE = 32 * 1024;
+  struct Chunk
+  {
+    // Big endian samples in right/left order, as they are passed to AddStereoSamplesBE.
+    std::vector<short> samples;
+    u32 count;
+    int sample_rate;
+  };
+
+  static constexpr size_t WRITE_BUFFER_SIZE = 1024 * 1024;
+  static constexpr size_t WRITE_BUFFER_ALIGNMENT = 4096;
+
+  bool OpenFile(const std::string& filename, unsigned int sample_rate);
+  void CloseFile();
+
+  // Only called on the writer thread while it runs.
+  void WriterThread();
+  void WriteChunk(const Chunk& chunk);
+  void WriteBuffered(const void* data, size_t size);
+  void FlushWriteBuffer();
 
   File::IOFile file;
   bool skip_silence = false;
-  u32 audio_size = 0;
-  std::array<short, BUFFER_SIZE> conv_buffer{};
+  std::atomic<u32> audio_size{0};
   void Write(u32 value);
   void Write4(const char* ptr);
   std::string basename;
+  std::string extension;
   int current_sample_rate;
   int file_index = 0;
+
+  std::unique_ptr<AudioCommon::FlacEncoder> flac_encoder;
+  std::vector<s16> conv_buffer;
+  std::vector<u8> encoded_buffer;
+  u8* write_buffer = nullptr;
+  size_t write_buffer_used = 0;
+
+  std::thread writer_thread;
+  Common::Flag writer_running;
+  Common::Event writer_wakeup;
+  Common::SPSCQueue<Chunk, false> pending_chunks;
+  // Sample buffers of written chunks, which are reused to avoid allocations.
+  Common::SPSCQueue<std::vector<short>, false> free_buffers;
 };
@@ -227,6 +227,8 @@ public:
 
   bool IsRunning() const { return !m_stopped.IsSet() && !m_shutdown.IsSet(); }
   bool IsDone() const { return m_stopped.IsSet() || m_running_state.load() <= STATE_DONE; }
+  // True if the worker is blocked on the next Wakeup() call, so that call will have to wake it up.
+  bool IsSleeping() const { return m_running_state.load() == STATE_SLEEPING; }
   // This function should be triggered regularly over time so
   // that we will fall back from the busy loop to sleeping.
   void AllowSleep() { m_may_sleep.Set(); }
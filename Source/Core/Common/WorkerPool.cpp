@@ -0,0 +1,111 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "Common/WorkerPool.h"
+
+#include "Common/Thread.h"
+
+namespace Common
+{
+WorkerPool::~WorkerPool()
+{
+  Stop();
+}
+
+void WorkerPool::Start(u32 num_threads, const std::string& name)
+{
+  Stop();
+
+  m_exit = false;
+  for (u32 i = 0; i < num_threads; i++)
+    m_threads.emplace_back(&WorkerPool::ThreadLoop, this, name);
+}
+
+void WorkerPool::Stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_exit = true;
+  }
+  m_work_cv.notify_all();
+
+  for (std::thread& thread : m_threads)
+    thread.join();
+  m_threads.clear();
+}
+
+void WorkerPool::ParallelFor(u32 count, const std::function<void(u32)>& job)
+{
+  if (m_threads.empty() || count <= 1)
+  {
+    for (u32 i = 0; i < count; i++)
+      job(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit_lk(m_submit_lock);
+  {
+    std::lock_guard<std::mutex> lk(m_lock);
+    m_job = &job;
+    m_job_count = count;
+    m_next_job.store(0, std::memory_order_relaxed);
+    m_finished_jobs = 0;
+    m_batch_id++;
+  }
+  m_work_cv.notify_all();
+
+  RunJobs();
+
+  // Workers which picked up this batch must also have left it before the next batch can reuse
+  // the job counter, even if they did not get to run any job.
+  std::unique_lock<std::mutex> lk(m_lock);
+  m_done_cv.wait(lk, [&] { return m_finished_jobs == m_job_count && m_active_workers == 0; });
+  m_job = nullptr;
+}
+
+void WorkerPool::RunJobs()
+{
+  u32 finished = 0;
+  u32 index;
+  while ((index = m_next_job.fetch_add(1, std::memory_order_relaxed)) < m_job_count)
+  {
+    (*m_job)(index);
+    finished++;
+  }
+
+  if (finished == 0)
+    return;
+
+  std::lock_guard<std::mutex> lk(m_lock);
+  m_finished_jobs += finished;
+  if (m_finished_jobs == m_job_count)
+    m_done_cv.notify_all();
+}
+
+void WorkerPool::ThreadLoop(std::string name)
+{
+  Common::SetCurrentThreadName(name.c_str());
+
+  u64 last_batch_id = 0;
+  std::unique_lock<std::mutex> lk(m_lock);
+  while (true)
+  {
+    m_work_cv.wait(lk, [&] { return m_exit || (m_job && m_batch_id != last_batch_id); });
+    if (m_exit)
+      return;
+
+    last_batch_id = m_batch_id;
+    m_active_workers++;
+    lk.unlock();
+
+    RunJobs();
+
+    lk.lock();
+    m_active_workers--;
+    if (m_active_workers == 0)
+      m_done_cv.notify_all();
+  }
+}
+
+}  // namespace Common
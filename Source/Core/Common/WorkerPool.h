@@ -0,0 +1,63 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// A fixed set of threads for splitting one piece of work into independent jobs.
+// The submitting thread takes part in the work, and ParallelFor only returns once every job of
+// the batch has finished, so jobs may safely reference the caller's stack.
+
+namespace Common
+{
+class WorkerPool
+{
+public:
+  WorkerPool() = default;
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  // Restarts the pool with the given number of helper threads. Zero runs everything inline.
+  void Start(u32 num_threads, const std::string& name);
+  void Stop();
+
+  u32 GetThreadCount() const { return static_cast<u32>(m_threads.size()); }
+
+  // Calls job(i) for every i in [0, count), in no particular order. Batches from different
+  // submitting threads are serialized.
+  void ParallelFor(u32 count, const std::function<void(u32)>& job);
+
+private:
+  void ThreadLoop(std::string name);
+  void RunJobs();
+
+  std::vector<std::thread> m_threads;
+
+  std::mutex m_submit_lock;
+  std::mutex m_lock;
+  std::condition_variable m_work_cv;
+  std::condition_variable m_done_cv;
+
+  // State of the current batch, guarded by m_lock except for the atomic job counter.
+  const std::function<void(u32)>* m_job = nullptr;
+  u32 m_job_count = 0;
+  std::atomic<u32> m_next_job{0};
+  u32 m_finished_jobs = 0;
+  u32 m_active_workers = 0;
+  u64 m_batch_id = 0;
+  bool m_exit = false;
+};
+
+}  // namespace Common
@@ -28,6 +28,8 @@ extern const ConfigInfo<bool> MAIN_DPL2_DECODER;
 extern const ConfigInfo<int> MAIN_AUDIO_LATENCY;
 extern const ConfigInfo<bool> MAIN_AUDIO_STRETCH;
 extern const ConfigInfo<int> MAIN_AUDIO_STRETCH_LATENCY;
+extern const ConfigInfo<int> MAIN_AUDIO_RESAMPLER_QUALITY;
+extern const ConfigInfo<bool> MAIN_AUDIO_ADAPTIVE_LATENCY;
 extern const ConfigInfo<std::string> MAIN_MEMCARD_A_PATH;
 extern const ConfigInfo<std::string> MAIN_MEMCARD_B_PATH;
 extern const ConfigInfo<std::string> MAIN_AGP_CART_A_PATH;
@@ -72,8 +74,11 @@ extern const ConfigInfo<bool> MAIN_ENABLE_SIGNATURE_CHECKS;
 
 extern const ConfigInfo<bool> MAIN_DSP_CAPTURE_LOG;
 extern const ConfigInfo<bool> MAIN_DSP_JIT;
+// Number of helper threads which process AX HLE voices in parallel. 0 processes them serially.
+extern const ConfigInfo<int> MAIN_DSP_HLE_VOICE_THREADS;
 extern const ConfigInfo<bool> MAIN_DUMP_AUDIO;
 extern const ConfigInfo<bool> MAIN_DUMP_AUDIO_SILENT;
+extern const ConfigInfo<bool> MAIN_DUMP_AUDIO_FLAC;
 extern const ConfigInfo<bool> MAIN_DUMP_UCODE;
 extern const ConfigInfo<std::string> MAIN_AUDIO_BACKEND;
 extern const ConfigInfo<int> MAIN_AUDIO_VOLUME;
@@ -36,6 +36,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_SHOW_NETPLAY_PING.location,
       Config::GFX_SHOW_NETPLAY_MESSAGES.location,
       Config::GFX_LOG_RENDER_TIME_TO_FILE.location,
+      Config::GFX_LOG_FRAME_TRACE_TO_FILE.location,
       Config::GFX_OVERLAY_STATS.location,
       Config::GFX_OVERLAY_PROJ_STATS.location,
       Config::GFX_DUMP_TEXTURES.location,
@@ -51,6 +52,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_DUMP_PATH.location,
       Config::GFX_BITRATE_KBPS.location,
       Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS.location,
+      Config::GFX_FRAME_DUMPS_DROP_FRAMES.location,
       Config::GFX_ENABLE_GPU_TEXTURE_DECODING.location,
       Config::GFX_ENABLE_PIXEL_LIGHTING.location,
       Config::GFX_FAST_DEPTH_CALC.location,
@@ -70,6 +72,10 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_SHADER_COMPILATION_MODE.location,
       Config::GFX_SHADER_COMPILER_THREADS.location,
       Config::GFX_SHADER_PRECOMPILER_THREADS.location,
+      Config::GFX_TEXTURE_DECODING_THREADS.location,
+      Config::GFX_TEXTURE_HASH_FUNCTION.location,
+      Config::GFX_TEXTURE_WRITE_TRACKING.location,
+      Config::GFX_DISPLAY_LIST_CACHE.location,
 
       Config::GFX_SW_ZCOMPLOC.location,
       Config::GFX_SW_ZFREEZE.location,
@@ -78,6 +84,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_SW_DUMP_TEV_TEX_FETCHES.location,
       Config::GFX_SW_DRAW_START.location,
       Config::GFX_SW_DRAW_END.location,
+      Config::GFX_SW_OFFSCREEN_DUMP_FORMAT.location,
 
       // Graphics.Enhancements
 
@@ -105,6 +112,7 @@ bool IsSettingSaveable(const Config::ConfigLocation& config_location)
       Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM.location,
       Config::GFX_HACK_SKIP_XFB_COPY_TO_RAM.location,
       Config::GFX_HACK_DISABLE_COPY_TO_VRAM.location,
+      Config::GFX_HACK_DEFER_EFB_COPIES.location,
       Config::GFX_HACK_IMMEDIATE_XFB.location,
       Config::GFX_HACK_COPY_EFB_SCALED.location,
       Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES.location,
@@ -255,6 +255,8 @@ void SConfig::SaveCoreSettings(IniFile& ini)
   core->Set("AudioLatency", iLatency);
   core->Set("AudioStretch", m_audio_stretch);
   core->Set("AudioStretchMaxLatency", m_audio_stretch_max_latency);
+  core->Set("AudioResamplerQuality", m_audio_resampler_quality);
+  core->Set("AudioAdaptiveLatency", m_audio_adaptive_latency);
   core->Set("MemcardAPath", m_strMemoryCardA);
   core->Set("MemcardBPath", m_strMemoryCardB);
   core->Set("AgpCartAPath", m_strGbaCartA);
@@ -306,6 +308,7 @@ void SConfig::SaveDSPSettings(IniFile& ini)
   dsp->Set("EnableJIT", m_DSPEnableJIT);
   dsp->Set("DumpAudio", m_DumpAudio);
   dsp->Set("DumpAudioSilent", m_DumpAudioSilent);
+  dsp->Set("DumpAudioFlac", m_DumpAudioFlac);
   dsp->Set("DumpUCode", m_DumpUCode);
   dsp->Set("Backend", sBackend);
   dsp->Set("Volume", m_Volume);
@@ -543,6 +546,8 @@ void SConfig::LoadCoreSettings(IniFile& ini)
   core->Get("AudioLatency", &iLatency, 20);
   core->Get("AudioStretch", &m_audio_stretch, false);
   core->Get("AudioStretchMaxLatency", &m_audio_stretch_max_latency, 80);
+  core->Get("AudioResamplerQuality", &m_audio_resampler_quality, 0);
+  core->Get("AudioAdaptiveLatency", &m_audio_adaptive_latency, false);
   core->Get("MemcardAPath", &m_strMemoryCardA);
   core->Get("MemcardBPath", &m_strMemoryCardB);
   core->Get("AgpCartAPath", &m_strGbaCartA);
@@ -607,6 +612,7 @@ void SConfig::LoadDSPSettings(IniFile& ini)
   dsp->Get("EnableJIT", &m_DSPEnableJIT, true);
   dsp->Get("DumpAudio", &m_DumpAudio, false);
   dsp->Get("DumpAudioSilent", &m_DumpAudioSilent, false);
+  dsp->Get("DumpAudioFlac", &m_DumpAudioFlac, false);
   dsp->Get("DumpUCode", &m_DumpUCode, false);
   dsp->Get("Backend", &sBackend, AudioCommon::GetDefaultSoundBackend());
   dsp->Get("Volume", &m_Volume, 100);
@@ -807,6 +813,8 @@ void SConfig::LoadDefaults()
   iLatency = 20;
   m_audio_stretch = false;
   m_audio_stretch_max_latency = 80;
+  m_audio_resampler_quality = 0;
+  m_audio_adaptive_latency = false;
 
   iPosX = INT_MIN;
   iPosY = INT_MIN;
@@ -109,6 +109,8 @@ struct SConfig
   int iLatency = 20;
   bool m_audio_stretch = false;
   int m_audio_stretch_max_latency = 80;
+  int m_audio_resampler_quality = 0;
+  bool m_audio_adaptive_latency = false;
 
   bool bRunCompareServer = false;
   bool bRunCompareClient = false;
@@ -297,6 +299,7 @@ struct SConfig
   bool m_DSPCaptureLog;
   bool m_DumpAudio;
   bool m_DumpAudioSilent;
+  bool m_DumpAudioFlac;
   bool m_IsMuted;
   bool m_DumpUCode;
   int m_Volume;
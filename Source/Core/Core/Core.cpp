@@ -21,6 +21,7 @@
 #include "Common/CPUDetect.h"
 #include "Common/CommonPaths.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/FileUtil.h"
 #include "Common/Flag.h"
 #include "Common/Logging/LogManager.h"
@@ -33,6 +34,7 @@
 
 #include "Core/Analytics.h"
 #include "Core/BootManager.h"
+#include "Core/Config/GraphicsSettings.h"
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
@@ -50,6 +52,7 @@
 #include "Core/HW/GCKeyboard.h"
 #include "Core/HW/GCPad.h"
 #include "Core/HW/HW.h"
+#include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
 #include "Core/HW/Wiimote.h"
@@ -310,7 +313,15 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   DolphinAnalytics::Instance()->ReportGameStart();
 
   if (_CoreParameter.bFastmem)
+  {
     EMM::InstallExceptionHandler();  // Let's run under memory watch
+    // Write tracking protects pages of RAM, so it is only enabled for the settings which use it.
+    if (Config::Get(Config::GFX_TEXTURE_WRITE_TRACKING) ||
+        Config::Get(Config::GFX_DISPLAY_LIST_CACHE))
+    {
+      Memory::SetWriteTrackingEnabled(true);
+    }
+  }
 
 #ifdef USE_MEMORYWATCHER
   MemoryWatcher::Init();
@@ -349,7 +360,10 @@ static void CpuThread(const std::optional<std::string>& savestate_path, bool del
   s_is_started = false;
 
   if (_CoreParameter.bFastmem)
+  {
+    Memory::SetWriteTrackingEnabled(false);
     EMM::UninstallExceptionHandler();
+  }
 }
 
 static void FifoPlayerThread(const std::optional<std::string>& savestate_path,
@@ -4,6 +4,8 @@
 
 #include "Core/DSP/DSPAccelerator.h"
 
+#include <algorithm>
+
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
@@ -160,6 +162,79 @@ u16 Accelerator::Read(s16* coefs)
   return val;
 }
 
+void Accelerator::ReadSamples(s16* coefs, s16* samples, u32 count)
+{
+  u32 i = 0;
+  while (i < count)
+  {
+    // Nothing can resume reads until the YN2 register is written to.
+    if (m_reads_stopped)
+    {
+      std::fill(samples + i, samples + count, 0);
+      return;
+    }
+
+    if (m_sample_format == 0x00)
+      i += ReadADPCMFrames(coefs, samples + i, count - i);
+
+    // Samples around the loop and end addresses take the exact per-sample path.
+    if (i < count)
+      samples[i++] = static_cast<s16>(Read(coefs));
+  }
+}
+
+u32 Accelerator::ReadADPCMFrames(const s16* coefs, s16* samples, u32 count)
+{
+  u32 address = m_current_address;
+  u32 decoded = 0;
+  // Stay clear of the bit which SetCurrentAddress masks out.
+  while (decoded < count && (address & 0x3fffffff) < 0x3fffffe0)
+  {
+    // Up to the end of the frame. The last sample moves on to the header of the next frame.
+    u32 run = std::min(16 - (address & 15), count - decoded);
+    // A sample which moves to end - 1, end or end + 1 may loop or raise the end exception.
+    if (address <= m_end_address)
+      run = std::min(run, address + 2 < m_end_address ? m_end_address - 2 - address : 0);
+    if (run == 0)
+      break;
+
+    const s32 scale = 1 << (m_pred_scale & 0xF);
+    const int coef_idx = (m_pred_scale >> 4) & 0x7;
+    const s32 coef1 = coefs[coef_idx * 2 + 0];
+    const s32 coef2 = coefs[coef_idx * 2 + 1];
+    s32 yn1 = m_yn1;
+    s32 yn2 = m_yn2;
+
+    // Every byte holds two samples, high nibble first.
+    u8 byte = ReadMemory(address >> 1);
+    for (u32 i = 0; i < run; ++i, ++address)
+    {
+      if (i != 0 && (address & 1) == 0)
+        byte = ReadMemory(address >> 1);
+      int temp = (address & 1) ? (byte & 0xF) : (byte >> 4);
+      if (temp >= 8)
+        temp -= 16;
+
+      const s32 val32 = (scale * temp) + ((0x400 + coef1 * yn1 + coef2 * yn2) >> 11);
+      yn2 = yn1;
+      yn1 = MathUtil::Clamp<s32>(val32, -0x7FFF, 0x7FFF);
+      samples[decoded + i] = static_cast<s16>(yn1);
+    }
+    decoded += run;
+    m_yn1 = static_cast<s16>(yn1);
+    m_yn2 = static_cast<s16>(yn2);
+
+    if ((address & 15) == 0)
+    {
+      m_pred_scale = ReadMemory(address >> 1);
+      address += 2;
+    }
+  }
+
+  m_current_address = address;
+  return decoded;
+}
+
 void Accelerator::DoState(PointerWrap& p)
 {
   p.Do(m_start_address);
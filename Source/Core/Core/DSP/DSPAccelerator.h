@@ -16,6 +16,9 @@ public:
   virtual ~Accelerator() = default;
 
   u16 Read(s16* coefs);
+  // Reads count samples, exactly like calling Read() count times. ADPCM samples are decoded
+  // a frame at a time away from the loop and end addresses.
+  void ReadSamples(s16* coefs, s16* samples, u32 count);
   // Zelda ucode reads ARAM through 0xffd3.
   u16 ReadD3();
   void WriteD3(u16 value);
@@ -42,6 +45,10 @@ protected:
   virtual u8 ReadMemory(u32 address) = 0;
   virtual void WriteMemory(u32 address, u8 value) = 0;
 
+  // Decodes ADPCM samples up to the first one which may reach the loop or end address.
+  // Returns how many samples were decoded.
+  u32 ReadADPCMFrames(const s16* coefs, s16* samples, u32 count);
+
   // DSP accelerator registers.
   u32 m_start_address = 0;
   u32 m_end_address = 0;
@@ -39,20 +39,29 @@ u32 gdsp_mbox_peek(Mailbox mbx)
   return g_dsp.mbox[mbx].load();
 }
 
+// With the DSP on its own thread, the writer of a mailbox and the reader which clears its top bit
+// run concurrently, so every update is a single atomic read-modify-write instead of a load and a
+// store which could undo the other side's change.
 void gdsp_mbox_write_h(Mailbox mbx, u16 val)
 {
-  const u32 old_value = g_dsp.mbox[mbx].load(std::memory_order_acquire);
-  const u32 new_value = (old_value & 0xffff) | (val << 16);
-
-  g_dsp.mbox[mbx].store(new_value & ~0x80000000, std::memory_order_release);
+  u32 old_value = g_dsp.mbox[mbx].load(std::memory_order_relaxed);
+  u32 new_value;
+  do
+  {
+    new_value = ((old_value & 0xffff) | (u32{val} << 16)) & ~0x80000000;
+  } while (!g_dsp.mbox[mbx].compare_exchange_weak(old_value, new_value, std::memory_order_release,
+                                                  std::memory_order_relaxed));
 }
 
 void gdsp_mbox_write_l(Mailbox mbx, u16 val)
 {
-  const u32 old_value = g_dsp.mbox[mbx].load(std::memory_order_acquire);
-  const u32 new_value = (old_value & ~0xffff) | val;
-
-  g_dsp.mbox[mbx].store(new_value | 0x80000000, std::memory_order_release);
+  u32 old_value = g_dsp.mbox[mbx].load(std::memory_order_relaxed);
+  u32 new_value;
+  do
+  {
+    new_value = (old_value & ~0xffff) | val | 0x80000000;
+  } while (!g_dsp.mbox[mbx].compare_exchange_weak(old_value, new_value, std::memory_order_release,
+                                                  std::memory_order_relaxed));
 
 #if defined(_DEBUG) || defined(DEBUGFAST)
   if (mbx == MAILBOX_DSP)
@@ -76,8 +85,7 @@ u16 gdsp_mbox_read_h(Mailbox mbx)
 
 u16 gdsp_mbox_read_l(Mailbox mbx)
 {
-  const u32 value = g_dsp.mbox[mbx].load(std::memory_order_acquire);
-  g_dsp.mbox[mbx].store(value & ~0x80000000, std::memory_order_release);
+  const u32 value = g_dsp.mbox[mbx].fetch_and(~0x80000000, std::memory_order_acq_rel);
 
   if (g_init_hax && mbx == MAILBOX_DSP)
   {
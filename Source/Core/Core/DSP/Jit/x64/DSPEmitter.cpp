@@ -211,6 +211,7 @@ void DSPEmitter::Compile(u16 start_addr)
   m_gpr.LoadRegs();
 
   m_block_link_entry = GetCodePtr();
+  m_self_link_cycle_checks.clear();
 
   m_compile_pc = start_addr;
   bool fixup_pc = false;
@@ -256,6 +257,17 @@ void DSPEmitter::Compile(u16 start_addr)
       // end of each block and in this order
       DSPJitRegCache c(m_gpr);
       HandleLoop();
+
+      // When the loop is done, or the end address belongs to an outer loop, execution simply
+      // goes on with the rest of this block. Jumps back to the start of this block are linked.
+      FixupBranch rLoopDone;
+      if (!opcode->branch)
+      {
+        CMP(16, M_SDSP_pc(), Imm16(m_compile_pc));
+        rLoopDone = J_CC(CC_E, true);
+        WriteLoopLink();
+      }
+
       m_gpr.SaveRegs();
       if (!Host::OnThread() && Analyzer::GetCodeFlags(start_addr) & Analyzer::CODE_IDLE_SKIP)
       {
@@ -269,6 +281,8 @@ void DSPEmitter::Compile(u16 start_addr)
       m_gpr.LoadRegs(false);
       m_gpr.FlushRegs(c, false);
 
+      if (!opcode->branch)
+        SetJumpTarget(rLoopDone);
       SetJumpTarget(rLoopAddressExit);
       SetJumpTarget(rLoopCounterExit);
     }
@@ -319,6 +333,15 @@ void DSPEmitter::Compile(u16 start_addr)
     MOV(16, M_SDSP_pc(), Imm16(m_compile_pc));
   }
 
+  // The size of this block is known now, so the jumps back to its start can check for it.
+  for (u8* cycle_check : m_self_link_cycle_checks)
+  {
+    u32 cycles;
+    std::memcpy(&cycles, cycle_check, sizeof(cycles));
+    cycles += m_block_size[start_addr];
+    std::memcpy(cycle_check, &cycles, sizeof(cycles));
+  }
+
   m_blocks[start_addr] = (DSPCompiledCode)entryPoint;
 
   // Mark this block as a linkable destination if it does not contain
@@ -209,7 +209,10 @@ public:
 
 private:
   void WriteBranchExit();
-  void WriteBlockLink(u16 dest);
+  void WriteBlockLink(u16 dest, bool conditional);
+  void WriteBlockLinkJump(Block target, u16 target_size);
+  void WriteLoopLink();
+  bool CanLinkToSelf() const;
 
   void ReJitConditional(UDSPInstruction opc, void (DSPEmitter::*conditional_fn)(UDSPInstruction));
   void r_jcc(UDSPInstruction opc);
@@ -307,6 +310,10 @@ private:
   std::vector<Block> m_block_links;
   Block m_block_link_entry;
 
+  // Cycle checks of jumps back to the start of the block being compiled. The size of the block is
+  // only known once it has been compiled, so it is added to the immediates afterwards.
+  std::vector<u8*> m_self_link_cycle_checks;
+
   u16 m_cycles_left = 0;
 
   // The index of the last stored ext value (compile time).
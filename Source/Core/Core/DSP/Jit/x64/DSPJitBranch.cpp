@@ -6,6 +6,7 @@
 
 #include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPHost.h"
 #include "Core/DSP/DSPMemoryMap.h"
 #include "Core/DSP/DSPTables.h"
 #include "Core/DSP/Jit/x64/DSPEmitter.h"
@@ -96,26 +97,36 @@ void DSPEmitter::WriteBranchExit()
   m_gpr.FlushRegs(c, false);
 }
 
-void DSPEmitter::WriteBlockLink(u16 dest)
+bool DSPEmitter::CanLinkToSelf() const
 {
+  // Idle loops are left to the dispatcher, which skips the rest of the cycles.
+  return Host::OnThread() || !(Analyzer::GetCodeFlags(m_start_address) & Analyzer::CODE_IDLE_SKIP);
+}
+
+// Conditional branches are only linked to code which is already known, so that a branch which is
+// rarely taken does not make this block wait for its destination to be compiled.
+void DSPEmitter::WriteBlockLink(u16 dest, bool conditional)
+{
+  // Loops back to the start of this block jump straight to its code.
+  if (dest == m_start_address)
+  {
+    if (CanLinkToSelf())
+    {
+      m_gpr.FlushRegs();
+      WriteBlockLinkJump(m_block_link_entry, 0);
+    }
+    return;
+  }
+
   // Jump directly to the called block if it has already been compiled.
   if (!(dest >= m_start_address && dest <= m_compile_pc))
   {
     if (m_block_links[dest] != nullptr)
     {
       m_gpr.FlushRegs();
-      // Check if we have enough cycles to execute the next block
-      MOV(64, R(RAX), ImmPtr(&m_cycles_left));
-      MOV(16, R(ECX), MatR(RAX));
-      CMP(16, R(ECX), Imm16(m_block_size[m_start_address] + m_block_size[dest]));
-      FixupBranch notEnoughCycles = J_CC(CC_BE);
-
-      SUB(16, R(ECX), Imm16(m_block_size[m_start_address]));
-      MOV(16, MatR(RAX), R(ECX));
-      JMP(m_block_links[dest], true);
-      SetJumpTarget(notEnoughCycles);
+      WriteBlockLinkJump(m_block_links[dest], m_block_size[dest]);
     }
-    else
+    else if (!conditional)
     {
       // The destination has not been compiled yet.  Add it to the list
       // of blocks that this block is waiting on.
@@ -124,14 +135,56 @@ void DSPEmitter::WriteBlockLink(u16 dest)
   }
 }
 
+// Jumps to target if there are enough cycles left to execute the next block, and falls through
+// otherwise. Registers must have been flushed. The accumulators stay in their host registers.
+void DSPEmitter::WriteBlockLinkJump(Block target, u16 target_size)
+{
+  // Pending external interrupts are checked by the dispatcher.
+  FixupBranch external_interrupt;
+  if (Host::OnThread())
+  {
+    CMP(8, M_SDSP_external_interrupt_waiting(), Imm8(0));
+    external_interrupt = J_CC(CC_NE, true);
+  }
+
+  // Check if we have enough cycles to execute the next block
+  MOV(64, R(RAX), ImmPtr(&m_cycles_left));
+  MOVZX(32, 16, ECX, MatR(RAX));
+  // The immediate is always 32 bits wide here, so it can be patched by Compile.
+  MOV(32, R(EDX), Imm32(m_block_size[m_start_address] + target_size));
+  if (target == m_block_link_entry)
+    m_self_link_cycle_checks.push_back(GetWritableCodePtr() - sizeof(u32));
+  CMP(32, R(ECX), R(EDX));
+  FixupBranch not_enough_cycles = J_CC(CC_BE, true);
+
+  SUB(32, R(ECX), Imm32(m_block_size[m_start_address]));
+  MOV(16, MatR(RAX), R(ECX));
+  JMP(target, true);
+  SetJumpTarget(not_enough_cycles);
+  if (Host::OnThread())
+    SetJumpTarget(external_interrupt);
+}
+
+// Called at the end of a hardware loop, after HandleLoop. When the loop goes on at the start of
+// this block, which is the case from the second iteration on, the jump back is linked directly.
+void DSPEmitter::WriteLoopLink()
+{
+  if (!CanLinkToSelf())
+    return;
+
+  CMP(16, M_SDSP_pc(), Imm16(m_start_address));
+  FixupBranch other_block = J_CC(CC_NE, true);
+  DSPJitRegCache c(m_gpr);
+  m_gpr.FlushRegs();
+  WriteBlockLinkJump(m_block_link_entry, 0);
+  m_gpr.FlushRegs(c);
+  SetJumpTarget(other_block);
+}
+
 void DSPEmitter::r_jcc(const UDSPInstruction opc)
 {
   u16 dest = dsp_imem_read(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
-
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
-    WriteBlockLink(dest);
+  WriteBlockLink(dest, !GetOpTemplate(opc)->uncond_branch);
   MOV(16, M_SDSP_pc(), Imm16(dest));
   WriteBranchExit();
 }
@@ -173,11 +226,7 @@ void DSPEmitter::r_call(const UDSPInstruction opc)
   MOV(16, R(DX), Imm16(m_compile_pc + 2));
   dsp_reg_store_stack(StackRegister::Call);
   u16 dest = dsp_imem_read(m_compile_pc + 1);
-  const DSPOPCTemplate* opcode = GetOpTemplate(opc);
-
-  // If the block is unconditional, attempt to link block
-  if (opcode->uncond_branch)
-    WriteBlockLink(dest);
+  WriteBlockLink(dest, !GetOpTemplate(opc)->uncond_branch);
   MOV(16, M_SDSP_pc(), Imm16(dest));
   WriteBranchExit();
 }
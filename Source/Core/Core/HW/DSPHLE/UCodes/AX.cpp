@@ -6,11 +6,13 @@
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
 #include "Common/File.h"
 #include "Common/FileUtil.h"
 #include "Common/Logging/Log.h"
 #include "Common/MathUtil.h"
 #include "Common/Swap.h"
+#include "Core/Config/MainSettings.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
 #include "Core/HW/DSPHLE/MailHandler.h"
@@ -26,6 +28,10 @@ namespace HLE
 AXUCode::AXUCode(DSPHLE* dsphle, u32 crc) : UCodeInterface(dsphle, crc), m_cmdlist_size(0)
 {
   INFO_LOG(DSPHLE, "Instantiating AXUCode: crc=%08x", crc);
+
+  const int voice_threads = Config::Get(Config::MAIN_DSP_HLE_VOICE_THREADS);
+  if (voice_threads > 0)
+    m_voice_workers.Start(static_cast<u32>(voice_threads), "AX Voice Processing");
 }
 
 AXUCode::~AXUCode()
@@ -427,34 +433,27 @@ void AXUCode::ProcessPBList(u32 pb_addr)
   // 32KHz to 48KHz, but AX always process at 32KHz.
   const u32 spms = 32;
 
-  AXPB pb;
-
-  while (pb_addr)
-  {
-    AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround, m_samples_auxA_left,
-                          m_samples_auxA_right, m_samples_auxA_surround, m_samples_auxB_left,
-                          m_samples_auxB_right, m_samples_auxB_surround}};
-
-    ReadPB(pb_addr, pb, m_crc);
+  const AXBuffers buffers = {{m_samples_left, m_samples_right, m_samples_surround,
+                              m_samples_auxA_left, m_samples_auxA_right, m_samples_auxA_surround,
+                              m_samples_auxB_left, m_samples_auxB_right, m_samples_auxB_surround}};
 
-    u32 updates_addr = HILO_TO_32(pb.updates.data);
-    u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
+  ProcessVoices(pb_addr, buffers, m_crc, m_voice_workers, &m_voice_group_buffers,
+                [this](AXPB& pb, AXBuffers voice_buffers) {
+                  u32 updates_addr = HILO_TO_32(pb.updates.data);
+                  u16* updates = (u16*)HLEMemory_Get_Pointer(updates_addr);
 
-    for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
-    {
-      ApplyUpdatesForMs(curr_ms, (u16*)&pb, pb.updates.num_updates, updates);
-
-      ProcessVoice(pb, buffers, spms, ConvertMixerControl(pb.mixer_control),
-                   m_coeffs_available ? m_coeffs : nullptr);
+                  for (int curr_ms = 0; curr_ms < 5; ++curr_ms)
+                  {
+                    ApplyUpdatesForMs(curr_ms, (u16*)&pb, pb.updates.num_updates, updates);
 
-      // Forward the buffers
-      for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
-        buffers.ptrs[i] += spms;
-    }
+                    ProcessVoice(pb, voice_buffers, spms, ConvertMixerControl(pb.mixer_control),
+                                 m_coeffs_available ? m_coeffs : nullptr);
 
-    WritePB(pb_addr, pb, m_crc);
-    pb_addr = HILO_TO_32(pb.next_pb);
-  }
+                    // Forward the buffers
+                    for (size_t i = 0; i < ArraySize(voice_buffers.ptrs); ++i)
+                      voice_buffers.ptrs[i] += spms;
+                  }
+                });
 }
 
 void AXUCode::MixAUXSamples(int aux_id, u32 write_addr, u32 read_addr)
@@ -12,7 +12,10 @@
 
 #pragma once
 
+#include <vector>
+
 #include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
 #include "Core/HW/DSPHLE/UCodes/UCodes.h"
 
 namespace DSP
@@ -101,6 +104,11 @@ protected:
 
   void LoadResamplingCoefficients();
 
+  // Processes the voices of a PB list in parallel when helper threads are enabled. Each group
+  // of voices is mixed into its own set of buffers.
+  Common::WorkerPool m_voice_workers;
+  std::vector<int> m_voice_group_buffers;
+
   // Copy a command list from memory to our temp buffer
   void CopyCmdList(u32 addr, u16 size);
 
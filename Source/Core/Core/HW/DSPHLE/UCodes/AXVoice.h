@@ -12,11 +12,16 @@
 #error AXVoice.h included without specifying version
 #endif
 
-#include <functional>
+#include <algorithm>
 #include <memory>
+#include <vector>
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
+#include "Common/WorkerPool.h"
 #include "Core/DSP/DSPAccelerator.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/UCodes/AX.h"
@@ -35,6 +40,12 @@ namespace HLE
 #define MAX_SAMPLES_PER_FRAME 96
 #endif
 
+// Voices with a ratio up to this one have their input samples decoded in one batch.
+#define MAX_BATCHED_RESAMPLING_RATIO 8
+
+// Longer PB lists are most likely broken, and are never processed in parallel.
+#define MAX_PARALLEL_VOICES 1024
+
 // Put all of that in an anonymous namespace to avoid stupid compilers merging
 // functions from AX GC and AX Wii.
 namespace
@@ -82,6 +93,17 @@ union AXBuffers
 #endif
 };
 
+// Number of samples in one of the buffers above, for a whole frame.
+u32 GetMixBufferSize(size_t buffer_index)
+{
+#ifdef AX_GC
+  return 32 * 5;
+#else
+  // The Wii Remote buffers start at wm_main0.
+  return buffer_index < 12 ? 32 * 3 : 6 * 3;
+#endif
+}
+
 // Determines if this version of the UCode has a PBLowPassFilter in its AXPB layout.
 bool HasLpf(u32 crc)
 {
@@ -163,9 +185,9 @@ void DumpPB(const PB_TYPE& pb)
 }
 #endif
 
-// Simulated accelerator state.
-static PB_TYPE* acc_pb;
-static bool acc_end_reached;
+// Simulated accelerator state. Voices can be processed on several threads at once.
+static thread_local PB_TYPE* acc_pb;
+static thread_local bool acc_end_reached;
 
 class HLEAccelerator final : public Accelerator
 {
@@ -212,7 +234,8 @@ protected:
   void WriteMemory(u32 address, u8 value) override { WriteARAM(value, address); }
 };
 
-static std::unique_ptr<Accelerator> s_accelerator = std::make_unique<HLEAccelerator>();
+static thread_local std::unique_ptr<Accelerator> s_accelerator =
+    std::make_unique<HLEAccelerator>();
 
 // Sets up the simulated accelerator.
 void AcceleratorSetup(PB_TYPE* pb)
@@ -240,6 +263,27 @@ u16 AcceleratorGetSample()
   return s_accelerator->Read(acc_pb->adpcm.coefs);
 }
 
+// Reads <count> samples from the accelerator, like calling AcceleratorGetSample() <count> times.
+void AcceleratorGetSamples(s16* samples, u32 count)
+{
+  if (acc_end_reached)
+  {
+    std::fill(samples, samples + count, 0);
+    return;
+  }
+
+  // Once a non looping voice ends, the accelerator stops reads and returns zeros as well.
+  s_accelerator->ReadSamples(acc_pb->adpcm.coefs, samples, count);
+}
+
+// Returns how many input samples ResampleAudio reads to produce <count> samples.
+u32 GetResampleInputCount(u32 count, u32 curr_pos, u32 ratio, int srctype)
+{
+  if (srctype != SRCTYPE_LINEAR && srctype != SRCTYPE_POLYPHASE)
+    return count;
+  return static_cast<u32>((curr_pos + static_cast<u64>(ratio) * count) >> 16);
+}
+
 // Reads samples from the input callback, resamples them to <count> samples at
 // the wanted sample rate (computed from the ratio, see below).
 //
@@ -260,7 +304,10 @@ u16 AcceleratorGetSample()
 // We start getting samples not from sample 0, but 0.<curr_pos_frac>. This
 // avoids discontinuities in the audio stream, especially with very low ratios
 // which interpolate a lot of values between two "real" samples.
-u32 ResampleAudio(std::function<s16(u32)> input_callback, s16* output, u32 count, s16* last_samples,
+//
+// The input callback is a template parameter so that it can be inlined in the resampling loops.
+template <typename InputCallback>
+u32 ResampleAudio(InputCallback input_callback, s16* output, u32 count, s16* last_samples,
                   u32 curr_pos, u32 ratio, int srctype, const s16* coeffs)
 {
   int read_samples_count = 0;
@@ -383,9 +430,26 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
 
   if (coeffs)
     coeffs += pb.coef_select * 0x200;
-  u32 curr_pos =
-      ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count, pb.src.last_samples,
-                    pb.src.cur_addr_frac, HILO_TO_32(pb.src.ratio), pb.src_type, coeffs);
+
+  // Decode all the input samples of this frame in one go, then resample them. The accelerator
+  // is read in the same order either way. Voices which are played back much faster than
+  // the output rate read the accelerator from the resampling loop instead.
+  const u32 ratio = HILO_TO_32(pb.src.ratio);
+  const u32 input_count = GetResampleInputCount(count, pb.src.cur_addr_frac, ratio, pb.src_type);
+  u32 curr_pos;
+  if (input_count <= MAX_SAMPLES_PER_FRAME * MAX_BATCHED_RESAMPLING_RATIO)
+  {
+    s16 input[MAX_SAMPLES_PER_FRAME * MAX_BATCHED_RESAMPLING_RATIO];
+    AcceleratorGetSamples(input, input_count);
+
+    curr_pos = ResampleAudio([&input](u32 i) { return input[i]; }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
+  else
+  {
+    curr_pos = ResampleAudio([](u32) { return AcceleratorGetSample(); }, samples, count,
+                             pb.src.last_samples, pb.src.cur_addr_frac, ratio, pb.src_type, coeffs);
+  }
   pb.src.cur_addr_frac = (curr_pos & 0xFFFF);
 
   // Update current position, YN1, YN2 and pred scale in the PB.
@@ -396,30 +460,73 @@ void GetInputSamples(PB_TYPE& pb, s16* samples, u16 count, const s16* coeffs)
   pb.adpcm.pred_scale = s_accelerator->GetPredScale();
 }
 
+// Multiplies samples by a volume which changes by <volume_delta> after every sample, and clamps
+// the results. <input> and <output> may be the same buffer. Returns the volume after the last
+// sample.
+u16 ApplyVolume(const s16* input, s16* output, u32 count, u16 volume, u16 volume_delta)
+{
+  u32 i = 0;
+
+#if defined(_M_X86) || defined(_M_X86_64)
+  // The products of the signed samples and the unsigned volumes fit in 32 bits, so eight
+  // samples are multiplied at once by combining the low and high halves of the products.
+  __m128i volumes = _mm_setr_epi16(
+      volume, volume + volume_delta, volume + volume_delta * 2, volume + volume_delta * 3,
+      volume + volume_delta * 4, volume + volume_delta * 5, volume + volume_delta * 6,
+      volume + volume_delta * 7);
+  const __m128i volume_step = _mm_set1_epi16(static_cast<s16>(volume_delta * 8));
+  const __m128i min_sample = _mm_set1_epi16(-32767);
+  for (; i + 8 <= count; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&input[i]));
+    const __m128i low = _mm_mullo_epi16(samples, volumes);
+    // _mm_mulhi_epi16 takes volumes >= 0x8000 as negative, so add the missing 0x10000 * sample.
+    __m128i high = _mm_mulhi_epi16(samples, volumes);
+    high = _mm_add_epi16(high, _mm_and_si128(samples, _mm_srai_epi16(volumes, 15)));
+    const __m128i products0 = _mm_srai_epi32(_mm_unpacklo_epi16(low, high), 15);
+    const __m128i products1 = _mm_srai_epi32(_mm_unpackhi_epi16(low, high), 15);
+    const __m128i result = _mm_max_epi16(_mm_packs_epi32(products0, products1), min_sample);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[i]), result);
+    volumes = _mm_add_epi16(volumes, volume_step);
+  }
+  volume += static_cast<u16>(volume_delta * i);
+#endif
+
+  for (; i < count; ++i)
+  {
+    output[i] = MathUtil::Clamp((s32)input[i] * volume >> 15, -32767, 32767);  // -32768 ?
+    volume += volume_delta;
+  }
+  return volume;
+}
+
 // Add samples to an output buffer, with optional volume ramping.
 void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
 {
-  u16& volume = pvol[0];
-  u16 volume_delta = pvol[1];
+  if (count == 0)
+    return;
 
-  // If volume ramping is disabled, set volume_delta to 0. That way, the
-  // mixing loop can avoid testing if volume ramping is enabled at each step,
-  // and just add volume_delta.
-  if (!ramp)
-    volume_delta = 0;
+  // If volume ramping is disabled, the volume delta is ignored.
+  s16 samples[MAX_SAMPLES_PER_FRAME];
+  pvol[0] = ApplyVolume(input, samples, count, pvol[0], ramp ? pvol[1] : 0);
 
-  for (u32 i = 0; i < count; ++i)
+  u32 i = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  for (; i + 8 <= count; i += 8)
   {
-    s64 sample = input[i];
-    sample *= volume;
-    sample >>= 15;
-    sample = MathUtil::Clamp((s32)sample, -32767, 32767);  // -32768 ?
-
-    out[i] += (s16)sample;
-    volume += volume_delta;
-
-    *dpop = (s16)sample;
+    const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&samples[i]));
+    __m128i* dest = reinterpret_cast<__m128i*>(&out[i]);
+    // Sign extend the samples to 32 bits by moving them to the upper halves.
+    const __m128i values0 = _mm_srai_epi32(_mm_unpacklo_epi16(values, values), 16);
+    const __m128i values1 = _mm_srai_epi32(_mm_unpackhi_epi16(values, values), 16);
+    _mm_storeu_si128(dest, _mm_add_epi32(_mm_loadu_si128(dest), values0));
+    _mm_storeu_si128(dest + 1, _mm_add_epi32(_mm_loadu_si128(dest + 1), values1));
   }
+#endif
+  for (; i < count; ++i)
+    out[i] += samples[i];
+
+  *dpop = samples[count - 1];
 }
 
 // Execute a low pass filter on the samples using one history value. Returns
@@ -432,9 +539,9 @@ s16 LowPassFilter(s16* samples, u32 count, s16 yn1, u16 a0, u16 b0)
 }
 
 // Process 1ms of audio (for AX GC) or 3ms of audio (for AX Wii) from a PB and
-// mix it to the output buffers.
-void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl mctrl,
-                  const s16* coeffs)
+// mix it to the output buffers. Unused in files which only need the mixing helpers.
+[[maybe_unused]] void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count,
+                                   AXMixControl mctrl, const s16* coeffs)
 {
   // If the voice is not running, nothing to do.
   if (!pb.running)
@@ -445,12 +552,8 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
   GetInputSamples(pb, samples, count, coeffs);
 
   // Apply a global volume ramp using the volume envelope parameters.
-  for (u32 i = 0; i < count; ++i)
-  {
-    samples[i] = MathUtil::Clamp(((s32)samples[i] * pb.vol_env.cur_volume) >> 15, -32767,
-                                 32767);  // -32768 ?
-    pb.vol_env.cur_volume += pb.vol_env.cur_volume_delta;
-  }
+  pb.vol_env.cur_volume = ApplyVolume(samples, samples, count, pb.vol_env.cur_volume,
+                                      pb.vol_env.cur_volume_delta);
 
   // Optionally, execute a low pass filter
   // TODO: LPF code is currently broken, causing Super Monkey Ball sound
@@ -565,6 +668,93 @@ void ProcessVoice(PB_TYPE& pb, const AXBuffers& buffers, u16 count, AXMixControl
 #endif
 }
 
+// Processes the voices of a PB list on the worker pool. The list is split into contiguous
+// groups of voices, which are mixed into separate buffers that are added to the output buffers
+// at the end. The buffers only hold integer sums, so the result does not depend on the order of
+// the additions, and is the same as when processing the voices one by one.
+//
+// Returns false without writing anything if the list has to be processed serially.
+template <typename ProcessPB>
+bool ProcessVoicesInParallel(u32 pb_addr, const AXBuffers& buffers, u32 crc,
+                             Common::WorkerPool& workers, std::vector<int>* group_buffers,
+                             ProcessPB process_pb)
+{
+  std::vector<u32> addresses;
+  std::vector<PB_TYPE> pbs;
+  while (pb_addr)
+  {
+    if (pbs.size() == MAX_PARALLEL_VOICES)
+      return false;
+
+    pbs.emplace_back();
+    ReadPB(pb_addr, pbs.back(), crc);
+    addresses.push_back(pb_addr);
+    pb_addr = HILO_TO_32(pbs.back().next_pb);
+  }
+  if (pbs.empty())
+    return true;
+
+  const u32 num_pbs = static_cast<u32>(pbs.size());
+  const u32 num_groups = std::min(num_pbs, (workers.GetThreadCount() + 1) * 2);
+  const size_t num_buffers = ArraySize(buffers.ptrs);
+  const size_t buffer_stride = GetMixBufferSize(0);
+  group_buffers->assign(num_groups * num_buffers * buffer_stride, 0);
+
+  workers.ParallelFor(num_groups, [&](u32 group) {
+    AXBuffers group_ptrs;
+    for (size_t i = 0; i < num_buffers; ++i)
+      group_ptrs.ptrs[i] = &(*group_buffers)[(group * num_buffers + i) * buffer_stride];
+
+    for (u32 i = num_pbs * group / num_groups; i < num_pbs * (group + 1) / num_groups; ++i)
+      process_pb(pbs[i], group_ptrs);
+  });
+
+  // PB updates may have changed the address of the next PB, which the ucode only reads after
+  // processing a voice.
+  for (u32 i = 0; i < num_pbs; ++i)
+  {
+    const u32 next_pb = i + 1 < num_pbs ? addresses[i + 1] : 0;
+    if (static_cast<u32>(HILO_TO_32(pbs[i].next_pb)) != next_pb)
+      return false;
+  }
+
+  for (u32 i = 0; i < num_pbs; ++i)
+    WritePB(addresses[i], pbs[i], crc);
+
+  for (u32 group = 0; group < num_groups; ++group)
+  {
+    for (size_t i = 0; i < num_buffers; ++i)
+    {
+      const int* group_buffer = &(*group_buffers)[(group * num_buffers + i) * buffer_stride];
+      for (u32 j = 0; j < GetMixBufferSize(i); ++j)
+        buffers.ptrs[i][j] += group_buffer[j];
+    }
+  }
+  return true;
+}
+
+// Processes every voice of a PB list: process_pb is called with each PB and the buffers to mix
+// it into, and the PB is written back afterwards.
+template <typename ProcessPB>
+void ProcessVoices(u32 pb_addr, const AXBuffers& buffers, u32 crc, Common::WorkerPool& workers,
+                   std::vector<int>* group_buffers, ProcessPB process_pb)
+{
+  if (workers.GetThreadCount() != 0 &&
+      ProcessVoicesInParallel(pb_addr, buffers, crc, workers, group_buffers, process_pb))
+  {
+    return;
+  }
+
+  PB_TYPE pb;
+  while (pb_addr)
+  {
+    ReadPB(pb_addr, pb, crc);
+    process_pb(pb, buffers);
+    WritePB(pb_addr, pb, crc);
+    pb_addr = HILO_TO_32(pb.next_pb);
+  }
+}
+
 }  // namespace
 }  // namespace HLE
 }  // namespace DSP
@@ -6,10 +6,14 @@
 
 #include <array>
 #include <map>
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
 #include "Common/Swap.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/DSPHLE/DSPHLE.h"
@@ -668,6 +672,171 @@ void ZeldaUCode::RenderAudio()
   }
 }
 
+#if defined(_M_X86) || defined(_M_X86_64)
+// Multiplies eight signed samples by eight unsigned volumes. The 32-bit products of the lower
+// and upper four lanes are returned in low and high.
+static void MultiplyByVolumes(__m128i samples, __m128i volumes, __m128i* low, __m128i* high)
+{
+  const __m128i products_low = _mm_mullo_epi16(samples, volumes);
+  // _mm_mulhi_epi16 takes volumes >= 0x8000 as negative, so add the missing 0x10000 * sample.
+  __m128i products_high = _mm_mulhi_epi16(samples, volumes);
+  products_high =
+      _mm_add_epi16(products_high, _mm_and_si128(samples, _mm_srai_epi16(volumes, 15)));
+  *low = _mm_unpacklo_epi16(products_low, products_high);
+  *high = _mm_unpackhi_epi16(products_low, products_high);
+}
+#endif
+
+// Audio kernels of the renderer. They are vectorized when the host supports it, and produce
+// exactly the same samples as the scalar versions.
+
+// Multiplies samples by a volume with <shift> fractional bits, with saturation.
+static void ZeldaApplyVolume(s16* buf, size_t count, u16 vol, int shift)
+{
+  size_t vector_end = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  vector_end = count & ~size_t{7};
+  const __m128i volumes = _mm_set1_epi16(static_cast<s16>(vol));
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  for (size_t i = 0; i < vector_end; i += 8)
+  {
+    __m128i* samples = reinterpret_cast<__m128i*>(&buf[i]);
+    __m128i low, high;
+    MultiplyByVolumes(_mm_loadu_si128(samples), volumes, &low, &high);
+    low = _mm_sra_epi32(low, shift_count);
+    high = _mm_sra_epi32(high, shift_count);
+    _mm_storeu_si128(samples, _mm_packs_epi32(low, high));
+  }
+#endif
+  for (size_t i = vector_end; i < count; ++i)
+  {
+    s32 tmp = (u32)buf[i] * (u32)vol;
+    tmp >>= shift;
+
+    buf[i] = (s16)MathUtil::Clamp(tmp, -0x8000, 0x7FFF);
+  }
+}
+
+// Adds samples multiplied by a 1.15 volume to a buffer.
+static void ZeldaAddWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  size_t vector_end = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  vector_end = count & ~size_t{7};
+  const __m128i volumes = _mm_set1_epi16(static_cast<s16>(vol));
+  for (size_t i = 0; i < vector_end; i += 8)
+  {
+    __m128i* dst_samples = reinterpret_cast<__m128i*>(&dst[i]);
+    __m128i low, high;
+    MultiplyByVolumes(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])), volumes, &low,
+                      &high);
+    const __m128i scaled = _mm_packs_epi32(_mm_srai_epi32(low, 15), _mm_srai_epi32(high, 15));
+    _mm_storeu_si128(dst_samples, _mm_add_epi16(_mm_loadu_si128(dst_samples), scaled));
+  }
+#endif
+  for (size_t i = vector_end; i < count; ++i)
+  {
+    s32 vol_src = ((s32)src[i] * (s32)vol) >> 15;
+    dst[i] += MathUtil::Clamp(vol_src, -0x8000, 0x7FFF);
+  }
+}
+
+// Adds samples multiplied by a volume ramp to a buffer. The upper 16 bits of <vol> are the
+// volume of the first sample, and <step> is added after every sample. Returns the final volume.
+static s32 ZeldaAddWithVolumeRamp(s16* dst, const s16* src, size_t count, s32 vol, s32 step)
+{
+  size_t vector_end = 0;
+#if defined(_M_X86) || defined(_M_X86_64)
+  vector_end = count & ~size_t{7};
+  // The volumes of eight consecutive samples, in two vectors of 32-bit lanes.
+  const auto volume_at = [vol, step](u32 n) { return static_cast<s32>(vol + step * n); };
+  __m128i volumes_low = _mm_setr_epi32(volume_at(0), volume_at(1), volume_at(2), volume_at(3));
+  __m128i volumes_high = _mm_setr_epi32(volume_at(4), volume_at(5), volume_at(6), volume_at(7));
+  const __m128i volume_step = _mm_set1_epi32(static_cast<s32>(step * 8u));
+  for (size_t i = 0; i < vector_end; i += 8)
+  {
+    __m128i* dst_samples = reinterpret_cast<__m128i*>(&dst[i]);
+    const __m128i volumes = _mm_packs_epi32(_mm_srai_epi32(volumes_low, 16),
+                                            _mm_srai_epi32(volumes_high, 16));
+    const __m128i scaled =
+        _mm_mulhi_epi16(volumes, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])));
+    _mm_storeu_si128(dst_samples, _mm_add_epi16(_mm_loadu_si128(dst_samples), scaled));
+    volumes_low = _mm_add_epi32(volumes_low, volume_step);
+    volumes_high = _mm_add_epi32(volumes_high, volume_step);
+  }
+  vol = static_cast<s32>(vol + step * static_cast<u32>(vector_end));
+#endif
+  for (size_t i = vector_end; i < count; ++i)
+  {
+    dst[i] += ((vol >> 16) * src[i]) >> 16;
+    vol += step;
+  }
+  return vol;
+}
+
+// Decodes blocks of 16 AFC samples, which are either 9 bytes (4-bit samples) or 5 bytes (2-bit
+// samples) long. The history samples are updated.
+template <size_t BlockSize>
+static void ZeldaDecodeAFC(const u8* src, s16* dst, size_t block_count, const s16* coeffs,
+                           s16* yn1, s16* yn2)
+{
+  static_assert(BlockSize == 9 || BlockSize == 5, "AFC blocks are either 9 or 5 bytes long");
+  constexpr u32 bits_per_sample = BlockSize == 9 ? 4 : 2;
+  constexpr u32 samples_per_byte = 8 / bits_per_sample;
+  constexpr u32 sample_mask = (1 << bits_per_sample) - 1;
+
+  s32 hist1 = *yn1, hist2 = *yn2;
+  for (size_t b = 0; b < block_count; ++b, src += BlockSize)
+  {
+    const s16 delta = 1 << ((src[0] >> 4) & 0xF);
+    const s32 coeff1 = coeffs[(src[0] & 0xF) * 2];
+    const s32 coeff2 = coeffs[(src[0] & 0xF) * 2 + 1];
+
+    for (u32 i = 0; i < 16; ++i)
+    {
+      // Samples are stored from the most significant bits of each byte. Sign extend them, and
+      // move them to the top of a 15-bit value.
+      const u32 byte = src[1 + i / samples_per_byte];
+      const u32 shift = 8 - bits_per_sample * (i % samples_per_byte + 1);
+      s32 nibble = (byte >> shift) & sample_mask;
+      if (nibble >= (1 << (bits_per_sample - 1)))
+        nibble -= 1 << bits_per_sample;
+      nibble <<= 15 - bits_per_sample;
+
+      s32 sample = delta * nibble + hist1 * coeff1 + hist2 * coeff2;
+      sample >>= 11;
+      sample = MathUtil::Clamp(sample, -0x8000, 0x7fff);
+      *dst++ = (s16)sample;
+      hist2 = hist1;
+      hist1 = sample;
+    }
+  }
+
+  *yn2 = hist2;
+  *yn1 = hist1;
+}
+
+template <size_t N, size_t B>
+void ZeldaAudioRenderer::ApplyVolumeInPlace(std::array<s16, N>* buf, u16 vol)
+{
+  ZeldaApplyVolume(buf->data(), N, vol, 16 - B);
+}
+
+template <size_t N>
+s32 ZeldaAudioRenderer::AddBuffersWithVolumeRamp(std::array<s16, N>* dst,
+                                                 const std::array<s16, N>& src, s32 vol, s32 step)
+{
+  if (!vol && !step)
+    return vol;
+
+  return ZeldaAddWithVolumeRamp(dst->data(), src.data(), N, vol, step);
+}
+
+void ZeldaAudioRenderer::AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
+{
+  ZeldaAddWithVolume(dst, src, count, vol);
+}
+
 // Utility to define 32 bit accessors/modifiers methods based on two 16 bit
 // fields named _l and _h.
 #define DEFINE_32BIT_ACCESSOR(field_name, name)                                                    \
@@ -1715,64 +1884,13 @@ void ZeldaAudioRenderer::DownloadAFCSamplesFromARAM(s16* dst, VPB* vpb, u16 requ
 void ZeldaAudioRenderer::DecodeAFC(VPB* vpb, s16* dst, size_t block_count)
 {
   u32 addr = vpb->GetCurrentARAMAddr();
-  u8* src = (u8*)GetARAMPtr() + addr;
+  const u8* src = (const u8*)GetARAMPtr() + addr;
   vpb->SetCurrentARAMAddr(addr + (u32)block_count * vpb->samples_source_type);
 
-  for (size_t b = 0; b < block_count; ++b)
-  {
-    s16 nibbles[16];
-    s16 delta = 1 << ((*src >> 4) & 0xF);
-    s16 idx = (*src & 0xF);
-    src++;
-
-    if (vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM)
-    {
-      for (size_t i = 0; i < 16; i += 2)
-      {
-        nibbles[i + 0] = *src >> 4;
-        nibbles[i + 1] = *src & 0xF;
-        src++;
-      }
-      for (auto& nibble : nibbles)
-      {
-        if (nibble >= 8)
-          nibble -= 16;
-        nibble <<= 11;
-      }
-    }
-    else
-    {
-      for (size_t i = 0; i < 16; i += 4)
-      {
-        nibbles[i + 0] = (*src >> 6) & 3;
-        nibbles[i + 1] = (*src >> 4) & 3;
-        nibbles[i + 2] = (*src >> 2) & 3;
-        nibbles[i + 3] = (*src >> 0) & 3;
-        src++;
-      }
-      for (auto& nibble : nibbles)
-      {
-        if (nibble >= 2)
-          nibble -= 4;
-        nibble <<= 13;
-      }
-    }
-
-    s32 yn1 = *vpb->AFCYN1(), yn2 = *vpb->AFCYN2();
-    for (size_t i = 0; i < 16; ++i)
-    {
-      s32 sample =
-          delta * nibbles[i] + yn1 * m_afc_coeffs[idx * 2] + yn2 * m_afc_coeffs[idx * 2 + 1];
-      sample >>= 11;
-      sample = MathUtil::Clamp(sample, -0x8000, 0x7fff);
-      *dst++ = (s16)sample;
-      yn2 = yn1;
-      yn1 = sample;
-    }
-
-    *vpb->AFCYN2() = yn2;
-    *vpb->AFCYN1() = yn1;
-  }
+  if (vpb->samples_source_type == VPB::SRC_AFC_HQ_FROM_ARAM)
+    ZeldaDecodeAFC<9>(src, dst, block_count, m_afc_coeffs.data(), vpb->AFCYN1(), vpb->AFCYN2());
+  else
+    ZeldaDecodeAFC<5>(src, dst, block_count, m_afc_coeffs.data(), vpb->AFCYN1(), vpb->AFCYN2());
 }
 
 void ZeldaAudioRenderer::DownloadRawSamplesFromMRAM(s16* dst, VPB* vpb, u16 requested_samples_count)
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 
 #include "Common/CommonTypes.h"
 #include "Common/MathUtil.h"
@@ -47,16 +48,7 @@ private:
   // Apply volume to a buffer. The volume is a fixed point integer, usually
   // 1.15 or 4.12 in the DAC UCode.
   template <size_t N, size_t B>
-  void ApplyVolumeInPlace(std::array<s16, N>* buf, u16 vol)
-  {
-    for (size_t i = 0; i < N; ++i)
-    {
-      s32 tmp = (u32)(*buf)[i] * (u32)vol;
-      tmp >>= 16 - B;
-
-      (*buf)[i] = (s16)MathUtil::Clamp(tmp, -0x8000, 0x7FFF);
-    }
-  }
+  void ApplyVolumeInPlace(std::array<s16, N>* buf, u16 vol);
   template <size_t N>
   void ApplyVolumeInPlace_1_15(std::array<s16, N>* buf, u16 vol)
   {
@@ -75,30 +67,11 @@ private:
   // we can do better here with very low risk. Why not? :)
   template <size_t N>
   s32 AddBuffersWithVolumeRamp(std::array<s16, N>* dst, const std::array<s16, N>& src, s32 vol,
-                               s32 step)
-  {
-    if (!vol && !step)
-      return vol;
-
-    for (size_t i = 0; i < N; ++i)
-    {
-      (*dst)[i] += ((vol >> 16) * src[i]) >> 16;
-      vol += step;
-    }
-
-    return vol;
-  }
+                               s32 step);
 
   // Does not use std::array because it needs to be able to process partial
   // buffers. Volume is in 1.15 format.
-  void AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol)
-  {
-    while (count--)
-    {
-      s32 vol_src = ((s32)*src++ * (s32)vol) >> 15;
-      *dst++ += MathUtil::Clamp(vol_src, -0x8000, 0x7FFF);
-    }
-  }
+  void AddBuffersWithVolume(s16* dst, const s16* src, size_t count, u16 vol);
 
   // Whether the frame needs to be prepared or not.
   bool m_prepared = false;
@@ -4,6 +4,7 @@
 
 #include "Core/HW/DSPLLE/DSPLLE.h"
 
+#include <cinttypes>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -15,6 +16,7 @@
 #include "Common/Logging/Log.h"
 #include "Common/MemoryUtil.h"
 #include "Common/Thread.h"
+#include "Common/Timer.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/DSP/DSPAccelerator.h"
@@ -83,6 +85,8 @@ void DSPLLE::DoState(PointerWrap& p)
   p.DoArray(g_dsp.dram, DSP_DRAM_SIZE);
   p.Do(g_init_hax);
   p.Do(m_cycle_count);
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    m_pending_cycles.store(m_cycle_count.load());
 
   if (g_dsp_jit)
     g_dsp_jit->DoState(p);
@@ -95,24 +99,39 @@ void DSPLLE::DSPThread(DSPLLE* dsp_lle)
 
   while (dsp_lle->m_is_running.IsSet())
   {
-    const int cycles = static_cast<int>(dsp_lle->m_cycle_count.load());
-    if (cycles > 0)
+    const u64 start = Common::Timer::GetTimeUs();
+    u32 cycles;
     {
       std::lock_guard<std::mutex> dsp_thread_lock(dsp_lle->m_dsp_thread_mutex);
-      if (g_dsp_jit)
-      {
-        DSPCore_RunCycles(cycles);
-      }
-      else
+      // Cycles which the CPU thread grants while this slice runs are left for the next one.
+      cycles = dsp_lle->m_cycle_count.exchange(0);
+      if (cycles > 0)
       {
-        DSP::Interpreter::RunCyclesThread(cycles);
+        if (g_dsp_jit)
+        {
+          DSPCore_RunCycles(static_cast<int>(cycles));
+        }
+        else
+        {
+          DSP::Interpreter::RunCyclesThread(static_cast<int>(cycles));
+        }
+        dsp_lle->m_pending_cycles.fetch_sub(cycles);
       }
-      dsp_lle->m_cycle_count.store(0);
     }
-    else
+    const u64 end = Common::Timer::GetTimeUs();
+
+    if (cycles > 0)
     {
+      dsp_lle->m_stat_slices.fetch_add(1, std::memory_order_relaxed);
+      dsp_lle->m_stat_cycles.fetch_add(cycles, std::memory_order_relaxed);
+      dsp_lle->m_stat_run_us.fetch_add(end - start, std::memory_order_relaxed);
       s_ppc_event.Set();
+    }
+    else
+    {
       s_dsp_event.Wait();
+      dsp_lle->m_stat_dsp_wait_us.fetch_add(Common::Timer::GetTimeUs() - end,
+                                            std::memory_order_relaxed);
     }
   }
 }
@@ -194,6 +213,8 @@ bool DSPLLE::Initialize(bool wii, bool dsp_thread)
 
   if (dsp_thread)
   {
+    m_cycle_count.store(0);
+    m_pending_cycles.store(0);
     m_is_running.Set(true);
     m_dsp_thread = std::thread(DSPThread, this);
   }
@@ -210,9 +231,28 @@ void DSPLLE::DSP_StopSoundStream()
     s_ppc_event.Set();
     s_dsp_event.Set();
     m_dsp_thread.join();
+
+    const ThreadStats stats = GetThreadStats();
+    INFO_LOG(DSPLLE,
+             "DSP thread ran %" PRIu64 " cycles in %" PRIu64 " slices and %" PRIu64 " us, "
+             "waited %" PRIu64 " us for the CPU. The CPU waited %" PRIu64 " times, %" PRIu64 " us.",
+             stats.cycles, stats.slices, stats.run_us, stats.dsp_wait_us, stats.cpu_waits,
+             stats.cpu_wait_us);
   }
 }
 
+DSPLLE::ThreadStats DSPLLE::GetThreadStats() const
+{
+  ThreadStats stats;
+  stats.slices = m_stat_slices.load(std::memory_order_relaxed);
+  stats.cycles = m_stat_cycles.load(std::memory_order_relaxed);
+  stats.run_us = m_stat_run_us.load(std::memory_order_relaxed);
+  stats.dsp_wait_us = m_stat_dsp_wait_us.load(std::memory_order_relaxed);
+  stats.cpu_waits = m_stat_cpu_waits.load(std::memory_order_relaxed);
+  stats.cpu_wait_us = m_stat_cpu_wait_us.load(std::memory_order_relaxed);
+  return stats;
+}
+
 void DSPLLE::Shutdown()
 {
   DSPCore_Shutdown();
@@ -308,6 +348,10 @@ void DSPLLE::DSP_Update(int cycles)
       m_is_dsp_on_thread = false;
       s_request_disable_thread = false;
       SConfig::GetInstance().bDSPThread = false;
+
+      // Run the cycles which the DSP thread did not get to here.
+      dsp_cycles += static_cast<int>(m_cycle_count.exchange(0));
+      m_pending_cycles.store(0);
     }
   }
 
@@ -319,13 +363,28 @@ void DSPLLE::DSP_Update(int cycles)
   }
   else
   {
-    // Wait for DSP thread to complete its cycle. Note: this logic should be thought through.
-    s_ppc_event.Wait();
+    // The DSP thread may still be running the previous slice while the CPU thread goes on, so the
+    // CPU thread only waits when the DSP thread falls further behind than that.
+    WaitForDSPThread(static_cast<u32>(dsp_cycles));
+    m_pending_cycles.fetch_add(dsp_cycles);
     m_cycle_count.fetch_add(dsp_cycles);
     s_dsp_event.Set();
   }
 }
 
+void DSPLLE::WaitForDSPThread(u32 max_pending_cycles)
+{
+  if (m_pending_cycles.load() <= max_pending_cycles)
+    return;
+
+  const u64 start = Common::Timer::GetTimeUs();
+  while (m_pending_cycles.load() > max_pending_cycles && m_is_running.IsSet())
+    s_ppc_event.Wait();
+
+  m_stat_cpu_waits.fetch_add(1, std::memory_order_relaxed);
+  m_stat_cpu_wait_us.fetch_add(Common::Timer::GetTimeUs() - start, std::memory_order_relaxed);
+}
+
 u32 DSPLLE::DSP_UpdateRate()
 {
   return 12600;  // TO BE TWEAKED
@@ -40,14 +40,39 @@ public:
   void DSP_StopSoundStream() override;
   u32 DSP_UpdateRate() override;
 
+  // Counters of the time both sides of the DSP thread spend waiting for each other.
+  struct ThreadStats
+  {
+    u64 slices;
+    u64 cycles;
+    u64 run_us;
+    // Time the DSP thread had no cycles to run.
+    u64 dsp_wait_us;
+    // Times and time the CPU thread had to wait for the DSP thread to catch up.
+    u64 cpu_waits;
+    u64 cpu_wait_us;
+  };
+  ThreadStats GetThreadStats() const;
+
 private:
   static void DSPThread(DSPLLE* dsp_lle);
+  void WaitForDSPThread(u32 max_pending_cycles);
 
   std::thread m_dsp_thread;
   std::mutex m_dsp_thread_mutex;
   bool m_is_dsp_on_thread = false;
   Common::Flag m_is_running;
+  // Cycles which the CPU thread has granted the DSP thread but which it has not started yet.
   std::atomic<u32> m_cycle_count{};
+  // Cycles which the DSP thread has not finished yet, including the ones it is running.
+  std::atomic<u32> m_pending_cycles{};
+
+  std::atomic<u64> m_stat_slices{};
+  std::atomic<u64> m_stat_cycles{};
+  std::atomic<u64> m_stat_run_us{};
+  std::atomic<u64> m_stat_dsp_wait_us{};
+  std::atomic<u64> m_stat_cpu_waits{};
+  std::atomic<u64> m_stat_cpu_wait_us{};
 };
 }  // namespace LLE
 }  // namespace DSP
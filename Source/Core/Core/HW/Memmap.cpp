@@ -10,13 +10,17 @@
 #include "Core/HW/Memmap.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <memory>
+#include <optional>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
+#include "Common/MathUtil.h"
 #include "Common/MemArena.h"
+#include "Common/MemoryUtil.h"
 #include "Common/Swap.h"
 #include "Core/ConfigManager.h"
 #include "Core/HW/AudioInterface.h"
@@ -113,6 +117,7 @@ struct LogicalMemoryView
 {
   void* mapped_pointer;
   u32 mapped_size;
+  u32 shm_position;
 };
 
 // Dolphin allocates memory to represent four regions:
@@ -164,6 +169,37 @@ static PhysicalMemoryRegion physical_regions[] = {
 
 static std::vector<LogicalMemoryView> logical_mapped_entries;
 
+// Write tracking state. Pages are identified by their position in the shared memory segment, so
+// the physical view and any logical views of the same memory refer to the same page. The tracked
+// flags and the set of views are guarded by s_write_tracking_lock, which is a spin lock since it
+// is also taken from the fault handler.
+static std::atomic<bool> s_write_tracking_enabled{false};
+// Stays set until Shutdown, as a write may still fault on a page that was just unprotected.
+static std::atomic<bool> s_write_tracking_used{false};
+static std::atomic_flag s_write_tracking_lock = ATOMIC_FLAG_INIT;
+static u32 s_page_shift = 12;
+static u32 s_num_pages = 0;
+static std::unique_ptr<bool[]> s_page_tracked;
+static std::unique_ptr<std::atomic<u64>[]> s_page_write_stamps;
+static std::atomic<u64> s_write_stamp{0};
+static std::atomic<u64> s_write_tracking_reset_stamp{0};
+
+class WriteTrackingLock
+{
+public:
+  WriteTrackingLock()
+  {
+    while (s_write_tracking_lock.test_and_set(std::memory_order_acquire))
+    {
+    }
+  }
+  ~WriteTrackingLock() { s_write_tracking_lock.clear(std::memory_order_release); }
+  WriteTrackingLock(const WriteTrackingLock&) = delete;
+  WriteTrackingLock& operator=(const WriteTrackingLock&) = delete;
+};
+
+static void ResetWriteTrackingLocked();
+
 void Init()
 {
   bool wii = SConfig::GetInstance().bWii;
@@ -211,6 +247,11 @@ void Init()
   logical_base = physical_base + 0x200000000;
 #endif
 
+  s_page_shift = IntLog2(static_cast<u32>(Common::MemPageSize()));
+  s_num_pages = mem_size >> s_page_shift;
+  s_page_tracked = std::make_unique<bool[]>(s_num_pages);
+  s_page_write_stamps = std::make_unique<std::atomic<u64>[]>(s_num_pages);
+
   if (wii)
     mmio_mapping = InitMMIOWii();
   else
@@ -224,6 +265,10 @@ void Init()
 
 void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
 {
+  // The new views would not carry the protection of tracked pages, so start over.
+  WriteTrackingLock lock;
+  ResetWriteTrackingLocked();
+
   for (auto& entry : logical_mapped_entries)
   {
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
@@ -256,7 +301,7 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table)
             PanicAlert("MemoryMap_Setup: Failed finding a memory base.");
             exit(0);
           }
-          logical_mapped_entries.push_back({mapped_pointer, mapped_size});
+          logical_mapped_entries.push_back({mapped_pointer, mapped_size, position});
         }
       }
     }
@@ -280,6 +325,7 @@ void DoState(PointerWrap& p)
 void Shutdown()
 {
   m_IsInitialized = false;
+  SetWriteTrackingEnabled(false);
   u32 flags = 0;
   if (SConfig::GetInstance().bWii)
     flags |= PhysicalMemoryRegion::WII_ONLY;
@@ -297,6 +343,10 @@ void Shutdown()
     g_arena.ReleaseView(entry.mapped_pointer, entry.mapped_size);
   }
   logical_mapped_entries.clear();
+  s_page_tracked.reset();
+  s_page_write_stamps.reset();
+  s_num_pages = 0;
+  s_write_tracking_used.store(false, std::memory_order_release);
   g_arena.ReleaseSHMSegment();
   physical_base = nullptr;
   logical_base = nullptr;
@@ -316,6 +366,195 @@ void Clear()
     memset(m_pEXRAM, 0, EXRAM_SIZE);
 }
 
+// Calls func with the host pointer of the given page in every view which maps it.
+template <typename Func>
+static void ForEachPageView(u32 page, Func func)
+{
+  const u32 shm_position = page << s_page_shift;
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    if (*region.out_pointer && shm_position - region.shm_position < region.size)
+      func(*region.out_pointer + (shm_position - region.shm_position));
+  }
+  for (const LogicalMemoryView& entry : logical_mapped_entries)
+  {
+    if (shm_position - entry.shm_position < entry.mapped_size)
+      func(static_cast<u8*>(entry.mapped_pointer) + (shm_position - entry.shm_position));
+  }
+}
+
+// Converts a range of physical memory to the range of pages backing it, if it is RAM or EXRAM.
+static bool GetTrackedPageRange(u32 address, size_t size, u32* first_page, u32* last_page)
+{
+  if (size == 0 || !s_num_pages)
+    return false;
+
+  u32 shm_position;
+  u32 region_size;
+  address &= 0x3FFFFFFF;
+  if (address < REALRAM_SIZE)
+  {
+    // physical_regions[0] is RAM.
+    shm_position = physical_regions[0].shm_position + address;
+    region_size = REALRAM_SIZE - address;
+  }
+  else if (m_pEXRAM && (address >> 28) == 0x1 && (address & 0x0fffffff) < EXRAM_SIZE)
+  {
+    // physical_regions[3] is EXRAM.
+    shm_position = physical_regions[3].shm_position + (address & EXRAM_MASK);
+    region_size = EXRAM_SIZE - (address & EXRAM_MASK);
+  }
+  else
+  {
+    return false;
+  }
+
+  const u32 clamped_size = static_cast<u32>(std::min<size_t>(size, region_size));
+  *first_page = shm_position >> s_page_shift;
+  *last_page = (shm_position + clamped_size - 1) >> s_page_shift;
+  return true;
+}
+
+static void UntrackPageLocked(u32 page)
+{
+  s_page_tracked[page] = false;
+  ForEachPageView(page, [](u8* pointer) {
+    Common::UnWriteProtectMemory(pointer, static_cast<size_t>(1) << s_page_shift);
+  });
+}
+
+static void ResetWriteTrackingLocked()
+{
+  s_write_tracking_reset_stamp.store(++s_write_stamp, std::memory_order_release);
+  for (u32 page = 0; page < s_num_pages; page++)
+  {
+    if (s_page_tracked[page])
+      UntrackPageLocked(page);
+  }
+}
+
+void SetWriteTrackingEnabled(bool enabled)
+{
+#ifdef __APPLE__
+  // The Mach exception handler only covers the CPU thread, but other threads write to RAM too.
+  enabled = false;
+#endif
+
+  WriteTrackingLock lock;
+  if (enabled)
+    s_write_tracking_used.store(true, std::memory_order_release);
+  else
+    ResetWriteTrackingLocked();
+  s_write_tracking_enabled.store(enabled, std::memory_order_release);
+}
+
+bool IsWriteTrackingEnabled()
+{
+  return s_write_tracking_enabled.load(std::memory_order_acquire);
+}
+
+u64 TrackWrites(u32 address, u32 size)
+{
+  WriteTrackingLock lock;
+
+  // Anything written from here on either happens before the caller reads the memory, or faults
+  // and gets a newer stamp.
+  const u64 stamp = s_write_stamp.load(std::memory_order_acquire);
+  u32 first_page, last_page;
+  if (!s_write_tracking_enabled.load(std::memory_order_relaxed) ||
+      !GetTrackedPageRange(address, size, &first_page, &last_page))
+  {
+    return stamp;
+  }
+
+  for (u32 page = first_page; page <= last_page; page++)
+  {
+    if (s_page_tracked[page])
+      continue;
+
+    s_page_tracked[page] = true;
+    ForEachPageView(page, [](u8* pointer) {
+      Common::WriteProtectMemory(pointer, static_cast<size_t>(1) << s_page_shift);
+    });
+  }
+  return stamp;
+}
+
+bool WasWrittenSince(u32 address, u32 size, u64 stamp)
+{
+  u32 first_page, last_page;
+  if (!s_write_tracking_enabled.load(std::memory_order_acquire) ||
+      stamp < s_write_tracking_reset_stamp.load(std::memory_order_acquire) ||
+      !GetTrackedPageRange(address, size, &first_page, &last_page))
+  {
+    return true;
+  }
+
+  for (u32 page = first_page; page <= last_page; page++)
+  {
+    if (s_page_write_stamps[page].load(std::memory_order_acquire) > stamp)
+      return true;
+  }
+  return false;
+}
+
+void PrepareForHostWrite(u32 address, size_t size)
+{
+  if (!s_write_tracking_enabled.load(std::memory_order_acquire))
+    return;
+
+  WriteTrackingLock lock;
+  u32 first_page, last_page;
+  if (!GetTrackedPageRange(address, size, &first_page, &last_page))
+    return;
+
+  for (u32 page = first_page; page <= last_page; page++)
+  {
+    if (!s_page_tracked[page])
+      continue;
+
+    UntrackPageLocked(page);
+    s_page_write_stamps[page].store(++s_write_stamp, std::memory_order_release);
+  }
+}
+
+bool HandleWriteTrackingFault(uintptr_t fault_address)
+{
+  // Unless tracking was enabled at some point, no page can be protected, and the other fault
+  // handlers can go ahead without waiting for the lock.
+  if (!s_write_tracking_used.load(std::memory_order_acquire) || !s_num_pages)
+    return false;
+
+  WriteTrackingLock lock;
+  std::optional<u32> shm_position;
+  for (const PhysicalMemoryRegion& region : physical_regions)
+  {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(*region.out_pointer);
+    if (base && fault_address - base < region.size)
+      shm_position = region.shm_position + static_cast<u32>(fault_address - base);
+  }
+  for (const LogicalMemoryView& entry : logical_mapped_entries)
+  {
+    const uintptr_t base = reinterpret_cast<uintptr_t>(entry.mapped_pointer);
+    if (fault_address - base < entry.mapped_size)
+      shm_position = entry.shm_position + static_cast<u32>(fault_address - base);
+  }
+
+  // Views of emulated memory are always writable otherwise, so any fault inside of them is ours.
+  // If the page is no longer tracked, another thread got to it first and the write can be retried.
+  if (!shm_position)
+    return false;
+
+  const u32 page = *shm_position >> s_page_shift;
+  if (s_page_tracked[page])
+  {
+    UntrackPageLocked(page);
+    // The faulting write only happens once we return, so it is ordered after the new stamp.
+    s_page_write_stamps[page].store(++s_write_stamp, std::memory_order_release);
+  }
+  return true;
+}
+
 static inline u8* GetPointerForRange(u32 address, size_t size)
 {
   // Make sure we don't have a range spanning 2 separate banks
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -68,6 +69,26 @@ void UpdateLogicalMemory(const PowerPC::BatTable& dbat_table);
 
 void Clear();
 
+// Write tracking, for callers that want to know whether a range of RAM has changed without
+// rehashing it. Tracked pages are write-protected in every host view of emulated memory; the
+// first write to such a page faults, unprotects it again and records the write. This relies on the
+// fastmem fault handler being installed, see SetWriteTrackingEnabled. The fault handler covers
+// writes from every thread, but not writes by the OS, which fail on protected pages instead. Host
+// code handing emulated memory to a system call (file reads, socket receives) has to call
+// PrepareForHostWrite first; everything else copies through host buffers and needs nothing.
+// Tracking is only enabled when a graphics setting which uses it is on.
+void SetWriteTrackingEnabled(bool enabled);
+bool IsWriteTrackingEnabled();
+// Starts tracking writes to a range of physical memory, and returns a stamp for WasWrittenSince.
+u64 TrackWrites(u32 address, u32 size);
+// Conservative: returns true whenever the range might have been written after the stamp was taken.
+bool WasWrittenSince(u32 address, u32 size, u64 stamp);
+// Must be called before memory is written by something that can not take a page fault, such as a
+// system call reading straight into emulated memory.
+void PrepareForHostWrite(u32 address, size_t size);
+// Called from the fault handler. Returns true if the fault was caused by write tracking.
+bool HandleWriteTrackingFault(uintptr_t fault_address);
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
@@ -123,6 +123,7 @@ IPCCommandResult ES::ReadContent(u32 uid, const IOCtlVRequest& request)
   const u32 size = request.io_vectors[0].size;
   const u32 addr = request.io_vectors[0].address;
 
+  Memory::PrepareForHostWrite(addr, size);
   return GetDefaultReply(ReadContent(cfd, Memory::GetPointer(addr), size, uid));
 }
 
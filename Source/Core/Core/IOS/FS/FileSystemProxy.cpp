@@ -236,6 +236,8 @@ IPCCommandResult FS::Read(const ReadWriteRequest& request)
   // Simulate the FS read logic to estimate ticks. Note: this must be done before reading.
   const u64 ticks = EstimateTicksForReadWrite(handle, request);
 
+  // The host file is read straight into emulated memory.
+  Memory::PrepareForHostWrite(request.buffer, request.size);
   const Result<u32> result = m_ios.GetFS()->ReadBytesFromFile(
       handle.fs_fd, Memory::GetPointer(request.buffer), request.size);
   LogResult(
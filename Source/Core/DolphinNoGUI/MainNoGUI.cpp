@@ -5,6 +5,7 @@
 #include <OptionParser.h>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <signal.h>
 #include <string>
@@ -53,6 +54,28 @@ namespace ProcessorInterface
 void PowerButton_Tap();
 }
 
+// A shutdown request first asks the game to shut down through the power button if it listens to
+// it, and stops the emulation gracefully otherwise. The signal handlers are reset by the first
+// signal, so a second signal forces Dolphin to stop.
+static void HandleShutdownRequest()
+{
+  if (!s_shutdown_requested.TestAndClear())
+    return;
+
+  const auto ios = IOS::HLE::GetIOS();
+  const auto stm = ios ? ios->GetDeviceByName("/dev/stm/eventhook") : nullptr;
+  if (!s_tried_graceful_shutdown.IsSet() && stm &&
+      std::static_pointer_cast<IOS::HLE::Device::STMEventHook>(stm)->HasHookInstalled())
+  {
+    ProcessorInterface::PowerButton_Tap();
+    s_tried_graceful_shutdown.Set();
+  }
+  else
+  {
+    s_running.Clear();
+  }
+}
+
 class Platform
 {
 public:
@@ -62,6 +85,7 @@ public:
   {
     while (s_running.IsSet())
     {
+      HandleShutdownRequest();
       Core::HostDispatchJobs();
       std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
@@ -228,21 +252,7 @@ class PlatformX11 : public Platform
     // The actual loop
     while (s_running.IsSet())
     {
-      if (s_shutdown_requested.TestAndClear())
-      {
-        const auto ios = IOS::HLE::GetIOS();
-        const auto stm = ios ? ios->GetDeviceByName("/dev/stm/eventhook") : nullptr;
-        if (!s_tried_graceful_shutdown.IsSet() && stm &&
-            std::static_pointer_cast<IOS::HLE::Device::STMEventHook>(stm)->HasHookInstalled())
-        {
-          ProcessorInterface::PowerButton_Tap();
-          s_tried_graceful_shutdown.Set();
-        }
-        else
-        {
-          s_running.Clear();
-        }
-      }
+      HandleShutdownRequest();
 
       XEvent event;
       KeySym key;
@@ -363,6 +373,10 @@ static Platform* GetPlatform()
 #if defined(USE_HEADLESS)
   return new Platform();
 #elif HAVE_X11
+  // Fall back to running without a render window when there is no display to connect to,
+  // e.g. inside a container. Video backends that support it render offscreen in that case.
+  if (!getenv("DISPLAY"))
+    return new Platform();
   return new PlatformX11();
 #endif
   return nullptr;
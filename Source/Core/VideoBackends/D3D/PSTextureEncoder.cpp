@@ -69,6 +69,23 @@ void PSTextureEncoder::Shutdown()
 void PSTextureEncoder::Encode(u8* dst, const EFBCopyParams& params, u32 native_width,
                               u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
                               const EFBRectangle& src_rect, bool scale_by_half)
+{
+  EncodeToStagingTexture(m_encoding_readback_texture.get(), params, native_width, bytes_per_row,
+                         num_blocks_y, src_rect, scale_by_half);
+
+  MathUtil::Rectangle<int> copy_rect(0, 0, bytes_per_row / sizeof(u32), num_blocks_y);
+  m_encoding_readback_texture->Flush();
+  if (m_encoding_readback_texture->Map())
+  {
+    m_encoding_readback_texture->ReadTexels(copy_rect, dst, memory_stride);
+    m_encoding_readback_texture->Unmap();
+  }
+}
+
+void PSTextureEncoder::EncodeToStagingTexture(AbstractStagingTexture* readback_texture,
+                                              const EFBCopyParams& params, u32 native_width,
+                                              u32 bytes_per_row, u32 num_blocks_y,
+                                              const EFBRectangle& src_rect, bool scale_by_half)
 {
   // Resolve MSAA targets before copying.
   // FIXME: Instead of resolving EFB, it would be better to pick out a
@@ -121,14 +138,7 @@ void PSTextureEncoder::Encode(u8* dst, const EFBCopyParams& params, u32 native_w
 
     // Copy to staging buffer
     MathUtil::Rectangle<int> copy_rect(0, 0, words_per_row, num_blocks_y);
-    m_encoding_readback_texture->CopyFromTexture(m_encoding_render_texture.get(), copy_rect, 0, 0,
-                                                 copy_rect);
-    m_encoding_readback_texture->Flush();
-    if (m_encoding_readback_texture->Map())
-    {
-      m_encoding_readback_texture->ReadTexels(copy_rect, dst, memory_stride);
-      m_encoding_readback_texture->Unmap();
-    }
+    readback_texture->CopyFromTexture(m_encoding_render_texture.get(), copy_rect, 0, 0, copy_rect);
   }
 
   g_renderer->RestoreAPIState();
@@ -40,6 +40,11 @@ public:
   void Encode(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
               u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect,
               bool scale_by_half);
+  // Like Encode, but only copies the result to readback_texture, which must be a BGRA8 texture
+  // of at least bytes_per_row / 4 by num_blocks_y texels, without waiting for the GPU.
+  void EncodeToStagingTexture(AbstractStagingTexture* readback_texture,
+                              const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
+                              u32 num_blocks_y, const EFBRectangle& src_rect, bool scale_by_half);
 
 private:
   ID3D11PixelShader* GetEncodingPixelShader(const EFBCopyParams& params);
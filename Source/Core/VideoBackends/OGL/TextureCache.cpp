@@ -74,6 +74,22 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_widt
                                            memory_stride, src_rect, scale_by_half);
 }
 
+std::unique_ptr<AbstractStagingTexture>
+TextureCache::CopyEFBToStagingTexture(const EFBCopyParams& params, u32 native_width,
+                                      u32 bytes_per_row, u32 num_blocks_y,
+                                      const EFBRectangle& src_rect, bool scale_by_half)
+{
+  std::unique_ptr<AbstractStagingTexture> staging_texture =
+      AllocateEFBCopyStagingTexture(TextureConfig(bytes_per_row / 4, num_blocks_y, 1, 1, 1,
+                                                  AbstractTextureFormat::BGRA8, false));
+  if (!staging_texture)
+    return nullptr;
+
+  TextureConverter::EncodeToStagingTexture(staging_texture.get(), params, native_width,
+                                           bytes_per_row, num_blocks_y, src_rect, scale_by_half);
+  return staging_texture;
+}
+
 TextureCache::TextureCache()
 {
   CompileShaders();
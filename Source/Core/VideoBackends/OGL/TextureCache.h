@@ -66,6 +66,10 @@ private:
   void CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
                u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect,
                bool scale_by_half) override;
+  std::unique_ptr<AbstractStagingTexture>
+  CopyEFBToStagingTexture(const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
+                          u32 num_blocks_y, const EFBRectangle& src_rect,
+                          bool scale_by_half) override;
 
   void CopyEFBToCacheEntry(TCacheEntry* entry, bool is_depth_copy, const EFBRectangle& src_rect,
                            bool scale_by_half, EFBCopyFormat dst_format,
@@ -9,6 +9,7 @@
 
 #include "VideoCommon/VideoCommon.h"
 
+class AbstractStagingTexture;
 struct EFBCopyParams;
 
 namespace OGL
@@ -24,6 +25,12 @@ void Shutdown();
 void EncodeToRamFromTexture(u8* dest_ptr, const EFBCopyParams& params, u32 native_width,
                             u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
                             const EFBRectangle& src_rect, bool scale_by_half);
+
+// Encodes into readback_texture, which must be a BGRA8 texture with at least bytes_per_row / 4
+// by num_blocks_y texels, without waiting for the readback to complete.
+void EncodeToStagingTexture(AbstractStagingTexture* readback_texture, const EFBCopyParams& params,
+                            u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
+                            const EFBRectangle& src_rect, bool scale_by_half);
 }
 
 }  // namespace OGL
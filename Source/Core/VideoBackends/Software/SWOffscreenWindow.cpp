@@ -0,0 +1,181 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoBackends/Software/SWOffscreenWindow.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <string>
+
+#include "Common/CommonPaths.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+
+#include "VideoBackends/Software/SWTexture.h"
+
+#include "VideoCommon/ImageWrite.h"
+
+// How often the measured frame rate is written to the log.
+constexpr std::chrono::seconds FPS_REPORT_INTERVAL{5};
+
+std::unique_ptr<SWOffscreenWindow> SWOffscreenWindow::s_instance;
+
+SWOffscreenWindow::SWOffscreenWindow()
+{
+  m_start_time = Clock::now();
+  m_fps_time = m_start_time;
+}
+
+SWOffscreenWindow::~SWOffscreenWindow()
+{
+  if (m_encoder_thread.joinable())
+  {
+    m_encoder_running.Clear();
+    m_encode_event.Set();
+    m_encoder_thread.join();
+  }
+
+  const double elapsed = std::chrono::duration<double>(Clock::now() - m_start_time).count();
+  NOTICE_LOG(VIDEO,
+             "Offscreen output: %" PRIu64 " frames in %.2f s (%.2f FPS), %" PRIu64
+             " dumped, %" PRIu64 " dropped",
+             m_frame_count, elapsed, elapsed > 0.0 ? m_frame_count / elapsed : 0.0,
+             m_dumped_frames.load(), m_dropped_frames.load());
+}
+
+void SWOffscreenWindow::Init()
+{
+  s_instance.reset(new SWOffscreenWindow());
+}
+
+void SWOffscreenWindow::Shutdown()
+{
+  s_instance.reset();
+}
+
+void SWOffscreenWindow::ShowImage(AbstractTexture* image, const EFBRectangle& xfb_region)
+{
+  const SW::SWTexture* sw_image = static_cast<const SW::SWTexture*>(image);
+  const u32 image_width = sw_image->GetConfig().width;
+  const u32 image_height = sw_image->GetConfig().height;
+
+  const int max_x = static_cast<int>(image_width);
+  const int max_y = static_cast<int>(image_height);
+  const int left = std::clamp(xfb_region.left, 0, max_x);
+  const int top = std::clamp(xfb_region.top, 0, max_y);
+  const int right = std::clamp(xfb_region.right, left, max_x);
+  const int bottom = std::clamp(xfb_region.bottom, top, max_y);
+
+  const u32 slot = static_cast<u32>(m_frame_count % RING_SIZE);
+  Frame& frame = m_ring[slot];
+  m_frame_count++;
+  UpdateFrameRate();
+
+  // The encoder is still writing out an older frame from this slot, so skip this one.
+  if (frame.pending.load(std::memory_order_acquire))
+  {
+    m_dropped_frames.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  frame.width = static_cast<u32>(right - left);
+  frame.height = static_cast<u32>(bottom - top);
+  frame.number = m_frame_count;
+  frame.format = g_ActiveConfig.sw_offscreen_dump_format;
+  frame.data.resize(static_cast<size_t>(frame.width) * frame.height * 4);
+
+  const size_t src_stride = static_cast<size_t>(image_width) * 4;
+  const size_t dst_stride = static_cast<size_t>(frame.width) * 4;
+  const u8* src = sw_image->GetData() + top * src_stride + left * 4;
+  u8* dst = frame.data.data();
+  for (u32 y = 0; y < frame.height; y++)
+  {
+    std::memcpy(dst, src, dst_stride);
+    src += src_stride;
+    dst += dst_stride;
+  }
+
+  if (frame.format == SWOffscreenDumpFormat::None)
+    return;
+
+  if (!m_encoder_thread.joinable())
+  {
+    File::CreateFullPath(File::GetUserPath(D_DUMPFRAMES_IDX));
+    m_encoder_running.Set();
+    m_encoder_thread = std::thread(&SWOffscreenWindow::EncoderThread, this);
+  }
+
+  frame.pending.store(true, std::memory_order_release);
+  m_encode_queue.Push(slot);
+  m_encode_event.Set();
+}
+
+void SWOffscreenWindow::UpdateFrameRate()
+{
+  m_fps_frame_count++;
+
+  const Clock::time_point now = Clock::now();
+  const auto delta = now - m_fps_time;
+  if (delta < FPS_REPORT_INTERVAL)
+    return;
+
+  const double seconds = std::chrono::duration<double>(delta).count();
+  NOTICE_LOG(VIDEO, "Offscreen output: %.2f FPS", m_fps_frame_count / seconds);
+  m_fps_time = now;
+  m_fps_frame_count = 0;
+}
+
+void SWOffscreenWindow::EncoderThread()
+{
+  Common::SetCurrentThreadName("SW Offscreen Encoder");
+
+  while (true)
+  {
+    u32 slot;
+    while (m_encode_queue.Pop(slot))
+    {
+      Frame& frame = m_ring[slot];
+      WriteFrame(frame);
+      frame.pending.store(false, std::memory_order_release);
+    }
+
+    // Drain whatever is left before exiting so no queued frame is lost on shutdown.
+    if (!m_encoder_running.IsSet())
+      break;
+
+    m_encode_event.Wait();
+  }
+}
+
+void SWOffscreenWindow::WriteFrame(const Frame& frame)
+{
+  const std::string& dump_path = File::GetUserPath(D_DUMPFRAMES_IDX);
+  bool success = false;
+
+  if (frame.format == SWOffscreenDumpFormat::PNG)
+  {
+    const std::string filename =
+        StringFromFormat("%sswframe_%06" PRIu64 ".png", dump_path.c_str(), frame.number);
+    success = TextureToPng(frame.data.data(), static_cast<int>(frame.width * 4), filename,
+                           static_cast<int>(frame.width), static_cast<int>(frame.height), false);
+  }
+  else if (frame.format == SWOffscreenDumpFormat::Raw)
+  {
+    // Raw RGBA8, with the dimensions in the file name since there is no header.
+    const std::string filename =
+        StringFromFormat("%sswframe_%06" PRIu64 "_%ux%u.rgba", dump_path.c_str(), frame.number,
+                         frame.width, frame.height);
+    File::IOFile file(filename, "wb");
+    success = file.WriteBytes(frame.data.data(), frame.data.size());
+  }
+
+  if (success)
+    m_dumped_frames.fetch_add(1, std::memory_order_relaxed);
+  else
+    ERROR_LOG(VIDEO, "Failed to write offscreen frame %" PRIu64, frame.number);
+}
@@ -0,0 +1,74 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/Flag.h"
+#include "Common/SPSCQueue.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+class AbstractTexture;
+
+// Presentation target for the software renderer when there is no render window (e.g. a
+// headless DolphinNoGUI build). Frames are kept in a small in-memory ring, and can optionally
+// be written to the frame dump directory by a separate encoder thread. No GL context is needed.
+class SWOffscreenWindow
+{
+public:
+  static constexpr u32 RING_SIZE = 8;
+
+  static void Init();
+  static void Shutdown();
+
+  ~SWOffscreenWindow();
+
+  // Copies the image into the next ring slot, and queues it for encoding if enabled.
+  // Never blocks on the encoder; frames are dropped from the dump if it falls behind.
+  void ShowImage(AbstractTexture* image, const EFBRectangle& xfb_region);
+
+  static std::unique_ptr<SWOffscreenWindow> s_instance;
+
+private:
+  struct Frame
+  {
+    std::vector<u8> data;
+    u32 width = 0;
+    u32 height = 0;
+    u64 number = 0;
+    SWOffscreenDumpFormat format = SWOffscreenDumpFormat::None;
+    // Set while the encoder thread owns the slot.
+    std::atomic<bool> pending{false};
+  };
+
+  SWOffscreenWindow();
+
+  void EncoderThread();
+  void WriteFrame(const Frame& frame);
+  void UpdateFrameRate();
+
+  std::array<Frame, RING_SIZE> m_ring;
+  u64 m_frame_count = 0;
+
+  Common::SPSCQueue<u32, false> m_encode_queue;
+  Common::Event m_encode_event;
+  Common::Flag m_encoder_running;
+  std::thread m_encoder_thread;
+  std::atomic<u64> m_dumped_frames{0};
+  std::atomic<u64> m_dropped_frames{0};
+
+  using Clock = std::chrono::steady_clock;
+  Clock::time_point m_start_time;
+  Clock::time_point m_fps_time;
+  u64 m_fps_frame_count = 0;
+};
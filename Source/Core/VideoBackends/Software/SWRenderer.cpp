@@ -14,6 +14,7 @@
 #include "VideoBackends/Software/EfbCopy.h"
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/SWOGLWindow.h"
+#include "VideoBackends/Software/SWOffscreenWindow.h"
 #include "VideoBackends/Software/SWTexture.h"
 
 #include "VideoCommon/AbstractPipeline.h"
@@ -49,7 +50,8 @@ SWRenderer::CreateFramebuffer(const AbstractTexture* color_attachment,
 
 void SWRenderer::RenderText(const std::string& pstr, int left, int top, u32 color)
 {
-  SWOGLWindow::s_instance->PrintText(pstr, left, top, color);
+  if (SWOGLWindow::s_instance)
+    SWOGLWindow::s_instance->PrintText(pstr, left, top, color);
 }
 
 class SWShader final : public AbstractShader
@@ -97,6 +99,10 @@ void SWRenderer::SwapImpl(AbstractTexture* texture, const EFBRectangle& xfb_regi
     DrawDebugText();
     SWOGLWindow::s_instance->ShowImage(texture, xfb_region);
   }
+  else if (SWOffscreenWindow::s_instance)
+  {
+    SWOffscreenWindow::s_instance->ShowImage(texture, xfb_region);
+  }
 
   UpdateActiveConfig();
 }
@@ -15,6 +15,7 @@
 #include "VideoBackends/Software/EfbInterface.h"
 #include "VideoBackends/Software/Rasterizer.h"
 #include "VideoBackends/Software/SWOGLWindow.h"
+#include "VideoBackends/Software/SWOffscreenWindow.h"
 #include "VideoBackends/Software/SWRenderer.h"
 #include "VideoBackends/Software/SWTexture.h"
 #include "VideoBackends/Software/SWVertexLoader.h"
@@ -84,14 +85,22 @@ bool VideoSoftware::Initialize(void* window_handle)
   InitBackendInfo();
   InitializeShared();
 
-  SWOGLWindow::Init(window_handle);
+  // Without a render window there is nothing to present to, so skip creating a GL context
+  // altogether and keep the output in memory instead.
+  if (window_handle)
+    SWOGLWindow::Init(window_handle);
+  else
+    SWOffscreenWindow::Init();
 
   Clipper::Init();
   Rasterizer::Init();
   DebugUtil::Init();
 
-  GLInterface->MakeCurrent();
-  SWOGLWindow::s_instance->Prepare();
+  if (SWOGLWindow::s_instance)
+  {
+    GLInterface->MakeCurrent();
+    SWOGLWindow::s_instance->Prepare();
+  }
 
   g_renderer = std::make_unique<SWRenderer>();
   g_vertex_manager = std::make_unique<SWVertexLoader>();
@@ -110,7 +119,9 @@ void VideoSoftware::Shutdown()
     g_renderer->Shutdown();
 
   DebugUtil::Shutdown();
-  SWOGLWindow::Shutdown();
+  if (SWOGLWindow::s_instance)
+    SWOGLWindow::Shutdown();
+  SWOffscreenWindow::Shutdown();
   g_framebuffer_manager.reset();
   g_texture_cache.reset();
   g_perf_query.reset();
@@ -98,9 +98,9 @@ void TextureCache::ConvertTexture(TCacheEntry* destination, TCacheEntry* source,
                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 }
 
-void TextureCache::CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_width,
-                           u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
-                           const EFBRectangle& src_rect, bool scale_by_half)
+Texture2D* TextureCache::PrepareEFBCopySource(const EFBCopyParams& params,
+                                              const EFBRectangle& src_rect,
+                                              VkImageLayout* original_layout)
 {
   // Flush EFB pokes first, as they're expected to be included.
   FramebufferManager::GetInstance()->FlushEFBPokes();
@@ -124,12 +124,21 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_widt
   // The barrier has to happen after the render pass, not inside it, as we are going to be
   // reading from the texture immediately afterwards.
   StateTracker::GetInstance()->EndRenderPass();
-  StateTracker::GetInstance()->OnReadback();
 
   // Transition to shader resource before reading.
-  VkImageLayout original_layout = src_texture->GetLayout();
+  *original_layout = src_texture->GetLayout();
   src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(),
                                   VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  return src_texture;
+}
+
+void TextureCache::CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_width,
+                           u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
+                           const EFBRectangle& src_rect, bool scale_by_half)
+{
+  VkImageLayout original_layout;
+  Texture2D* src_texture = PrepareEFBCopySource(params, src_rect, &original_layout);
+  StateTracker::GetInstance()->OnReadback();
 
   m_texture_converter->EncodeTextureToMemory(src_texture->GetView(), dst, params, native_width,
                                              bytes_per_row, num_blocks_y, memory_stride, src_rect,
@@ -139,6 +148,28 @@ void TextureCache::CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_widt
   src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
 }
 
+std::unique_ptr<AbstractStagingTexture>
+TextureCache::CopyEFBToStagingTexture(const EFBCopyParams& params, u32 native_width,
+                                      u32 bytes_per_row, u32 num_blocks_y,
+                                      const EFBRectangle& src_rect, bool scale_by_half)
+{
+  std::unique_ptr<AbstractStagingTexture> staging_texture = AllocateEFBCopyStagingTexture(
+      TextureConfig(bytes_per_row / sizeof(u32), num_blocks_y, 1, 1, 1,
+                    TextureConverter::ENCODING_TEXTURE_FORMAT, false));
+  if (!staging_texture)
+    return nullptr;
+
+  // The readback is only waited for when the copy is written to RAM, so unlike CopyEFB, this
+  // does not count as a CPU access for command buffer scheduling.
+  VkImageLayout original_layout;
+  Texture2D* src_texture = PrepareEFBCopySource(params, src_rect, &original_layout);
+  m_texture_converter->EncodeTextureToStagingTexture(src_texture->GetView(), staging_texture.get(),
+                                                     params, native_width, bytes_per_row,
+                                                     num_blocks_y, src_rect, scale_by_half);
+  src_texture->TransitionToLayout(g_command_buffer_mgr->GetCurrentCommandBuffer(), original_layout);
+  return staging_texture;
+}
+
 bool TextureCache::SupportsGPUTextureDecode(TextureFormat format, TLUTFormat palette_format)
 {
   return m_texture_converter->SupportsTextureDecoding(format, palette_format);
@@ -39,6 +39,10 @@ public:
   void CopyEFB(u8* dst, const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
                u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect,
                bool scale_by_half) override;
+  std::unique_ptr<AbstractStagingTexture>
+  CopyEFBToStagingTexture(const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
+                          u32 num_blocks_y, const EFBRectangle& src_rect,
+                          bool scale_by_half) override;
 
   bool SupportsGPUTextureDecode(TextureFormat format, TLUTFormat palette_format) override;
 
@@ -51,6 +55,11 @@ public:
   StreamBuffer* GetTextureUploadBuffer() const;
 
 private:
+  // Resolves the EFB and makes it readable for an EFB copy to RAM. The returned texture has to be
+  // transitioned back to original_layout afterwards.
+  Texture2D* PrepareEFBCopySource(const EFBCopyParams& params, const EFBRectangle& src_rect,
+                                  VkImageLayout* original_layout);
+
   void CopyEFBToCacheEntry(TCacheEntry* entry, bool is_depth_copy, const EFBRectangle& src_rect,
                            bool scale_by_half, EFBCopyFormat dst_format,
                            bool is_intensity) override;
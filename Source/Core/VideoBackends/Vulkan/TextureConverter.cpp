@@ -205,6 +205,21 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
                                              const EFBCopyParams& params, u32 native_width,
                                              u32 bytes_per_row, u32 num_blocks_y, u32 memory_stride,
                                              const EFBRectangle& src_rect, bool scale_by_half)
+{
+  EncodeTextureToStagingTexture(src_texture, m_encoding_readback_texture.get(), params,
+                                native_width, bytes_per_row, num_blocks_y, src_rect,
+                                scale_by_half);
+
+  MathUtil::Rectangle<int> copy_rect(0, 0, bytes_per_row / sizeof(u32), num_blocks_y);
+  m_encoding_readback_texture->ReadTexels(copy_rect, dest_ptr, memory_stride);
+}
+
+void TextureConverter::EncodeTextureToStagingTexture(VkImageView src_texture,
+                                                     AbstractStagingTexture* readback_texture,
+                                                     const EFBCopyParams& params,
+                                                     u32 native_width, u32 bytes_per_row,
+                                                     u32 num_blocks_y, const EFBRectangle& src_rect,
+                                                     bool scale_by_half)
 {
   VkShaderModule shader = GetEncodingShader(params);
   if (shader == VK_NULL_HANDLE)
@@ -260,9 +275,7 @@ void TextureConverter::EncodeTextureToMemory(VkImageView src_texture, u8* dest_p
   draw.EndRenderPass();
 
   MathUtil::Rectangle<int> copy_rect(0, 0, render_width, render_height);
-  m_encoding_readback_texture->CopyFromTexture(m_encoding_render_texture.get(), copy_rect, 0, 0,
-                                               copy_rect);
-  m_encoding_readback_texture->ReadTexels(copy_rect, dest_ptr, memory_stride);
+  readback_texture->CopyFromTexture(m_encoding_render_texture.get(), copy_rect, 0, 0, copy_rect);
 }
 
 bool TextureConverter::SupportsTextureDecoding(TextureFormat format, TLUTFormat palette_format)
@@ -44,6 +44,16 @@ public:
                              u32 native_width, u32 bytes_per_row, u32 num_blocks_y,
                              u32 memory_stride, const EFBRectangle& src_rect, bool scale_by_half);
 
+  // Like EncodeTextureToMemory, but only records the copy into readback_texture, which has to be
+  // an ENCODING_TEXTURE_FORMAT texture of at least bytes_per_row / 4 by num_blocks_y texels.
+  void EncodeTextureToStagingTexture(VkImageView src_texture,
+                                     AbstractStagingTexture* readback_texture,
+                                     const EFBCopyParams& params, u32 native_width,
+                                     u32 bytes_per_row, u32 num_blocks_y,
+                                     const EFBRectangle& src_rect, bool scale_by_half);
+
+  static const AbstractTextureFormat ENCODING_TEXTURE_FORMAT = AbstractTextureFormat::BGRA8;
+
   bool SupportsTextureDecoding(TextureFormat format, TLUTFormat palette_format);
   void DecodeTexture(VkCommandBuffer command_buffer, TextureCache::TCacheEntry* entry,
                      u32 dst_level, const u8* data, size_t data_size, TextureFormat format,
@@ -53,7 +63,6 @@ public:
 private:
   static const u32 ENCODING_TEXTURE_WIDTH = EFB_WIDTH * 4;
   static const u32 ENCODING_TEXTURE_HEIGHT = 1024;
-  static const AbstractTextureFormat ENCODING_TEXTURE_FORMAT = AbstractTextureFormat::BGRA8;
   static const size_t NUM_PALETTE_CONVERSION_SHADERS = 3;
 
   // Maximum size of a texture based on BP registers.
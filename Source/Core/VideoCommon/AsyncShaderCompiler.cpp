@@ -31,11 +31,25 @@ void AsyncShaderCompiler::QueueWorkItem(WorkItemPtr item, u32 priority)
   else
   {
     std::lock_guard<std::mutex> guard(m_pending_work_lock);
-    m_pending_work.emplace(priority, std::move(item));
+    const WorkItem* const item_ptr = item.get();
+    m_pending_work_items[item_ptr] = m_pending_work.emplace(priority, std::move(item));
     m_worker_thread_wake.notify_one();
   }
 }
 
+bool AsyncShaderCompiler::SetWorkItemPriority(const WorkItem* item, u32 priority)
+{
+  std::lock_guard<std::mutex> guard(m_pending_work_lock);
+  auto iter = m_pending_work_items.find(item);
+  if (iter == m_pending_work_items.end())
+    return false;
+
+  auto node = m_pending_work.extract(iter->second);
+  node.key() = priority;
+  iter->second = m_pending_work.insert(std::move(node));
+  return true;
+}
+
 void AsyncShaderCompiler::RetrieveWorkItems()
 {
   std::deque<WorkItemPtr> completed_work;
@@ -222,6 +236,7 @@ void AsyncShaderCompiler::WorkerThreadRun()
       auto iter = m_pending_work.begin();
       WorkItemPtr item(std::move(iter->second));
       m_pending_work.erase(iter);
+      m_pending_work_items.erase(item.get());
       pending_lock.unlock();
 
       if (item->Compile())
@@ -12,6 +12,7 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -46,6 +47,9 @@ public:
   // Queues a new work item to the compiler threads. The lower the priority, the sooner
   // this work item will be compiled, relative to the other work items.
   void QueueWorkItem(WorkItemPtr item, u32 priority);
+  // Moves a queued work item which has not been picked up by a worker thread yet to a new
+  // priority. Returns false if the item is no longer pending.
+  bool SetWorkItemPriority(const WorkItem* item, u32 priority);
   void RetrieveWorkItems();
   bool HasPendingWork();
   bool HasCompletedWork();
@@ -80,6 +84,9 @@ private:
   // A multimap is used to store the work items. We can't use a priority_queue here, because
   // there's no way to obtain a non-const reference, which we need for the unique_ptr.
   std::multimap<u32, WorkItemPtr> m_pending_work;
+  // Where each pending work item is in m_pending_work, for changing its priority.
+  std::unordered_map<const WorkItem*, std::multimap<u32, WorkItemPtr>::iterator>
+      m_pending_work_items;
   std::mutex m_pending_work_lock;
   std::condition_variable m_worker_thread_wake;
   std::atomic_size_t m_busy_workers{0};
@@ -4,9 +4,11 @@
 
 #include "VideoCommon/BPStructs.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <string>
+#include <vector>
 
 #include "Common/Logging/Log.h"
 #include "Common/StringUtil.h"
@@ -27,8 +29,10 @@
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
+#include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/VideoBackendBase.h"
 #include "VideoCommon/VideoCommon.h"
@@ -38,12 +42,164 @@ using namespace BPFunctions;
 
 static const float s_gammaLUT[] = {1.0f, 1.7f, 2.2f, 1.0f};
 
+// Registers written while vertices were pending, without drawing those first, and a snapshot of
+// bpmem from before the first of these writes, which is the state the pending vertices use.
+static std::vector<u32> s_deferred_addresses;
+static BPMemory s_pending_bpmem;
+
 void BPInit()
 {
   memset(&bpmem, 0, sizeof(bpmem));
   bpmem.bpMask = 0xFFFFFF;
+  s_deferred_addresses.clear();
+}
+
+// Returns false for registers which only hold parameters for a later trigger (EFB copies, clears,
+// TLUT loads and TMEM preloads), or which aren't emulated. These never affect pending vertices.
+static bool AffectsDrawing(u32 address)
+{
+  switch (address)
+  {
+  case BPMEM_DISPLAYCOPYFILTER:
+  case BPMEM_DISPLAYCOPYFILTER + 1:
+  case BPMEM_DISPLAYCOPYFILTER + 2:
+  case BPMEM_DISPLAYCOPYFILTER + 3:
+  case BPMEM_COPYFILTER0:
+  case BPMEM_COPYFILTER1:
+  case BPMEM_FIELDMASK:
+  case BPMEM_FIELDMODE:
+  case BPMEM_BUSCLOCK0:
+  case BPMEM_BUSCLOCK1:
+  case BPMEM_PERF0_TRI:
+  case BPMEM_PERF0_QUAD:
+  case BPMEM_PERF1:
+  case BPMEM_EFB_TL:
+  case BPMEM_EFB_BR:
+  case BPMEM_EFB_ADDR:
+  case BPMEM_CLEAR_AR:
+  case BPMEM_CLEAR_GB:
+  case BPMEM_CLEAR_Z:
+  case BPMEM_MIPMAP_STRIDE:
+  case BPMEM_COPYYSCALE:
+  case BPMEM_LOADTLUT0:
+  case BPMEM_PRELOAD_ADDR:
+  case BPMEM_PRELOAD_TMEMEVEN:
+  case BPMEM_PRELOAD_TMEMODD:
+  case BPMEM_BP_MASK:
+  case BPMEM_IND_IMASK:
+  case BPMEM_REVBITS:
+    return false;
+  default:
+    return true;
+  }
+}
+
+// Returns true for registers which are only read when drawing, and whose value alone determines
+// the state they set. The TEV color registers aren't, as one address sets a color or a constant.
+static bool IsDeferrable(u32 address)
+{
+  switch (address)
+  {
+  case BPMEM_GENMODE:
+  case BPMEM_IND_MTXA:
+  case BPMEM_IND_MTXB:
+  case BPMEM_IND_MTXC:
+  case BPMEM_IND_MTXA + 3:
+  case BPMEM_IND_MTXB + 3:
+  case BPMEM_IND_MTXC + 3:
+  case BPMEM_IND_MTXA + 6:
+  case BPMEM_IND_MTXB + 6:
+  case BPMEM_IND_MTXC + 6:
+  case BPMEM_RAS1_SS0:
+  case BPMEM_RAS1_SS1:
+  case BPMEM_SCISSORTL:
+  case BPMEM_SCISSORBR:
+  case BPMEM_SCISSOROFFSET:
+  case BPMEM_LINEPTWIDTH:
+  case BPMEM_ZMODE:
+  case BPMEM_BLENDMODE:
+  case BPMEM_CONSTANTALPHA:
+  case BPMEM_FOGRANGE:
+  case BPMEM_FOGRANGE + 1:
+  case BPMEM_FOGRANGE + 2:
+  case BPMEM_FOGRANGE + 3:
+  case BPMEM_FOGRANGE + 4:
+  case BPMEM_FOGRANGE + 5:
+  case BPMEM_FOGPARAM0:
+  case BPMEM_FOGBMAGNITUDE:
+  case BPMEM_FOGBEXPONENT:
+  case BPMEM_FOGPARAM3:
+  case BPMEM_FOGCOLOR:
+  case BPMEM_ALPHACOMPARE:
+  case BPMEM_BIAS:
+  case BPMEM_ZTEX2:
+  case BPMEM_IREF:
+  case BPMEM_TEV_KSEL:
+  case BPMEM_TEV_KSEL + 1:
+  case BPMEM_TEV_KSEL + 2:
+  case BPMEM_TEV_KSEL + 3:
+  case BPMEM_TEV_KSEL + 4:
+  case BPMEM_TEV_KSEL + 5:
+  case BPMEM_TEV_KSEL + 6:
+  case BPMEM_TEV_KSEL + 7:
+    return true;
+  default:
+    break;
+  }
+
+  switch (address & 0xFC)
+  {
+  case BPMEM_TREF:
+  case BPMEM_TREF + 4:
+  case BPMEM_SU_SSIZE:
+  case BPMEM_SU_SSIZE + 4:
+  case BPMEM_SU_SSIZE + 8:
+  case BPMEM_SU_SSIZE + 12:
+  case BPMEM_TX_SETMODE0:
+  case BPMEM_TX_SETMODE0_4:
+  case BPMEM_TX_SETMODE1:
+  case BPMEM_TX_SETMODE1_4:
+  case BPMEM_TX_SETIMAGE0:
+  case BPMEM_TX_SETIMAGE0_4:
+  case BPMEM_TX_SETIMAGE1:
+  case BPMEM_TX_SETIMAGE1_4:
+  case BPMEM_TX_SETIMAGE2:
+  case BPMEM_TX_SETIMAGE2_4:
+  case BPMEM_TX_SETIMAGE3:
+  case BPMEM_TX_SETIMAGE3_4:
+  case BPMEM_TX_SETTLUT:
+  case BPMEM_TX_SETTLUT_4:
+    return true;
+  default:
+    break;
+  }
+
+  switch (address & 0xF0)
+  {
+  case BPMEM_IND_CMD:
+  case BPMEM_TEV_COLOR_ENV:
+  case BPMEM_TEV_COLOR_ENV + 16:
+    return true;
+  default:
+    return false;
+  }
 }
 
+void DeferBPWrite(u32 address)
+{
+  if (s_deferred_addresses.empty())
+    std::memcpy(&s_pending_bpmem, &bpmem, sizeof(bpmem));
+  if (std::find(s_deferred_addresses.begin(), s_deferred_addresses.end(), address) ==
+      s_deferred_addresses.end())
+  {
+    s_deferred_addresses.push_back(address);
+  }
+
+  INCSTAT(stats.thisFrame.numDeferredBPLoads);
+}
+
+static void ApplyBPWrite(const BPCmd& bp);
+
 static void BPWritten(const BPCmd& bp)
 {
   /*
@@ -83,10 +239,26 @@ static void BPWritten(const BPCmd& bp)
     }
   }
 
-  FlushPipeline();
+  // Pending vertices only need to be drawn first if the write affects them. Writes to state
+  // which is only read when drawing are deferred, as the game may set the same state again
+  // before the next draw (see VertexManagerBase::PrepareForAdditionalData).
+  if (!AffectsDrawing(bp.address))
+    g_vertex_manager->SkipFlush();
+  else if (IsDeferrable(bp.address) && !g_vertex_manager->IsFlushed())
+  {
+    DeferBPWrite(bp.address);
+    g_vertex_manager->SkipFlush();
+  }
+  else
+    FlushPipeline();
 
   ((u32*)&bpmem)[bp.address] = bp.newvalue;
+  ApplyBPWrite(bp);
+}
 
+// Updates everything that depends on a BP register after its new value has been written.
+static void ApplyBPWrite(const BPCmd& bp)
+{
   switch (bp.address)
   {
   case BPMEM_GENMODE:  // Set the Generation Mode
@@ -177,6 +349,8 @@ static void BPWritten(const BPCmd& bp)
     switch (bp.newvalue & 0xFF)
     {
     case 0x02:
+      // The game waits for the GPU to finish, and may read EFB copies afterwards.
+      g_texture_cache->FlushEFBCopies();
       if (!Fifo::UseDeterministicGPUThread())
         PixelEngine::SetFinish();  // may generate interrupt
       DEBUG_LOG(VIDEO, "GXSetDrawDone SetPEFinish (value: 0x%02X)", (bp.newvalue & 0xFFFF));
@@ -188,11 +362,13 @@ static void BPWritten(const BPCmd& bp)
     }
     return;
   case BPMEM_PE_TOKEN_ID:  // Pixel Engine Token ID
+    g_texture_cache->FlushEFBCopies();
     if (!Fifo::UseDeterministicGPUThread())
       PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), false);
     DEBUG_LOG(VIDEO, "SetPEToken 0x%04x", (bp.newvalue & 0xFFFF));
     return;
   case BPMEM_PE_TOKEN_INT_ID:  // Pixel Engine Interrupt Token ID
+    g_texture_cache->FlushEFBCopies();
     if (!Fifo::UseDeterministicGPUThread())
       PixelEngine::SetToken(static_cast<u16>(bp.newvalue & 0xFFFF), true);
     DEBUG_LOG(VIDEO, "SetPEToken + INT 0x%04x", (bp.newvalue & 0xFFFF));
@@ -302,6 +478,7 @@ static void BPWritten(const BPCmd& bp)
     if (!SConfig::GetInstance().bWii)
       addr = addr & 0x01FFFFFF;
 
+    g_texture_cache->FlushEFBCopiesInRange(addr, tlutXferCount);
     Memory::CopyFromEmu(texMem + tlutTMemAddr, addr, tlutXferCount);
 
     if (g_bRecordFifoData)
@@ -497,6 +674,10 @@ static void BPWritten(const BPCmd& bp)
       u32 bytes_read = 0;
       u32 tmem_addr_even = tmem_cfg.preload_tmem_even * TMEM_LINE_SIZE;
 
+      // RGBA8 tiles read two lines each.
+      g_texture_cache->FlushEFBCopiesInRange(
+          src_addr, tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE * 2);
+
       if (tmem_cfg.preload_tile_info.type != 3)
       {
         bytes_read = tmem_cfg.preload_tile_info.count * TMEM_LINE_SIZE;
@@ -677,6 +858,57 @@ static void BPWritten(const BPCmd& bp)
   WARN_LOG(VIDEO, "Unknown BP opcode: address = 0x%08x value = 0x%08x", bp.address, bp.newvalue);
 }
 
+bool HasDeferredBPWrites()
+{
+  return !s_deferred_addresses.empty();
+}
+
+bool DiscardRedundantDeferredBPWrites()
+{
+  const u32* const regs = reinterpret_cast<const u32*>(&bpmem);
+  const u32* const pending_regs = reinterpret_cast<const u32*>(&s_pending_bpmem);
+  for (u32 address : s_deferred_addresses)
+  {
+    if (regs[address] != pending_regs[address])
+      return false;
+  }
+
+  s_deferred_addresses.clear();
+  return true;
+}
+
+// Copies the deferred registers from state to bpmem, which currently matches previous_state in
+// them, and updates everything which depends on them.
+static void LoadDeferredBPRegisters(const BPMemory& previous_state, const BPMemory& state)
+{
+  u32* const regs = reinterpret_cast<u32*>(&bpmem);
+  const u32* const previous_regs = reinterpret_cast<const u32*>(&previous_state);
+  const u32* const new_regs = reinterpret_cast<const u32*>(&state);
+  for (u32 address : s_deferred_addresses)
+    regs[address] = new_regs[address];
+
+  // Some of the state depends on several registers, so all of them are copied first.
+  for (u32 address : s_deferred_addresses)
+  {
+    const u32 changes = (previous_regs[address] ^ new_regs[address]) & 0xFFFFFF;
+    ApplyBPWrite({static_cast<int>(address), static_cast<int>(changes),
+                  static_cast<int>(new_regs[address])});
+  }
+}
+
+BPMemory LoadPendingBPState()
+{
+  const BPMemory current_state = bpmem;
+  LoadDeferredBPRegisters(current_state, s_pending_bpmem);
+  return current_state;
+}
+
+void ApplyDeferredBPWrites(const BPMemory& current_state)
+{
+  LoadDeferredBPRegisters(s_pending_bpmem, current_state);
+  s_deferred_addresses.clear();
+}
+
 // Call browser: OpcodeDecoding.cpp ExecuteDisplayList > Decode() > LoadBPReg()
 void LoadBPReg(u32 value0)
 {
@@ -1413,6 +1645,9 @@ void GetBPRegInfo(const u8* data, std::string* name, std::string* desc)
 // Called when loading a saved state.
 void BPReload()
 {
+  // bpmem was replaced, so the snapshot kept for deferred writes is meaningless now.
+  s_deferred_addresses.clear();
+
   // restore anything that goes straight to the renderer.
   // let's not risk actually replaying any writes.
   // note that PixelShaderManager is already covered since it has its own DoState.
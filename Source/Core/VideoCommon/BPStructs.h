@@ -4,5 +4,25 @@
 
 #pragma once
 
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+
 void BPInit();
 void BPReload();
+
+// While vertices are pending, writes to BP registers which are only read when drawing are applied
+// without drawing the pending vertices first. A snapshot of bpmem from before the first of these
+// writes keeps the state the pending vertices were loaded with. At the next draw, the vertex
+// manager either finds the registers back at their snapshot values and keeps batching, or draws
+// the pending vertices with the snapshot state first.
+bool HasDeferredBPWrites();
+// Takes the snapshot if needed, and must be called before the register is written.
+void DeferBPWrite(u32 address);
+// Returns true, and forgets the deferred writes, if all registers are back at their snapshot values.
+bool DiscardRedundantDeferredBPWrites();
+// Sets the deferred registers to their snapshot values for drawing the pending vertices, and
+// returns the current state.
+BPMemory LoadPendingBPState();
+// Goes back to the current state after the pending vertices were drawn, and forgets the deferred
+// writes.
+void ApplyDeferredBPWrites(const BPMemory& current_state);
@@ -331,7 +331,7 @@ void GatherPipeBursted()
 
   Common::AtomicAdd(fifo.CPReadWriteDistance, GATHER_PIPE_SIZE);
 
-  Fifo::RunGpu();
+  Fifo::RunGpuForNewData();
 
   ASSERT_MSG(COMMANDPROCESSOR, fifo.CPReadWriteDistance <= fifo.CPEnd - fifo.CPBase,
              "FIFO is overflowed by GatherPipe !\nCPU thread is too fast!");
@@ -15,6 +15,7 @@
 #include "Common/FPURoundMode.h"
 #include "Common/MemoryUtil.h"
 #include "Common/MsgHandler.h"
+#include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
@@ -26,6 +27,8 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VideoBackendBase.h"
@@ -34,6 +37,12 @@ namespace Fifo
 {
 static constexpr u32 FIFO_SIZE = 2 * 1024 * 1024;
 static constexpr int GPU_TIME_SLOT_SIZE = 1000;
+static constexpr size_t CACHE_LINE_SIZE = 64;
+
+// A sleeping GPU thread is only woken up for new FIFO data once this much is waiting, or once
+// GPU_WAKEUP_DELAY cycles have passed since the first data it didn't get woken up for.
+static constexpr u32 GPU_WAKEUP_FILL_LEVEL = 4096;
+static constexpr int GPU_WAKEUP_DELAY = 10 * GPU_TIME_SLOT_SIZE;
 
 static Common::BlockingLoop s_gpu_mainloop;
 
@@ -49,13 +58,29 @@ static u8* s_fifo_aux_read_ptr;
 static bool s_use_deterministic_gpu_thread;
 
 static CoreTiming::EventType* s_event_sync_gpu;
+static CoreTiming::EventType* s_event_wake_gpu;
+
+// Set when the GPU thread wasn't woken up for new data yet.
+static Common::Flag s_gpu_wakeup_deferred;
+// Set while the wakeup event is scheduled. Only emulated state decides when it is scheduled, as
+// the event is part of savestates and has to fire at the same time in movies and netplay.
+static bool s_gpu_wakeup_scheduled;
+
+// Stall statistics, collected into the per-frame statistics by the GPU thread.
+static std::atomic<u64> s_cpu_stall_us;
+static std::atomic<u32> s_gpu_wakeups;
+static std::atomic<u32> s_gpu_wakeups_batched;
+static u64 s_gpu_idle_start_us;
 
 // STATE_TO_SAVE
 static u8* s_video_buffer;
-static u8* s_video_buffer_read_ptr;
-static std::atomic<u8*> s_video_buffer_write_ptr;
-static std::atomic<u8*> s_video_buffer_seen_ptr;
-static u8* s_video_buffer_pp_read_ptr;
+// In deterministic GPU thread mode, the CPU thread writes pp_read_ptr and write_ptr while the GPU
+// thread writes read_ptr and seen_ptr. Each one gets its own cache line so that the threads don't
+// keep stealing the line from each other.
+alignas(CACHE_LINE_SIZE) static u8* s_video_buffer_read_ptr;
+alignas(CACHE_LINE_SIZE) static std::atomic<u8*> s_video_buffer_write_ptr;
+alignas(CACHE_LINE_SIZE) static std::atomic<u8*> s_video_buffer_seen_ptr;
+alignas(CACHE_LINE_SIZE) static u8* s_video_buffer_pp_read_ptr;
 // The read_ptr is always owned by the GPU thread.  In normal mode, so is the
 // write_ptr, despite it being atomic.  In deterministic GPU thread mode,
 // things get a bit more complicated:
@@ -68,10 +93,19 @@ static u8* s_video_buffer_pp_read_ptr;
 // polls, it's just atomic.
 // - The pp_read_ptr is the CPU preprocessing version of the read_ptr.
 
-static std::atomic<int> s_sync_ticks;
+alignas(CACHE_LINE_SIZE) static std::atomic<int> s_sync_ticks;
 static bool s_syncing_suspended;
 static Common::Event s_sync_wakeup_event;
 
+// Runs a blocking wait of the CPU thread on the GPU thread, and records how long it took.
+template <typename F>
+static void WaitForGpu(F wait)
+{
+  const u64 start = Common::Timer::GetTimeUs();
+  wait();
+  s_cpu_stall_us.fetch_add(Common::Timer::GetTimeUs() - start, std::memory_order_relaxed);
+}
+
 void DoState(PointerWrap& p)
 {
   p.DoArray(s_video_buffer, FIFO_SIZE);
@@ -87,6 +121,7 @@ void DoState(PointerWrap& p)
 
   p.Do(s_sync_ticks);
   p.Do(s_syncing_suspended);
+  p.Do(s_gpu_wakeup_scheduled);
 }
 
 void PauseAndLock(bool doLock, bool unpauseOnUnlock)
@@ -161,7 +196,7 @@ void SyncGPU(SyncGPUReason reason, bool may_move_read_ptr)
 {
   if (s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wait();
+    WaitForGpu([] { s_gpu_mainloop.Wait(); });
     if (!s_gpu_mainloop.IsRunning())
       return;
 
@@ -288,6 +323,23 @@ void ResetVideoBuffer()
   s_fifo_aux_read_ptr = s_fifo_aux_data;
 }
 
+// Adds the time since the GPU thread ran out of work, and the counters of the CPU thread, to the
+// statistics of the current frame.
+static void UpdateStallStatistics()
+{
+  const u64 now = Common::Timer::GetTimeUs();
+  if (s_gpu_idle_start_us != 0)
+    ADDSTAT(stats.thisFrame.microsecondsGPUIdle, static_cast<int>(now - s_gpu_idle_start_us));
+  s_gpu_idle_start_us = 0;
+
+  ADDSTAT(stats.thisFrame.microsecondsCPUStalled,
+          static_cast<int>(s_cpu_stall_us.exchange(0, std::memory_order_relaxed)));
+  ADDSTAT(stats.thisFrame.numGPUWakeups,
+          static_cast<int>(s_gpu_wakeups.exchange(0, std::memory_order_relaxed)));
+  ADDSTAT(stats.thisFrame.numGPUWakeupsBatched,
+          static_cast<int>(s_gpu_wakeups_batched.exchange(0, std::memory_order_relaxed)));
+}
+
 // Description: Main FIFO update loop
 // Purpose: Keep the Core HW updated about the CPU-GPU distance
 void RunGpuLoop()
@@ -301,7 +353,12 @@ void RunGpuLoop()
 
         // Do nothing while paused
         if (!s_emu_running_state.IsSet())
+        {
+          s_gpu_idle_start_us = 0;
           return;
+        }
+
+        UpdateStallStatistics();
 
         if (s_use_deterministic_gpu_thread)
         {
@@ -386,6 +443,12 @@ void RunGpuLoop()
           // Make sure VertexManager finishes drawing any primitives it has stored in it's buffer.
           g_vertex_manager->Flush();
         }
+
+        // Waiting for deferred EFB copies costs nothing while there is no other work, and the CPU
+        // gets to see them as early as it would have without deferring.
+        g_texture_cache->FlushEFBCopies();
+
+        s_gpu_idle_start_us = Common::Timer::GetTimeUs();
       },
       100);
 
@@ -393,6 +456,14 @@ void RunGpuLoop()
   AsyncRequests::GetInstance()->SetPassthrough(true);
 }
 
+static void WakeGpu()
+{
+  s_gpu_wakeup_deferred.Clear();
+  if (s_gpu_mainloop.IsSleeping())
+    s_gpu_wakeups.fetch_add(1, std::memory_order_relaxed);
+  s_gpu_mainloop.Wakeup();
+}
+
 void FlushGpu()
 {
   const SConfig& param = SConfig::GetInstance();
@@ -400,7 +471,10 @@ void FlushGpu()
   if (!param.bCPUThread || s_use_deterministic_gpu_thread)
     return;
 
-  s_gpu_mainloop.Wait();
+  if (s_gpu_wakeup_deferred.IsSet())
+    WakeGpu();
+
+  WaitForGpu([] { s_gpu_mainloop.Wait(); });
 }
 
 void GpuMaySleep()
@@ -421,7 +495,7 @@ void RunGpu()
   // wake up GPU thread
   if (param.bCPUThread && !s_use_deterministic_gpu_thread)
   {
-    s_gpu_mainloop.Wakeup();
+    WakeGpu();
   }
 
   // if the sync GPU callback is suspended, wake it up.
@@ -436,6 +510,37 @@ void RunGpu()
   }
 }
 
+void RunGpuForNewData()
+{
+  const SConfig& param = SConfig::GetInstance();
+
+  // Waking up a sleeping GPU thread for every 32 byte burst costs more than the GPU work itself
+  // when the CPU thread trickles in commands, so let some data pile up first. The wakeup event
+  // bounds the added latency, and FlushGpu wakes up the GPU thread before waiting for it. Whether
+  // the GPU thread is actually sleeping must not matter here, as that depends on the host.
+  if (param.bCPUThread && !s_use_deterministic_gpu_thread && !param.bSyncGPU &&
+      CommandProcessor::fifo.CPReadWriteDistance < GPU_WAKEUP_FILL_LEVEL)
+  {
+    s_gpu_wakeups_batched.fetch_add(1, std::memory_order_relaxed);
+    s_gpu_wakeup_deferred.Set();
+    if (!s_gpu_wakeup_scheduled)
+    {
+      s_gpu_wakeup_scheduled = true;
+      CoreTiming::ScheduleEvent(GPU_WAKEUP_DELAY, s_event_wake_gpu);
+    }
+    return;
+  }
+
+  RunGpu();
+}
+
+static void WakeGpuCallback(u64 userdata, s64 cycles_late)
+{
+  s_gpu_wakeup_scheduled = false;
+  if (s_gpu_wakeup_deferred.IsSet())
+    WakeGpu();
+}
+
 static int RunGpuOnCpu(int ticks)
 {
   CommandProcessor::SCPFifoStruct& fifo = CommandProcessor::fifo;
@@ -482,9 +587,13 @@ static int RunGpuOnCpu(int ticks)
   // Discard all available ticks as there is nothing to do any more.
   s_sync_ticks.store(std::min(available_ticks, 0));
 
-  // If the GPU is idle, drop the handler.
+  // If the GPU is idle, drop the handler. The CPU may look at deferred EFB copies from now on.
   if (available_ticks >= 0)
+  {
+    if (!s_use_deterministic_gpu_thread)
+      g_texture_cache->FlushEFBCopies();
     return -1;
+  }
 
   // Always wait at least for GPU_TIME_SLOT_SIZE cycles.
   return -available_ticks + GPU_TIME_SLOT_SIZE;
@@ -555,7 +664,7 @@ static int WaitForGpuThread(int ticks)
 
   // Wait for GPU
   if (now >= param.iSyncGpuMaxDistance)
-    s_sync_wakeup_event.Wait();
+    WaitForGpu([] { s_sync_wakeup_event.Wait(); });
 
   return GPU_TIME_SLOT_SIZE;
 }
@@ -583,6 +692,8 @@ static void SyncGPUCallback(u64 ticks, s64 cyclesLate)
 void Prepare()
 {
   s_event_sync_gpu = CoreTiming::RegisterEvent("SyncGPUCallback", SyncGPUCallback);
+  s_event_wake_gpu = CoreTiming::RegisterEvent("WakeGPUCallback", WakeGpuCallback);
   s_syncing_suspended = true;
+  s_gpu_wakeup_scheduled = false;
 }
 }
@@ -38,6 +38,8 @@ void* PopFifoAuxBuffer(size_t size);
 
 void FlushGpu();
 void RunGpu();
+// Like RunGpu, but may leave a sleeping GPU thread alone until more data is in the FIFO.
+void RunGpuForNewData();
 void GpuMaySleep();
 void RunGpuLoop();
 void ExitGpuLoop();
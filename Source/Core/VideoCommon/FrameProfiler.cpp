@@ -0,0 +1,211 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/FrameProfiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "VideoCommon/OnScreenDisplay.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace FrameProfiler
+{
+// A few seconds worth of events in typical games. Older events are overwritten.
+static constexpr size_t EVENT_BUFFER_SIZE = 1 << 18;
+static constexpr size_t NUM_SECTIONS = static_cast<size_t>(Section::NumSections);
+
+struct Event
+{
+  u64 start;
+  u32 duration;
+  Section section;
+};
+
+bool g_enabled;
+
+static ScopedSection* s_current_section;
+static std::vector<Event> s_events;
+static u64 s_num_events;
+static std::array<u64, NUM_SECTIONS> s_frame_times;
+static std::array<u64, NUM_SECTIONS> s_last_frame_times;
+
+static u64 GetTimeNs()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+static void RecordEvent(u64 start, u64 duration, Section section)
+{
+  Event& event = s_events[s_num_events++ & (EVENT_BUFFER_SIZE - 1)];
+  event.start = start;
+  event.duration = static_cast<u32>(std::min<u64>(duration, std::numeric_limits<u32>::max()));
+  event.section = section;
+}
+
+static std::string GetTraceFilename()
+{
+  return File::GetUserPath(D_LOGS_IDX) + "frame_trace.json";
+}
+
+static void Reset()
+{
+  s_num_events = 0;
+  s_frame_times = {};
+  s_last_frame_times = {};
+}
+
+static void Enable(bool enable)
+{
+  if (enable == g_enabled)
+    return;
+
+  g_enabled = enable;
+  if (enable)
+  {
+    s_events.resize(EVENT_BUFFER_SIZE);
+    Reset();
+    return;
+  }
+
+  const std::string filename = GetTraceFilename();
+  if (s_num_events != 0 && ExportTrace(filename))
+    OSD::AddMessage(StringFromFormat("Wrote frame trace to %s", filename.c_str()));
+
+  // Sections which are still open keep a pointer to their parent, so only drop the buffer.
+  s_events.clear();
+  s_events.shrink_to_fit();
+}
+
+void Init()
+{
+  g_enabled = false;
+  Reset();
+  Enable(g_ActiveConfig.bLogFrameTraceToFile);
+}
+
+void Shutdown()
+{
+  Enable(false);
+}
+
+void EndFrame()
+{
+  if (g_enabled)
+  {
+    // Each frame only counts its own share of the open sections. The innermost one is split
+    // first, so that its parent sees it as a child which has just been left.
+    const u64 now = GetTimeNs();
+    for (ScopedSection* section = s_current_section; section; section = section->m_parent)
+    {
+      const u64 duration = now - section->m_start;
+      if (section->m_parent)
+        section->m_parent->m_child_time += duration;
+      s_frame_times[static_cast<size_t>(section->m_section)] += duration - section->m_child_time;
+      RecordEvent(section->m_start, duration, section->m_section);
+      section->m_start = now;
+      section->m_child_time = 0;
+    }
+
+    RecordEvent(now, 0, Section::Frame);
+    s_last_frame_times = s_frame_times;
+    s_frame_times = {};
+  }
+
+  Enable(g_ActiveConfig.bLogFrameTraceToFile);
+}
+
+double GetLastFrameTime(Section section)
+{
+  return s_last_frame_times[static_cast<size_t>(section)] / 1000.0;
+}
+
+const char* GetSectionName(Section section)
+{
+  static constexpr std::array<const char*, NUM_SECTIONS + 1> names = {
+      {"Opcode Decoding", "Vertex Loading", "Texture Cache", "Shader Compilation", "Flush",
+       "Present", "Frame"}};
+  return names[static_cast<size_t>(section)];
+}
+
+bool ExportTrace(const std::string& filename)
+{
+  if (s_events.empty())
+    return false;
+
+  std::ofstream file;
+  File::OpenFStream(file, filename, std::ios_base::out | std::ios_base::trunc);
+  if (!file.good())
+  {
+    ERROR_LOG(VIDEO, "Could not open %s to write the frame trace.", filename.c_str());
+    return false;
+  }
+
+  const u64 first = s_num_events > EVENT_BUFFER_SIZE ? s_num_events - EVENT_BUFFER_SIZE : 0;
+  u64 base_time = std::numeric_limits<u64>::max();
+  for (u64 i = first; i < s_num_events; i++)
+    base_time = std::min(base_time, s_events[i & (EVENT_BUFFER_SIZE - 1)].start);
+
+  // Timestamps are in microseconds. Complete events ("X") are nested by their time range, and
+  // frame boundaries are global instant events ("i").
+  file << "{\"traceEvents\":[\n";
+  for (u64 i = first; i < s_num_events; i++)
+  {
+    const Event& event = s_events[i & (EVENT_BUFFER_SIZE - 1)];
+    const double timestamp = (event.start - base_time) / 1000.0;
+    if (event.section == Section::Frame)
+    {
+      file << StringFromFormat("{\"name\":\"Frame\",\"cat\":\"video\",\"ph\":\"i\",\"s\":\"g\","
+                               "\"pid\":1,\"tid\":1,\"ts\":%.3f}",
+                               timestamp);
+    }
+    else
+    {
+      file << StringFromFormat("{\"name\":\"%s\",\"cat\":\"video\",\"ph\":\"X\",\"pid\":1,"
+                               "\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                               GetSectionName(event.section), timestamp,
+                               event.duration / 1000.0);
+    }
+    file << (i + 1 != s_num_events ? ",\n" : "\n");
+  }
+  file << "],\"displayTimeUnit\":\"ns\"}\n";
+
+  INFO_LOG(VIDEO, "Wrote %u frame trace events to %s",
+           static_cast<unsigned>(s_num_events - first), filename.c_str());
+  return file.good();
+}
+
+void ScopedSection::Enter(Section section)
+{
+  m_section = section;
+  m_parent = s_current_section;
+  s_current_section = this;
+  m_start = GetTimeNs();
+}
+
+void ScopedSection::Leave()
+{
+  const u64 duration = GetTimeNs() - m_start;
+  s_current_section = m_parent;
+  if (m_parent)
+    m_parent->m_child_time += duration;
+
+  // The profiler may have been turned off while the section was open.
+  if (!g_enabled)
+    return;
+
+  s_frame_times[static_cast<size_t>(m_section)] += duration - m_child_time;
+  RecordEvent(m_start, duration, m_section);
+}
+}  // namespace FrameProfiler
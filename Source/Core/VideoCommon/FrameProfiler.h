@@ -0,0 +1,73 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+
+#include "Common/CommonTypes.h"
+
+// Times the main stages of the GPU thread. Every section keeps a per-frame total of the time
+// spent in it, excluding the time of sections nested inside it, and is recorded in a ring buffer
+// of recent events which can be exported as a Chrome trace (chrome://tracing).
+// Sections must only be entered on the thread which runs the video backend.
+namespace FrameProfiler
+{
+enum class Section : u8
+{
+  OpcodeDecoding,
+  VertexLoading,
+  TextureCache,
+  ShaderCompilation,
+  Flush,
+  Present,
+  NumSections,
+  Frame = NumSections
+};
+
+extern bool g_enabled;
+
+void Init();
+void Shutdown();
+
+// Called once per frame by the renderer. Picks up config changes, and writes the trace file
+// when profiling was turned off. Sections which are still open, like the opcode decoding which
+// led to the swap, are split at the frame boundary.
+void EndFrame();
+
+// Time spent in the section during the previous frame, in microseconds.
+double GetLastFrameTime(Section section);
+const char* GetSectionName(Section section);
+
+bool ExportTrace(const std::string& filename);
+
+class ScopedSection final
+{
+public:
+  explicit ScopedSection(Section section, bool enable = true)
+  {
+    if (g_enabled && enable)
+      Enter(section);
+  }
+  ~ScopedSection()
+  {
+    if (m_start)
+      Leave();
+  }
+
+  ScopedSection(const ScopedSection&) = delete;
+  ScopedSection& operator=(const ScopedSection&) = delete;
+
+private:
+  friend void EndFrame();
+
+  void Enter(Section section);
+  void Leave();
+
+  ScopedSection* m_parent = nullptr;
+  u64 m_start = 0;
+  u64 m_child_time = 0;
+  Section m_section = Section::NumSections;
+};
+}  // namespace FrameProfiler
@@ -95,4 +95,8 @@ struct SerializedGXPipelineUid
 };
 #pragma pack(pop)
 
+// Pipeline UID cache files start with this magic and GX_PIPELINE_UID_VERSION, followed by
+// SerializedGXPipelineUid entries.
+constexpr u32 GX_PIPELINE_UID_CACHE_MAGIC = 0x44495550;  // PUID
+
 }  // namespace VideoCommon
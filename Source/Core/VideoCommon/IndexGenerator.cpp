@@ -2,7 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <array>
 #include <cstddef>
+#include <initializer_list>
+#include <numeric>
+#if defined(_M_X86) || defined(_M_X86_64)
+#include <emmintrin.h>
+#endif
 
 #include "Common/Common.h"
 #include "Common/CommonTypes.h"
@@ -20,6 +26,115 @@ static const u16 s_primitive_restart = UINT16_MAX;
 
 static u16* (*primitive_table[8])(u16*, u32, u32);
 
+namespace
+{
+// Index sequences repeat with a fixed period for every primitive type, so the bulk of a draw is
+// written by adding a per-lane step to precomputed vectors, eight indices at a time. A template
+// describes one period of the sequence relative to the loop counter i of the scalar loop it
+// replaces. The scalar loops then write whatever remains.
+constexpr s8 RESTART = INT8_MAX;
+constexpr s8 CENTER = INT8_MIN;
+
+struct IndexTemplate
+{
+  static constexpr u32 MAX_VECTORS = 5;
+
+  constexpr IndexTemplate(std::initializer_list<s8> period, u32 vertices_per_period_,
+                          u32 last_offset_)
+      : vertices_per_period(vertices_per_period_), last_offset(last_offset_)
+  {
+    const u32 period_size = static_cast<u32>(period.size());
+    // A group is the smallest number of periods which fills whole vectors.
+    num_vectors = period_size / std::gcd(period_size, 8u);
+    periods_per_group = num_vectors * 8 / period_size;
+
+    for (u32 lane = 0; lane < num_vectors * 8; lane++)
+    {
+      const s8 element = period.begin()[lane % period_size];
+      const u32 period_index = lane / period_size;
+      if (element == RESTART)
+      {
+        restart_mask[lane] = UINT16_MAX;
+      }
+      else if (element == CENTER)
+      {
+        center_mask[lane] = UINT16_MAX;
+      }
+      else
+      {
+        offsets[lane] = static_cast<u16>(element + period_index * vertices_per_period);
+        steps[lane] = static_cast<u16>(periods_per_group * vertices_per_period);
+        vertex_mask[lane] = UINT16_MAX;
+      }
+    }
+  }
+
+  u32 num_vectors = 0;
+  u32 periods_per_group = 0;
+  u32 vertices_per_period;
+  // Offset of the last vertex a period uses, so that i + last_offset < numVerts is the
+  // condition of the scalar loop.
+  u32 last_offset;
+
+  alignas(16) std::array<u16, MAX_VECTORS * 8> offsets{};
+  alignas(16) std::array<u16, MAX_VECTORS * 8> steps{};
+  alignas(16) std::array<u16, MAX_VECTORS * 8> vertex_mask{};
+  alignas(16) std::array<u16, MAX_VECTORS * 8> center_mask{};
+  alignas(16) std::array<u16, MAX_VECTORS * 8> restart_mask{};
+};
+
+constexpr IndexTemplate s_points_template({0}, 1, 0);
+constexpr IndexTemplate s_line_list_template({-1, 0}, 2, 0);
+constexpr IndexTemplate s_line_strip_template({-1, 0}, 1, 0);
+constexpr IndexTemplate s_list_template({-2, -1, 0}, 3, 0);
+constexpr IndexTemplate s_list_pr_template({-2, -1, 0, RESTART}, 3, 0);
+// Two triangles, as the winding alternates.
+constexpr IndexTemplate s_strip_template({-2, -1, 0, -1, 1, 0}, 2, 1);
+constexpr IndexTemplate s_fan_template({CENTER, -1, 0}, 1, 0);
+constexpr IndexTemplate s_fan_pr_template({-1, 0, CENTER, 1, 2, RESTART}, 3, 2);
+constexpr IndexTemplate s_quads_template({-3, -2, -1, -3, -1, 0}, 4, 0);
+constexpr IndexTemplate s_quads_pr_template({-2, -1, -3, 0, RESTART}, 4, 0);
+
+// Writes as many whole groups of the template as the scalar loop would, and advances i past them.
+__forceinline u16* WriteTemplate(const IndexTemplate& tmpl, u16* Iptr, u32 numVerts, u32 index,
+                                 u32* i)
+{
+#if defined(_M_X86) || defined(_M_X86_64)
+  const u32 group_vertices = tmpl.periods_per_group * tmpl.vertices_per_period;
+  const u32 group_span = group_vertices - tmpl.vertices_per_period + tmpl.last_offset;
+  if (*i + group_span >= numVerts)
+    return Iptr;
+
+  const __m128i vertex_base = _mm_set1_epi16(static_cast<s16>(index + *i));
+  const __m128i center = _mm_set1_epi16(static_cast<s16>(index));
+  __m128i indices[IndexTemplate::MAX_VECTORS];
+  __m128i steps[IndexTemplate::MAX_VECTORS];
+  for (u32 v = 0; v < tmpl.num_vectors; v++)
+  {
+    const auto load = [v](const std::array<u16, IndexTemplate::MAX_VECTORS * 8>& a) {
+      return _mm_load_si128(reinterpret_cast<const __m128i*>(&a[v * 8]));
+    };
+    __m128i value = _mm_and_si128(vertex_base, load(tmpl.vertex_mask));
+    value = _mm_add_epi16(value, _mm_and_si128(center, load(tmpl.center_mask)));
+    value = _mm_add_epi16(value, load(tmpl.offsets));
+    indices[v] = _mm_or_si128(value, load(tmpl.restart_mask));
+    steps[v] = load(tmpl.steps);
+  }
+
+  for (; *i + group_span < numVerts; *i += group_vertices)
+  {
+    for (u32 v = 0; v < tmpl.num_vectors; v++)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(Iptr), indices[v]);
+      indices[v] = _mm_add_epi16(indices[v], steps[v]);
+      Iptr += 8;
+    }
+  }
+#endif
+  return Iptr;
+}
+}  // Anonymous namespace
+
 void IndexGenerator::Init()
 {
   if (g_Config.backend_info.bSupportsPrimitiveRestart)
@@ -71,7 +186,9 @@ __forceinline u16* IndexGenerator::WriteTriangle(u16* Iptr, u32 index1, u32 inde
 template <bool pr>
 u16* IndexGenerator::AddList(u16* Iptr, u32 const numVerts, u32 index)
 {
-  for (u32 i = 2; i < numVerts; i += 3)
+  u32 i = 2;
+  Iptr = WriteTemplate(pr ? s_list_pr_template : s_list_template, Iptr, numVerts, index, &i);
+  for (; i < numVerts; i += 3)
   {
     Iptr = WriteTriangle<pr>(Iptr, index + i - 2, index + i - 1, index + i);
   }
@@ -83,7 +200,9 @@ u16* IndexGenerator::AddStrip(u16* Iptr, u32 const numVerts, u32 index)
 {
   if (pr)
   {
-    for (u32 i = 0; i < numVerts; ++i)
+    u32 i = 0;
+    Iptr = WriteTemplate(s_points_template, Iptr, numVerts, index, &i);
+    for (; i < numVerts; ++i)
     {
       *Iptr++ = index + i;
     }
@@ -91,8 +210,11 @@ u16* IndexGenerator::AddStrip(u16* Iptr, u32 const numVerts, u32 index)
   }
   else
   {
+    // The template covers pairs of triangles, so the winding is unchanged after it.
+    u32 i = 2;
+    Iptr = WriteTemplate(s_strip_template, Iptr, numVerts, index, &i);
     bool wind = false;
-    for (u32 i = 2; i < numVerts; ++i)
+    for (; i < numVerts; ++i)
     {
       Iptr = WriteTriangle<pr>(Iptr, index + i - 2, index + i - !wind, index + i - wind);
 
@@ -128,6 +250,7 @@ u16* IndexGenerator::AddFan(u16* Iptr, u32 numVerts, u32 index)
 
   if (pr)
   {
+    Iptr = WriteTemplate(s_fan_pr_template, Iptr, numVerts, index, &i);
     for (; i + 3 <= numVerts; i += 3)
     {
       *Iptr++ = index + i - 1;
@@ -147,6 +270,10 @@ u16* IndexGenerator::AddFan(u16* Iptr, u32 numVerts, u32 index)
       *Iptr++ = s_primitive_restart;
     }
   }
+  else
+  {
+    Iptr = WriteTemplate(s_fan_template, Iptr, numVerts, index, &i);
+  }
 
   for (; i < numVerts; ++i)
   {
@@ -176,6 +303,7 @@ template <bool pr>
 u16* IndexGenerator::AddQuads(u16* Iptr, u32 numVerts, u32 index)
 {
   u32 i = 3;
+  Iptr = WriteTemplate(pr ? s_quads_pr_template : s_quads_template, Iptr, numVerts, index, &i);
   for (; i < numVerts; i += 4)
   {
     if (pr)
@@ -212,7 +340,9 @@ u16* IndexGenerator::AddQuads_nonstandard(u16* Iptr, u32 numVerts, u32 index)
 // Lines
 u16* IndexGenerator::AddLineList(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 1; i < numVerts; i += 2)
+  u32 i = 1;
+  Iptr = WriteTemplate(s_line_list_template, Iptr, numVerts, index, &i);
+  for (; i < numVerts; i += 2)
   {
     *Iptr++ = index + i - 1;
     *Iptr++ = index + i;
@@ -224,7 +354,9 @@ u16* IndexGenerator::AddLineList(u16* Iptr, u32 numVerts, u32 index)
 // so converting them to lists
 u16* IndexGenerator::AddLineStrip(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 1; i < numVerts; ++i)
+  u32 i = 1;
+  Iptr = WriteTemplate(s_line_strip_template, Iptr, numVerts, index, &i);
+  for (; i < numVerts; ++i)
   {
     *Iptr++ = index + i - 1;
     *Iptr++ = index + i;
@@ -235,7 +367,9 @@ u16* IndexGenerator::AddLineStrip(u16* Iptr, u32 numVerts, u32 index)
 // Points
 u16* IndexGenerator::AddPoints(u16* Iptr, u32 numVerts, u32 index)
 {
-  for (u32 i = 0; i != numVerts; ++i)
+  u32 i = 0;
+  Iptr = WriteTemplate(s_points_template, Iptr, numVerts, index, &i);
+  for (; i != numVerts; ++i)
   {
     *Iptr++ = index + i;
   }
@@ -15,6 +15,11 @@
 // when they are called. The reason is that the vertex format affects the sizes of the vertices.
 
 #include "VideoCommon/OpcodeDecoding.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
 #include "Common/CommonTypes.h"
 #include "Common/Logging/Log.h"
 #include "Common/MsgHandler.h"
@@ -25,9 +30,11 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
 #include "VideoCommon/XFMemory.h"
 
 bool g_bRecordFifoData = false;
@@ -36,6 +43,163 @@ namespace OpcodeDecoder
 {
 static bool s_bFifoErrorSeen = false;
 
+// A display list decoded into the commands which have side effects, so that calling it again only
+// has to replay those. How the vertex data is split into primitives depends on the vertex formats
+// at the time of the call, so those are part of the key, and the list is re-decoded whenever its
+// memory has been written to.
+struct CachedDisplayList
+{
+  enum class CommandType : u8
+  {
+    LoadCP,
+    LoadXF,
+    LoadIndexedXF,
+    LoadBP,
+    Draw,
+  };
+
+  struct Command
+  {
+    CommandType type;
+    // CP sub command, XF transfer size, indexed XF array or draw opcode.
+    u8 sub_cmd;
+    u16 num_vertices;
+    // Register value or XF address.
+    u32 value;
+    // Offset of the XF data or vertex data from the start of the display list.
+    u32 offset;
+  };
+
+  u32 size;
+  TVtxDesc vtx_desc;
+  VAT vtx_attr[8];
+  u64 write_stamp;
+  u32 cycles;
+  std::vector<Command> commands;
+};
+
+// Bounds the memory used by the cache. It is simply emptied once it grows past this.
+constexpr size_t MAX_CACHED_DISPLAY_LIST_COMMANDS = 1024 * 1024;
+
+static std::unordered_map<u32, CachedDisplayList> s_display_list_cache;
+static size_t s_cached_display_list_commands = 0;
+
+// Set while Run decodes a display list for the cache.
+static CachedDisplayList* s_recording_display_list = nullptr;
+static const u8* s_recording_display_list_start = nullptr;
+static bool s_recording_display_list_failed = false;
+
+static void RecordCommand(CachedDisplayList::CommandType type, u8 sub_cmd, u32 value,
+                          const u8* data = nullptr, u16 num_vertices = 0)
+{
+  const u32 offset = data ? static_cast<u32>(data - s_recording_display_list_start) : 0;
+  s_recording_display_list->commands.push_back({type, sub_cmd, num_vertices, value, offset});
+}
+
+static bool UseDisplayListCache()
+{
+  // With the deterministic GPU thread, display lists are read from the aux FIFO instead of RAM,
+  // and the FIFO recorder needs to see every command.
+  return g_ActiveConfig.bDisplayListCache && Memory::IsWriteTrackingEnabled() &&
+         !Fifo::UseDeterministicGPUThread() && !g_bRecordFifoData;
+}
+
+static bool MatchesVertexState(const CachedDisplayList& dl)
+{
+  return dl.vtx_desc.Hex == g_main_cp_state.vtx_desc.Hex &&
+         std::memcmp(dl.vtx_attr, g_main_cp_state.vtx_attr, sizeof(dl.vtx_attr)) == 0;
+}
+
+static void ReplayDisplayList(const CachedDisplayList& dl, u8* start_address)
+{
+  u8* const end_address = start_address + dl.size;
+  for (const CachedDisplayList::Command& command : dl.commands)
+  {
+    switch (command.type)
+    {
+    case CachedDisplayList::CommandType::LoadCP:
+      LoadCPReg(command.sub_cmd, command.value, false);
+      INCSTAT(stats.thisFrame.numCPLoads);
+      break;
+
+    case CachedDisplayList::CommandType::LoadXF:
+      LoadXFReg(command.sub_cmd, command.value,
+                DataReader(start_address + command.offset, end_address));
+      INCSTAT(stats.thisFrame.numXFLoads);
+      break;
+
+    case CachedDisplayList::CommandType::LoadIndexedXF:
+      LoadIndexedXF(command.value, command.sub_cmd);
+      break;
+
+    case CachedDisplayList::CommandType::LoadBP:
+      LoadBPReg(command.value);
+      INCSTAT(stats.thisFrame.numBPLoads);
+      break;
+
+    case CachedDisplayList::CommandType::Draw:
+      VertexLoaderManager::RunVertices(command.sub_cmd & GX_VAT_MASK,
+                                       (command.sub_cmd & GX_PRIMITIVE_MASK) >> GX_PRIMITIVE_SHIFT,
+                                       command.num_vertices,
+                                       DataReader(start_address + command.offset, end_address),
+                                       false);
+      break;
+    }
+  }
+}
+
+static void ClearDisplayListCache()
+{
+  s_display_list_cache.clear();
+  s_cached_display_list_commands = 0;
+}
+
+static u32 RunCachedDisplayList(u32 address, u32 size, u8* start_address)
+{
+  auto iter = s_display_list_cache.find(address);
+  if (iter != s_display_list_cache.end())
+  {
+    const CachedDisplayList& dl = iter->second;
+    if (dl.size == size && MatchesVertexState(dl) &&
+        !Memory::WasWrittenSince(address, size, dl.write_stamp))
+    {
+      INCSTAT(stats.thisFrame.numDListsReplayed);
+      ReplayDisplayList(dl, start_address);
+      return dl.cycles;
+    }
+
+    s_cached_display_list_commands -= dl.commands.size();
+    s_display_list_cache.erase(iter);
+  }
+
+  if (s_cached_display_list_commands > MAX_CACHED_DISPLAY_LIST_COMMANDS)
+    ClearDisplayListCache();
+
+  CachedDisplayList dl;
+  dl.size = size;
+  dl.vtx_desc = g_main_cp_state.vtx_desc;
+  std::memcpy(dl.vtx_attr, g_main_cp_state.vtx_attr, sizeof(dl.vtx_attr));
+  // Start tracking before decoding, so that a write while decoding invalidates the entry.
+  dl.write_stamp = Memory::TrackWrites(address, size);
+
+  s_recording_display_list = &dl;
+  s_recording_display_list_start = start_address;
+  s_recording_display_list_failed = false;
+  u32 cycles = 0;
+  Run(DataReader(start_address, start_address + size), &cycles, true);
+  s_recording_display_list = nullptr;
+
+  // Unknown opcodes are logged every time they are seen, so lists containing them are not cached.
+  if (!s_recording_display_list_failed)
+  {
+    dl.cycles = cycles;
+    s_cached_display_list_commands += dl.commands.size();
+    s_display_list_cache.emplace(address, std::move(dl));
+  }
+
+  return cycles;
+}
+
 static u32 InterpretDisplayList(u32 address, u32 size)
 {
   u8* startAddress;
@@ -53,7 +217,17 @@ static u32 InterpretDisplayList(u32 address, u32 size)
     // temporarily swap dl and non-dl (small "hack" for the stats)
     Statistics::SwapDL();
 
-    Run(DataReader(startAddress, startAddress + size), &cycles, true);
+    if (UseDisplayListCache())
+    {
+      cycles = RunCachedDisplayList(address, size, startAddress);
+    }
+    else
+    {
+      // Entries can't be trusted once writes went untracked, so don't keep them around.
+      if (!s_display_list_cache.empty())
+        ClearDisplayListCache();
+      Run(DataReader(startAddress, startAddress + size), &cycles, true);
+    }
     INCSTAT(stats.thisFrame.numDListsCalled);
 
     // un-swap
@@ -78,11 +252,13 @@ static void InterpretDisplayListPreprocess(u32 address, u32 size)
 void Init()
 {
   s_bFifoErrorSeen = false;
+  ClearDisplayListCache();
 }
 
 template <bool is_preprocess>
 u8* Run(DataReader src, u32* cycles, bool in_display_list)
 {
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::OpcodeDecoding, !is_preprocess);
   u32 totalCycles = 0;
   u8* opcodeStart;
   while (true)
@@ -114,7 +290,11 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       u32 value = src.Read<u32>();
       LoadCPReg(sub_cmd, value, is_preprocess);
       if (!is_preprocess)
+      {
         INCSTAT(stats.thisFrame.numCPLoads);
+        if (s_recording_display_list)
+          RecordCommand(CachedDisplayList::CommandType::LoadCP, sub_cmd, value);
+      }
     }
     break;
 
@@ -131,6 +311,11 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
       {
         u32 xf_address = Cmd2 & 0xFFFF;
         LoadXFReg(transfer_size, xf_address, src);
+        if (s_recording_display_list)
+        {
+          RecordCommand(CachedDisplayList::CommandType::LoadXF, transfer_size, xf_address,
+                        src.GetPointer());
+        }
 
         INCSTAT(stats.thisFrame.numXFLoads);
       }
@@ -155,9 +340,16 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         goto end;
       totalCycles += 6;
       if (is_preprocess)
+      {
         PreprocessIndexedXF(src.Read<u32>(), refarray);
+      }
       else
-        LoadIndexedXF(src.Read<u32>(), refarray);
+      {
+        u32 value = src.Read<u32>();
+        LoadIndexedXF(value, refarray);
+        if (s_recording_display_list)
+          RecordCommand(CachedDisplayList::CommandType::LoadIndexedXF, refarray, value);
+      }
       break;
 
     case GX_CMD_CALL_DL:
@@ -209,6 +401,8 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         {
           LoadBPReg(bp_cmd);
           INCSTAT(stats.thisFrame.numBPLoads);
+          if (s_recording_display_list)
+            RecordCommand(CachedDisplayList::CommandType::LoadBP, 0, bp_cmd);
         }
       }
       break;
@@ -228,6 +422,11 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         if (bytes < 0)
           goto end;
 
+        if (!is_preprocess && s_recording_display_list)
+        {
+          RecordCommand(CachedDisplayList::CommandType::Draw, cmd_byte, 0, src.GetPointer(),
+                        num_vertices);
+        }
         src.Skip(bytes);
 
         // 4 GPU ticks per vertex, 3 CPU ticks per GPU tick
@@ -240,6 +439,8 @@ u8* Run(DataReader src, u32* cycles, bool in_display_list)
         ERROR_LOG(VIDEO, "FIFO: Unknown Opcode(0x%02x @ %p, preprocessing = %s)", cmd_byte,
                   opcodeStart, is_preprocess ? "yes" : "no");
         s_bFifoErrorSeen = true;
+        if (!is_preprocess && s_recording_display_list)
+          s_recording_display_list_failed = true;
         totalCycles += 1;
       }
       break;
@@ -0,0 +1,52 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include "VideoCommon/PendingEFBCopies.h"
+
+#include <utility>
+
+#include "VideoCommon/AbstractStagingTexture.h"
+
+PendingEFBCopies::PendingEFBCopies() = default;
+PendingEFBCopies::~PendingEFBCopies() = default;
+
+PendingEFBCopies::Copy& PendingEFBCopies::Add(Copy copy)
+{
+  m_copies.push_back(std::move(copy));
+  return m_copies.back();
+}
+
+bool PendingEFBCopies::Overlaps(u32 address, u32 size) const
+{
+  for (const Copy& copy : m_copies)
+  {
+    if (address < copy.dst_addr + copy.GetSize() && copy.dst_addr < address + size)
+      return true;
+  }
+  return false;
+}
+
+PendingEFBCopies::StagingTextures
+PendingEFBCopies::Flush(const std::function<void(const Copy&)>& write_copy)
+{
+  StagingTextures textures;
+  textures.reserve(m_copies.size());
+  for (Copy& copy : m_copies)
+  {
+    write_copy(copy);
+    textures.push_back(std::move(copy.texture));
+  }
+  m_copies.clear();
+  return textures;
+}
+
+PendingEFBCopies::StagingTextures PendingEFBCopies::Discard()
+{
+  StagingTextures textures;
+  textures.reserve(m_copies.size());
+  for (Copy& copy : m_copies)
+    textures.push_back(std::move(copy.texture));
+  m_copies.clear();
+  return textures;
+}
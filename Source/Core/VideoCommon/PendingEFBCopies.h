@@ -0,0 +1,54 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+class AbstractStagingTexture;
+
+// EFB copies to RAM which have been encoded on the GPU, but not read back yet. They are written
+// to RAM in the order they were made, as later copies may overwrite earlier ones.
+class PendingEFBCopies
+{
+public:
+  struct Copy
+  {
+    u32 dst_addr;
+    u32 bytes_per_row;
+    u32 num_blocks_y;
+    u32 memory_stride;
+    // The entry created for the copy in VRAM, which is only hashed once the data is in RAM.
+    bool has_entry;
+    u64 entry_id;
+    std::unique_ptr<AbstractStagingTexture> texture;
+
+    // Size of the memory range the copy writes to.
+    u32 GetSize() const { return (num_blocks_y - 1) * memory_stride + bytes_per_row; }
+  };
+
+  using StagingTextures = std::vector<std::unique_ptr<AbstractStagingTexture>>;
+
+  PendingEFBCopies();
+  ~PendingEFBCopies();
+
+  bool IsEmpty() const { return m_copies.empty(); }
+  size_t GetCount() const { return m_copies.size(); }
+
+  Copy& Add(Copy copy);
+  bool Overlaps(u32 address, u32 size) const;
+
+  // Passes every copy to write_copy, oldest first, and returns their staging textures.
+  StagingTextures Flush(const std::function<void(const Copy&)>& write_copy);
+
+  // Forgets every copy without writing it to RAM, and returns their staging textures.
+  StagingTextures Discard();
+
+private:
+  std::vector<Copy> m_copies;
+};
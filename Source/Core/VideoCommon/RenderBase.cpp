@@ -51,6 +51,7 @@
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FPSCounter.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/FramebufferManagerBase.h"
 #include "VideoCommon/ImageWrite.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -658,6 +659,9 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
   // behind the renderer.
   FlushFrameDump();
 
+  // Deferred EFB copies are written to RAM at the end of the frame at the latest.
+  g_texture_cache->FlushEFBCopies();
+
   if (xfbAddr && fbWidth && fbStride && fbHeight)
   {
     constexpr int force_safe_texture_cache_hash = 0;
@@ -679,6 +683,8 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
 
       // TODO: merge more generic parts into VideoCommon
       {
+        // Timed on its own, rather than as part of the opcode decoding which led to the swap.
+        FrameProfiler::ScopedSection profile(FrameProfiler::Section::Present);
         std::lock_guard<std::mutex> guard(m_swap_mutex);
         g_renderer->SwapImpl(xfb_entry->texture.get(), xfb_rect, ticks, xfb_entry->gamma);
       }
@@ -698,6 +704,7 @@ void Renderer::Swap(u32 xfbAddr, u32 fbWidth, u32 fbStride, u32 fbHeight, const
       // Begin new frame
       // Set default viewport and scissor, for the clear to work correctly
       // New frame
+      FrameProfiler::EndFrame();
       stats.ResetFrame();
       g_shader_cache->RetrieveAsyncShaders();
 
@@ -781,42 +788,80 @@ void Renderer::RenderFrameDump()
 
 void Renderer::QueueFrameDumpReadback()
 {
-  // Index 0 was just sent to AVI dump. Swap with the second texture.
-  if (m_frame_dump_readback_textures[0])
-    std::swap(m_frame_dump_readback_textures[0], m_frame_dump_readback_textures[1]);
-
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
-  if (!rbtex || rbtex->GetConfig() != m_frame_dump_render_texture->GetConfig())
+  std::unique_ptr<AbstractStagingTexture> rbtex =
+      GetFrameDumpReadbackTexture(m_frame_dump_render_texture->GetConfig());
+  if (!rbtex)
   {
-    rbtex = CreateStagingTexture(StagingTextureType::Readback,
-                                 m_frame_dump_render_texture->GetConfig());
+    ADDSTAT(stats.numFrameDumpFramesDropped, 1);
+    return;
   }
 
-  m_last_frame_state = AVIDump::FetchState(m_last_xfb_ticks);
-  m_last_frame_exported = true;
+  m_frame_dump_pending_readback.state = AVIDump::FetchState(m_last_xfb_ticks);
   rbtex->CopyFromTexture(m_frame_dump_render_texture.get(), 0, 0);
+  m_frame_dump_pending_readback.texture = std::move(rbtex);
 }
 
-void Renderer::FlushFrameDump()
+std::unique_ptr<AbstractStagingTexture>
+Renderer::GetFrameDumpReadbackTexture(const TextureConfig& config)
 {
-  if (!m_last_frame_exported)
-    return;
+  std::unique_ptr<AbstractStagingTexture> rbtex;
+  {
+    std::unique_lock<std::mutex> lk(m_frame_dump_mutex);
+    if (m_frame_dump_free_textures.empty() &&
+        m_frame_dump_num_readback_textures == MAX_FRAME_DUMP_READBACK_TEXTURES)
+    {
+      // Every texture is queued for encoding, as the previous frame has already been flushed.
+      if (g_ActiveConfig.bFrameDumpsDropFrames)
+        return nullptr;
+
+      m_frame_dump_done_cv.wait(lk, [this] { return !m_frame_dump_free_textures.empty(); });
+    }
+
+    if (!m_frame_dump_free_textures.empty())
+    {
+      rbtex = std::move(m_frame_dump_free_textures.back());
+      m_frame_dump_free_textures.pop_back();
+    }
+  }
 
-  // Ensure the previously-queued frame was encoded.
-  FinishFrameData();
+  if (rbtex && rbtex->GetConfig() == config)
+  {
+    // The encoder is done reading the texture, so it can be unmapped for the next copy.
+    if (rbtex->IsMapped())
+      rbtex->Unmap();
+    return rbtex;
+  }
 
-  // Queue encoding of the last frame dumped.
-  std::unique_ptr<AbstractStagingTexture>& rbtex = m_frame_dump_readback_textures[0];
-  rbtex->Flush();
-  if (rbtex->Map())
+  // Release before creating so we don't temporarily use more RAM when the size changed.
+  if (rbtex)
   {
-    DumpFrameData(reinterpret_cast<u8*>(rbtex->GetMappedPointer()), rbtex->GetConfig().width,
-                  rbtex->GetConfig().height, static_cast<int>(rbtex->GetMappedStride()),
-                  m_last_frame_state);
-    rbtex->Unmap();
+    rbtex.reset();
+    m_frame_dump_num_readback_textures--;
   }
+  rbtex = CreateStagingTexture(StagingTextureType::Readback, config);
+  if (rbtex)
+    m_frame_dump_num_readback_textures++;
+  return rbtex;
+}
 
-  m_last_frame_exported = false;
+void Renderer::FlushFrameDump()
+{
+  if (!m_frame_dump_pending_readback.texture)
+    return;
+
+  // Queue encoding of the last frame dumped. The encoder thread owns the texture until the frame
+  // has been written, so only the copy stays on this thread.
+  FrameDumpReadback readback = std::move(m_frame_dump_pending_readback);
+  readback.texture->Flush();
+  if (readback.texture->Map())
+  {
+    QueueFrameDumpEncode(std::move(readback));
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_mutex);
+    m_frame_dump_free_textures.push_back(std::move(readback.texture));
+  }
 
   // Shutdown frame dumping if it is no longer active.
   if (!IsFrameDumping())
@@ -828,26 +873,29 @@ void Renderer::ShutdownFrameDumping()
   // Ensure the last queued readback has been sent to the encoder.
   FlushFrameDump();
 
-  if (!m_frame_dump_thread_running.IsSet())
-    return;
+  if (m_frame_dump_thread_running.IsSet())
+  {
+    // Ensure all queued frames have been encoded.
+    FinishFrameData();
 
-  // Ensure previous frame has been encoded.
-  FinishFrameData();
+    // Wake thread up, and wait for it to exit.
+    {
+      std::lock_guard<std::mutex> lk(m_frame_dump_mutex);
+      m_frame_dump_thread_running.Clear();
+    }
+    m_frame_dump_queue_cv.notify_one();
+    if (m_frame_dump_thread.joinable())
+      m_frame_dump_thread.join();
+  }
 
-  // Wake thread up, and wait for it to exit.
-  m_frame_dump_thread_running.Clear();
-  m_frame_dump_start.Set();
-  if (m_frame_dump_thread.joinable())
-    m_frame_dump_thread.join();
   m_frame_dump_render_texture.reset();
-  for (auto& tex : m_frame_dump_readback_textures)
-    tex.reset();
+  m_frame_dump_free_textures.clear();
+  m_frame_dump_num_readback_textures = 0;
+  SETSTAT(stats.numFrameDumpFramesPending, 0);
 }
 
-void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state)
+void Renderer::QueueFrameDumpEncode(FrameDumpReadback readback)
 {
-  m_frame_dump_config = FrameDumpConfig{data, w, h, stride, state};
-
   if (!m_frame_dump_thread_running.IsSet())
   {
     if (m_frame_dump_thread.joinable())
@@ -856,18 +904,20 @@ void Renderer::DumpFrameData(const u8* data, int w, int h, int stride, const AVI
     m_frame_dump_thread = std::thread(&Renderer::RunFrameDumps, this);
   }
 
-  // Wake worker thread up.
-  m_frame_dump_start.Set();
-  m_frame_dump_frame_running = true;
+  {
+    std::lock_guard<std::mutex> lk(m_frame_dump_mutex);
+    m_frame_dump_queue.push_back(std::move(readback));
+    // Sampled once per dumped frame, as the stats are only written from this thread.
+    SETSTAT(stats.numFrameDumpFramesPending, m_frame_dump_queue.size());
+  }
+  m_frame_dump_queue_cv.notify_one();
 }
 
 void Renderer::FinishFrameData()
 {
-  if (!m_frame_dump_frame_running)
-    return;
-
-  m_frame_dump_done.Wait();
-  m_frame_dump_frame_running = false;
+  std::unique_lock<std::mutex> lk(m_frame_dump_mutex);
+  m_frame_dump_done_cv.wait(
+      lk, [this] { return m_frame_dump_queue.empty() && !m_frame_dump_encoding; });
 }
 
 void Renderer::RunFrameDumps()
@@ -888,11 +938,27 @@ void Renderer::RunFrameDumps()
 
   while (true)
   {
-    m_frame_dump_start.Wait();
-    if (!m_frame_dump_thread_running.IsSet())
-      break;
+    FrameDumpReadback readback;
+    {
+      std::unique_lock<std::mutex> lk(m_frame_dump_mutex);
+      m_frame_dump_queue_cv.wait(lk, [this] {
+        return !m_frame_dump_queue.empty() || !m_frame_dump_thread_running.IsSet();
+      });
+
+      // Frames which were queued before the thread was told to stop are still written.
+      if (m_frame_dump_queue.empty())
+        break;
+
+      readback = std::move(m_frame_dump_queue.front());
+      m_frame_dump_queue.pop_front();
+      m_frame_dump_encoding = true;
+    }
 
-    auto config = m_frame_dump_config;
+    const AbstractStagingTexture* rbtex = readback.texture.get();
+    const FrameDumpConfig config = {reinterpret_cast<const u8*>(rbtex->GetMappedPointer()),
+                                    static_cast<int>(rbtex->GetConfig().width),
+                                    static_cast<int>(rbtex->GetConfig().height),
+                                    static_cast<int>(rbtex->GetMappedStride()), readback.state};
 
     // Save screenshot
     if (m_screenshot_request.TestAndClear())
@@ -932,7 +998,13 @@ void Renderer::RunFrameDumps()
       }
     }
 
-    m_frame_dump_done.Set();
+    // Return the texture to the pool. It is unmapped on the GPU thread before it is reused.
+    {
+      std::lock_guard<std::mutex> lk(m_frame_dump_mutex);
+      m_frame_dump_free_textures.push_back(std::move(readback.texture));
+      m_frame_dump_encoding = false;
+    }
+    m_frame_dump_done_cv.notify_all();
   }
 
   if (frame_dump_started)
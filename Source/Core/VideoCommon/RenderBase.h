@@ -16,6 +16,7 @@
 
 #include <array>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -258,11 +259,8 @@ private:
 
   // frame dumping
   std::thread m_frame_dump_thread;
-  Common::Event m_frame_dump_start;
-  Common::Event m_frame_dump_done;
   Common::Flag m_frame_dump_thread_running;
   u32 m_frame_dump_image_counter = 0;
-  bool m_frame_dump_frame_running = false;
   struct FrameDumpConfig
   {
     const u8* data;
@@ -270,13 +268,30 @@ private:
     int height;
     int stride;
     AVIDump::Frame state;
-  } m_frame_dump_config;
+  };
+
+  // Frames are read back through a small pool of staging textures. A texture is copied to on the
+  // GPU thread, mapped one frame later, and then owned by the encoder thread until the frame has
+  // been written, so encoding runs in parallel with the following frames.
+  static constexpr u32 MAX_FRAME_DUMP_READBACK_TEXTURES = 4;
+  struct FrameDumpReadback
+  {
+    std::unique_ptr<AbstractStagingTexture> texture;
+    AVIDump::Frame state;
+  };
 
   // Texture used for screenshot/frame dumping
   std::unique_ptr<AbstractTexture> m_frame_dump_render_texture;
-  std::array<std::unique_ptr<AbstractStagingTexture>, 2> m_frame_dump_readback_textures;
-  AVIDump::Frame m_last_frame_state;
-  bool m_last_frame_exported = false;
+  FrameDumpReadback m_frame_dump_pending_readback;
+  u32 m_frame_dump_num_readback_textures = 0;
+
+  // Shared with the encoder thread.
+  std::mutex m_frame_dump_mutex;
+  std::condition_variable m_frame_dump_queue_cv;
+  std::condition_variable m_frame_dump_done_cv;
+  std::deque<FrameDumpReadback> m_frame_dump_queue;
+  std::vector<std::unique_ptr<AbstractStagingTexture>> m_frame_dump_free_textures;
+  bool m_frame_dump_encoding = false;
 
   // Tracking of XFB textures so we don't render duplicate frames.
   AbstractTexture* m_last_xfb_texture = nullptr;
@@ -308,13 +323,17 @@ private:
   // Queues the current frame for readback, which will be written to AVI next frame.
   void QueueFrameDumpReadback();
 
-  // Asynchronously encodes the specified pointer of frame data to the frame dump.
-  void DumpFrameData(const u8* data, int w, int h, int stride, const AVIDump::Frame& state);
+  // Takes a readback texture from the pool. Waits for the encoder to release one if the pool is
+  // exhausted, or returns nullptr if frames may be dropped instead.
+  std::unique_ptr<AbstractStagingTexture> GetFrameDumpReadbackTexture(const TextureConfig& config);
+
+  // Asynchronously encodes the mapped readback texture to the frame dump.
+  void QueueFrameDumpEncode(FrameDumpReadback readback);
 
   // Ensures all rendered frames are queued for encoding.
   void FlushFrameDump();
 
-  // Ensures all encoded frames have been written to the output file.
+  // Ensures all queued frames have been written to the output file.
   void FinishFrameData();
 };
 
@@ -4,12 +4,17 @@
 
 #include "VideoCommon/ShaderCache.h"
 
+#include <limits>
+#include <set>
+#include <vector>
+
 #include "Common/Assert.h"
 #include "Common/FileUtil.h"
 #include "Common/MsgHandler.h"
 #include "Core/ConfigManager.h"
 #include "Core/Host.h"
 
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
@@ -37,6 +42,7 @@ bool ShaderCache::Initialize()
   {
     LoadShaderCaches();
     LoadPipelineUIDCache();
+    LoadPipelineTransitionCache();
   }
 
   // Queue ubershader precompiling if required.
@@ -87,6 +93,13 @@ void ShaderCache::Reload()
 
 void ShaderCache::RetrieveAsyncShaders()
 {
+  // This is called once per frame. A frame which drew everything with specialized pipelines,
+  // and needed a predicted pipeline for that, would have stuttered without the prediction.
+  if (m_frame_used_predicted_pipeline && !m_frame_missed_pipeline)
+    INCSTAT(stats.numStutterFramesAvoided);
+  m_frame_used_predicted_pipeline = false;
+  m_frame_missed_pipeline = false;
+
   m_async_shader_compiler->RetrieveWorkItems();
 }
 
@@ -102,10 +115,15 @@ void ShaderCache::Shutdown()
 
 const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 {
+  TrackGXPipelineTransition(uid);
+
   auto it = m_gx_pipeline_cache.find(uid);
-  if (it != m_gx_pipeline_cache.end() && !it->second.second)
+  const bool ready = it != m_gx_pipeline_cache.end() && !it->second.second;
+  CheckGXPipelinePrediction(uid, ready);
+  if (ready)
     return it->second.first.get();
 
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::ShaderCompilation);
   const bool exists_in_cache = it != m_gx_pipeline_cache.end();
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXPipelineConfig(uid);
@@ -118,16 +136,20 @@ const AbstractPipeline* ShaderCache::GetPipelineForUid(const GXPipelineUid& uid)
 
 std::optional<const AbstractPipeline*> ShaderCache::GetPipelineForUidAsync(const GXPipelineUid& uid)
 {
+  TrackGXPipelineTransition(uid);
+
   auto it = m_gx_pipeline_cache.find(uid);
   if (it != m_gx_pipeline_cache.end())
   {
     // .second is the pending flag, i.e. compiling in the background.
+    CheckGXPipelinePrediction(uid, !it->second.second);
     if (!it->second.second)
       return it->second.first.get();
     else
       return {};
   }
 
+  CheckGXPipelinePrediction(uid, false);
   AppendGXPipelineUID(uid);
   QueuePipelineCompile(uid, COMPILE_PRIORITY_ONDEMAND_PIPELINE);
   return {};
@@ -139,6 +161,7 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
   if (it != m_gx_uber_pipeline_cache.end() && !it->second.second)
     return it->second.first.get();
 
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::ShaderCompilation);
   std::unique_ptr<AbstractPipeline> pipeline;
   std::optional<AbstractPipelineConfig> pipeline_config = GetGXUberPipelineConfig(uid);
   if (pipeline_config)
@@ -148,6 +171,7 @@ const AbstractPipeline* ShaderCache::GetUberPipelineForUid(const GXUberPipelineU
 
 void ShaderCache::WaitForAsyncCompiler()
 {
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::ShaderCompilation);
   while (m_async_shader_compiler->HasPendingWork() || m_async_shader_compiler->HasCompletedWork())
   {
     m_async_shader_compiler->WaitUntilCompletion([](size_t completed, size_t total) {
@@ -207,6 +231,7 @@ static void ClearShaderCache(T& cache)
   cache.disk_cache.Sync();
   cache.disk_cache.Close();
   cache.shader_map.clear();
+  cache.pregenerated_sources.clear();
 }
 
 void ShaderCache::LoadShaderCaches()
@@ -245,6 +270,8 @@ void ShaderCache::ClearShaderCaches()
 
 void ShaderCache::CompileMissingPipelines()
 {
+  PregenerateShaderSources();
+
   // Queue all uids with a null pipeline for compilation.
   for (auto& it : m_gx_pipeline_cache)
   {
@@ -271,12 +298,113 @@ void ShaderCache::InvalidateCachedPipelines()
     it.second.first.reset();
     it.second.second = false;
   }
+
+  // The transitions are still valid, but previous predictions are not.
+  m_predicted_gx_pipelines.clear();
 }
 
 void ShaderCache::ClearPipelineCaches()
 {
   m_gx_pipeline_cache.clear();
   m_gx_uber_pipeline_cache.clear();
+  m_queued_gx_pipelines.clear();
+  m_gx_pipeline_transitions.clear();
+  m_last_gx_pipeline_transition = nullptr;
+  m_predicted_gx_pipelines.clear();
+}
+
+template <typename T, typename Uid, typename Generator>
+void ShaderCache::PregenerateShaderSources(T& cache, const std::set<Uid>& uids,
+                                           Common::WorkerPool& workers,
+                                           const Generator& generator) const
+{
+  const std::vector<Uid> uid_list(uids.begin(), uids.end());
+  std::vector<std::string> sources(uid_list.size());
+  workers.ParallelFor(static_cast<u32>(uid_list.size()), [&](u32 index) {
+    sources[index] = generator(m_api_type, m_host_config, uid_list[index].GetUidData()).GetBuffer();
+  });
+
+  for (size_t i = 0; i < uid_list.size(); i++)
+    cache.pregenerated_sources.emplace(uid_list[i], std::move(sources[i]));
+}
+
+void ShaderCache::PregenerateShaderSources()
+{
+  // The compiler threads generate the source of the shaders they compile. Without them, every
+  // shader is generated and compiled on this thread, so we generate the sources of all missing
+  // shaders on a pool of helper threads up front. Source generation does not touch the GPU.
+  // Geometry shaders are always compiled on this thread, so theirs are generated either way.
+  const u32 num_threads = g_ActiveConfig.GetShaderGenerationThreads();
+  if (num_threads == 0)
+    return;
+
+  const bool generate_all = !m_async_shader_compiler->HasWorkerThreads();
+  std::set<VertexShaderUid> vs_uids;
+  std::set<GeometryShaderUid> gs_uids;
+  std::set<PixelShaderUid> ps_uids;
+  for (const auto& it : m_gx_pipeline_cache)
+  {
+    if (it.second.second || it.second.first)
+      continue;
+    if (NeedsGeometryShader(it.first.gs_uid) && !m_gs_cache.shader_map.count(it.first.gs_uid))
+      gs_uids.insert(it.first.gs_uid);
+    if (!generate_all)
+      continue;
+    if (!m_vs_cache.shader_map.count(it.first.vs_uid))
+      vs_uids.insert(it.first.vs_uid);
+    if (!m_ps_cache.shader_map.count(it.first.ps_uid))
+      ps_uids.insert(it.first.ps_uid);
+  }
+
+  std::set<UberShader::VertexShaderUid> uber_vs_uids;
+  std::set<UberShader::PixelShaderUid> uber_ps_uids;
+  for (const auto& it : m_gx_uber_pipeline_cache)
+  {
+    if (!generate_all)
+      break;
+    if (it.second.second || it.second.first)
+      continue;
+    if (!m_uber_vs_cache.shader_map.count(it.first.vs_uid))
+      uber_vs_uids.insert(it.first.vs_uid);
+    if (!m_uber_ps_cache.shader_map.count(it.first.ps_uid))
+      uber_ps_uids.insert(it.first.ps_uid);
+  }
+
+  if (vs_uids.empty() && gs_uids.empty() && ps_uids.empty() && uber_vs_uids.empty() &&
+      uber_ps_uids.empty())
+  {
+    return;
+  }
+
+  Common::WorkerPool workers;
+  workers.Start(num_threads, "Shader Generation");
+  PregenerateShaderSources(m_vs_cache, vs_uids, workers, GenerateVertexShaderCode);
+  PregenerateShaderSources(m_gs_cache, gs_uids, workers, GenerateGeometryShaderCode);
+  PregenerateShaderSources(m_ps_cache, ps_uids, workers, GeneratePixelShaderCode);
+  PregenerateShaderSources(m_uber_vs_cache, uber_vs_uids, workers, UberShader::GenVertexShader);
+  PregenerateShaderSources(m_uber_ps_cache, uber_ps_uids, workers, UberShader::GenPixelShader);
+  INFO_LOG(VIDEO, "Generated %zu shader sources on %u threads",
+           vs_uids.size() + gs_uids.size() + ps_uids.size() + uber_vs_uids.size() +
+               uber_ps_uids.size(),
+           num_threads + 1);
+}
+
+template <typename T, typename Uid>
+static std::string TakePregeneratedSource(T& cache, const Uid& uid)
+{
+  auto iter = cache.pregenerated_sources.find(uid);
+  if (iter == cache.pregenerated_sources.end())
+    return {};
+
+  std::string source = std::move(iter->second);
+  cache.pregenerated_sources.erase(iter);
+  return source;
+}
+
+static std::unique_ptr<AbstractShader> CompileShaderSource(ShaderStage stage,
+                                                           const std::string& source)
+{
+  return g_renderer->CreateShaderFromSource(stage, source.c_str(), source.size());
 }
 
 std::unique_ptr<AbstractShader> ShaderCache::CompileVertexShader(const VertexShaderUid& uid) const
@@ -399,9 +527,10 @@ const AbstractShader* ShaderCache::InsertPixelUberShader(const UberShader::Pixel
 
 const AbstractShader* ShaderCache::CreateGeometryShader(const GeometryShaderUid& uid)
 {
-  ShaderCode source_code = GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData());
-  std::unique_ptr<AbstractShader> shader = g_renderer->CreateShaderFromSource(
-      ShaderStage::Geometry, source_code.GetBuffer().c_str(), source_code.GetBuffer().size());
+  std::string source = TakePregeneratedSource(m_gs_cache, uid);
+  if (source.empty())
+    source = GenerateGeometryShaderCode(m_api_type, m_host_config, uid.GetUidData()).GetBuffer();
+  std::unique_ptr<AbstractShader> shader = CompileShaderSource(ShaderStage::Geometry, source);
 
   auto& entry = m_gs_cache.shader_map[uid];
   entry.pending = false;
@@ -543,7 +672,7 @@ ShaderCache::InsertGXUberPipeline(const GXUberPipelineUid& config,
 
 void ShaderCache::LoadPipelineUIDCache()
 {
-  constexpr u32 CACHE_FILE_MAGIC = 0x44495550;  // PUID
+  constexpr u32 CACHE_FILE_MAGIC = GX_PIPELINE_UID_CACHE_MAGIC;
   constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
   std::string filename =
       File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".uidcache";
@@ -617,11 +746,11 @@ void ShaderCache::LoadPipelineUIDCache()
 
 void ShaderCache::ClosePipelineUIDCache()
 {
-  // This is left as a method in case we need to append extra data to the file in the future.
   m_gx_pipeline_uid_cache_file.Close();
+  m_gx_pipeline_transition_cache_file.Close();
 }
 
-void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
+static GXPipelineUid DeserializeGXPipelineUID(const SerializedGXPipelineUid& uid)
 {
   GXPipelineUid real_uid = {};
   real_uid.vertex_format = VertexLoaderManager::GetOrCreateMatchingFormat(uid.vertex_decl);
@@ -631,21 +760,11 @@ void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
   real_uid.rasterization_state.hex = uid.rasterization_state_bits;
   real_uid.depth_state.hex = uid.depth_state_bits;
   real_uid.blending_state.hex = uid.blending_state_bits;
-
-  auto iter = m_gx_pipeline_cache.find(real_uid);
-  if (iter != m_gx_pipeline_cache.end())
-    return;
-
-  // Flag it as empty with a null pipeline object, for later compilation.
-  auto& entry = m_gx_pipeline_cache[real_uid];
-  entry.second = false;
+  return real_uid;
 }
 
-void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
+static SerializedGXPipelineUid SerializeGXPipelineUID(const GXPipelineUid& config)
 {
-  if (!m_gx_pipeline_uid_cache_file.IsOpen())
-    return;
-
   // Convert to disk format. Ensure all padding bytes are zero.
   SerializedGXPipelineUid disk_uid;
   std::memset(&disk_uid, 0, sizeof(disk_uid));
@@ -656,6 +775,26 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   disk_uid.rasterization_state_bits = config.rasterization_state.hex;
   disk_uid.depth_state_bits = config.depth_state.hex;
   disk_uid.blending_state_bits = config.blending_state.hex;
+  return disk_uid;
+}
+
+void ShaderCache::AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid)
+{
+  AddGXPipelineUID(DeserializeGXPipelineUID(uid));
+}
+
+void ShaderCache::AddGXPipelineUID(const GXPipelineUid& uid)
+{
+  // Flag it as empty with a null pipeline object, for later compilation.
+  m_gx_pipeline_cache.try_emplace(uid, nullptr, false);
+}
+
+void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
+{
+  if (!m_gx_pipeline_uid_cache_file.IsOpen())
+    return;
+
+  const SerializedGXPipelineUid disk_uid = SerializeGXPipelineUID(config);
   if (!m_gx_pipeline_uid_cache_file.WriteBytes(&disk_uid, sizeof(disk_uid)))
   {
     WARN_LOG(VIDEO, "Writing pipeline UID to cache failed, closing file.");
@@ -663,19 +802,219 @@ void ShaderCache::AppendGXPipelineUID(const GXPipelineUid& config)
   }
 }
 
+void ShaderCache::LoadPipelineTransitionCache()
+{
+  constexpr u32 CACHE_FILE_MAGIC = 0x4E525450;  // PTRN
+  constexpr size_t CACHE_HEADER_SIZE = sizeof(u32) + sizeof(u32);
+  using SerializedTransition = std::array<SerializedGXPipelineUid, 2>;
+  std::string filename =
+      File::GetUserPath(D_CACHE_IDX) + SConfig::GetInstance().GetGameID() + ".transitions";
+  size_t transition_count = 0;
+  if (m_gx_pipeline_transition_cache_file.Open(filename, "rb+"))
+  {
+    u32 existing_magic;
+    u32 existing_version;
+    bool file_valid = false;
+    if (m_gx_pipeline_transition_cache_file.ReadBytes(&existing_magic, sizeof(existing_magic)) &&
+        m_gx_pipeline_transition_cache_file.ReadBytes(&existing_version,
+                                                      sizeof(existing_version)) &&
+        existing_magic == CACHE_FILE_MAGIC && existing_version == GX_PIPELINE_UID_VERSION)
+    {
+      const u64 file_size = m_gx_pipeline_transition_cache_file.GetSize();
+      transition_count =
+          static_cast<size_t>(file_size - CACHE_HEADER_SIZE) / sizeof(SerializedTransition);
+      const size_t expected_size =
+          transition_count * sizeof(SerializedTransition) + CACHE_HEADER_SIZE;
+      file_valid = file_size == expected_size;
+      for (size_t i = 0; file_valid && i < transition_count; i++)
+      {
+        SerializedTransition transition;
+        if (!m_gx_pipeline_transition_cache_file.ReadBytes(transition.data(), sizeof(transition)))
+        {
+          file_valid = false;
+          break;
+        }
+
+        // Both pipelines were used before, so they are precompiled like the UID cache entries.
+        const GXPipelineUid from = DeserializeGXPipelineUID(transition[0]);
+        const GXPipelineUid to = DeserializeGXPipelineUID(transition[1]);
+        AddGXPipelineUID(from);
+        AddGXPipelineUID(to);
+        AddGXPipelineSuccessor(m_gx_pipeline_transitions[from], to);
+      }
+
+      if (file_valid)
+        file_valid = m_gx_pipeline_transition_cache_file.Seek(expected_size, SEEK_SET);
+    }
+
+    if (!file_valid)
+    {
+      m_gx_pipeline_transition_cache_file.Close();
+      transition_count = 0;
+    }
+  }
+
+  if (!m_gx_pipeline_transition_cache_file.IsOpen() &&
+      m_gx_pipeline_transition_cache_file.Open(filename, "wb"))
+  {
+    m_gx_pipeline_transition_cache_file.WriteBytes(&CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+    m_gx_pipeline_transition_cache_file.WriteBytes(&GX_PIPELINE_UID_VERSION,
+                                                   sizeof(GX_PIPELINE_UID_VERSION));
+    for (const auto& it : m_gx_pipeline_transitions)
+    {
+      for (const GXPipelineSuccessor& successor : it.second)
+        AppendGXPipelineTransition(it.first, successor.uid);
+    }
+  }
+
+  INFO_LOG(VIDEO, "Read %u pipeline transitions from %s", static_cast<unsigned>(transition_count),
+           filename.c_str());
+}
+
+void ShaderCache::AppendGXPipelineTransition(const GXPipelineUid& from, const GXPipelineUid& to)
+{
+  if (!m_gx_pipeline_transition_cache_file.IsOpen())
+    return;
+
+  const std::array<SerializedGXPipelineUid, 2> transition = {
+      {SerializeGXPipelineUID(from), SerializeGXPipelineUID(to)}};
+  if (!m_gx_pipeline_transition_cache_file.WriteBytes(transition.data(), sizeof(transition)))
+  {
+    WARN_LOG(VIDEO, "Writing pipeline transition to cache failed, closing file.");
+    m_gx_pipeline_transition_cache_file.Close();
+  }
+}
+
+bool ShaderCache::AddGXPipelineSuccessor(GXPipelineSuccessors& successors,
+                                         const GXPipelineUid& uid)
+{
+  // The list is kept sorted by count, so the likeliest successors are predicted first.
+  for (size_t i = 0; i < successors.size(); i++)
+  {
+    if (successors[i].uid != uid)
+      continue;
+
+    if (successors[i].count == std::numeric_limits<u32>::max())
+    {
+      for (GXPipelineSuccessor& successor : successors)
+        successor.count /= 2;
+    }
+    successors[i].count++;
+    for (; i > 0 && successors[i - 1].count < successors[i].count; i--)
+      std::swap(successors[i - 1], successors[i]);
+    return false;
+  }
+
+  if (successors.size() < MAX_GX_PIPELINE_SUCCESSORS)
+  {
+    successors.push_back({uid, 1});
+    return true;
+  }
+
+  // Replace the least used successor. Replacements are not written to the cache file, which
+  // keeps the file bounded when a pipeline is followed by many different ones.
+  successors.back() = {uid, 1};
+  return false;
+}
+
+const ShaderCache::GXPipelineSuccessors&
+ShaderCache::RecordGXPipelineTransition(const GXPipelineUid& uid)
+{
+  auto& transition = *m_gx_pipeline_transitions.try_emplace(uid).first;
+  if (m_last_gx_pipeline_transition &&
+      AddGXPipelineSuccessor(m_last_gx_pipeline_transition->second, uid))
+  {
+    AppendGXPipelineTransition(m_last_gx_pipeline_transition->first, uid);
+  }
+
+  m_last_gx_pipeline_transition = &transition;
+  return transition.second;
+}
+
+void ShaderCache::TrackGXPipelineTransition(const GXPipelineUid& uid)
+{
+  // The vertex manager looks up the pipeline whenever any of the state it depends on was set,
+  // which mostly results in the pipeline that is already in use.
+  if (m_last_gx_pipeline_transition && m_last_gx_pipeline_transition->first == uid)
+    return;
+
+  PredictGXPipelines(RecordGXPipelineTransition(uid));
+}
+
+void ShaderCache::PredictGXPipelines(const GXPipelineSuccessors& successors)
+{
+  // Without worker threads, queueing a pipeline would compile it right away.
+  if (!m_async_shader_compiler->HasWorkerThreads())
+    return;
+
+  for (const GXPipelineSuccessor& successor : successors)
+  {
+    auto iter = m_gx_pipeline_cache.find(successor.uid);
+    if (iter == m_gx_pipeline_cache.end() || (!iter->second.first && !iter->second.second))
+    {
+      // Not compiled, and not queued either, e.g. after the pipelines were invalidated.
+      QueuePipelineCompile(successor.uid, COMPILE_PRIORITY_PREDICTED_PIPELINE);
+    }
+    else
+    {
+      auto queued_iter = m_queued_gx_pipelines.find(successor.uid);
+      if (queued_iter == m_queued_gx_pipelines.end() ||
+          queued_iter->second.priority <= COMPILE_PRIORITY_PREDICTED_PIPELINE)
+      {
+        continue;
+      }
+
+      // If a worker thread is already compiling it, there is nothing left to do either way.
+      const bool moved = m_async_shader_compiler->SetWorkItemPriority(
+          queued_iter->second.work_item, COMPILE_PRIORITY_PREDICTED_PIPELINE);
+      queued_iter->second.priority = COMPILE_PRIORITY_PREDICTED_PIPELINE;
+      if (!moved)
+        continue;
+    }
+
+    m_predicted_gx_pipelines.insert(successor.uid);
+    INCSTAT(stats.numPipelinesPredicted);
+  }
+}
+
+void ShaderCache::CheckGXPipelinePrediction(const GXPipelineUid& uid, bool ready)
+{
+  if (!ready)
+    m_frame_missed_pipeline = true;
+
+  if (m_predicted_gx_pipelines.empty())
+    return;
+
+  auto iter = m_predicted_gx_pipelines.find(uid);
+  if (iter == m_predicted_gx_pipelines.end())
+    return;
+
+  // Pipelines which were predicted, but are still compiling when needed, count as misses.
+  m_predicted_gx_pipelines.erase(iter);
+  if (ready)
+  {
+    INCSTAT(stats.numPipelinePredictionHits);
+    m_frame_used_predicted_pipeline = true;
+  }
+}
+
 void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority)
 {
   class VertexShaderWorkItem final : public AsyncShaderCompiler::WorkItem
   {
   public:
-    VertexShaderWorkItem(ShaderCache* shader_cache_, const VertexShaderUid& uid_)
-        : shader_cache(shader_cache_), uid(uid_)
+    VertexShaderWorkItem(ShaderCache* shader_cache_, const VertexShaderUid& uid_,
+                         std::string source_)
+        : shader_cache(shader_cache_), uid(uid_), source(std::move(source_))
     {
     }
 
     bool Compile() override
     {
-      shader = shader_cache->CompileVertexShader(uid);
+      if (source.empty())
+        shader = shader_cache->CompileVertexShader(uid);
+      else
+        shader = CompileShaderSource(ShaderStage::Vertex, source);
       return true;
     }
 
@@ -685,10 +1024,12 @@ void ShaderCache::QueueVertexShaderCompile(const VertexShaderUid& uid, u32 prior
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     VertexShaderUid uid;
+    std::string source;
   };
 
   m_vs_cache.shader_map[uid].pending = true;
-  auto wi = m_async_shader_compiler->CreateWorkItem<VertexShaderWorkItem>(this, uid);
+  auto wi = m_async_shader_compiler->CreateWorkItem<VertexShaderWorkItem>(
+      this, uid, TakePregeneratedSource(m_vs_cache, uid));
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
@@ -697,14 +1038,18 @@ void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid
   class VertexUberShaderWorkItem final : public AsyncShaderCompiler::WorkItem
   {
   public:
-    VertexUberShaderWorkItem(ShaderCache* shader_cache_, const UberShader::VertexShaderUid& uid_)
-        : shader_cache(shader_cache_), uid(uid_)
+    VertexUberShaderWorkItem(ShaderCache* shader_cache_, const UberShader::VertexShaderUid& uid_,
+                             std::string source_)
+        : shader_cache(shader_cache_), uid(uid_), source(std::move(source_))
     {
     }
 
     bool Compile() override
     {
-      shader = shader_cache->CompileVertexUberShader(uid);
+      if (source.empty())
+        shader = shader_cache->CompileVertexUberShader(uid);
+      else
+        shader = CompileShaderSource(ShaderStage::Vertex, source);
       return true;
     }
 
@@ -714,10 +1059,12 @@ void ShaderCache::QueueVertexUberShaderCompile(const UberShader::VertexShaderUid
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     UberShader::VertexShaderUid uid;
+    std::string source;
   };
 
   m_uber_vs_cache.shader_map[uid].pending = true;
-  auto wi = m_async_shader_compiler->CreateWorkItem<VertexUberShaderWorkItem>(this, uid);
+  auto wi = m_async_shader_compiler->CreateWorkItem<VertexUberShaderWorkItem>(
+      this, uid, TakePregeneratedSource(m_uber_vs_cache, uid));
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
@@ -726,14 +1073,17 @@ void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priorit
   class PixelShaderWorkItem final : public AsyncShaderCompiler::WorkItem
   {
   public:
-    PixelShaderWorkItem(ShaderCache* shader_cache_, const PixelShaderUid& uid_)
-        : shader_cache(shader_cache_), uid(uid_)
+    PixelShaderWorkItem(ShaderCache* shader_cache_, const PixelShaderUid& uid_, std::string source_)
+        : shader_cache(shader_cache_), uid(uid_), source(std::move(source_))
     {
     }
 
     bool Compile() override
     {
-      shader = shader_cache->CompilePixelShader(uid);
+      if (source.empty())
+        shader = shader_cache->CompilePixelShader(uid);
+      else
+        shader = CompileShaderSource(ShaderStage::Pixel, source);
       return true;
     }
 
@@ -743,10 +1093,12 @@ void ShaderCache::QueuePixelShaderCompile(const PixelShaderUid& uid, u32 priorit
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     PixelShaderUid uid;
+    std::string source;
   };
 
   m_ps_cache.shader_map[uid].pending = true;
-  auto wi = m_async_shader_compiler->CreateWorkItem<PixelShaderWorkItem>(this, uid);
+  auto wi = m_async_shader_compiler->CreateWorkItem<PixelShaderWorkItem>(
+      this, uid, TakePregeneratedSource(m_ps_cache, uid));
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
@@ -755,14 +1107,18 @@ void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid&
   class PixelUberShaderWorkItem final : public AsyncShaderCompiler::WorkItem
   {
   public:
-    PixelUberShaderWorkItem(ShaderCache* shader_cache_, const UberShader::PixelShaderUid& uid_)
-        : shader_cache(shader_cache_), uid(uid_)
+    PixelUberShaderWorkItem(ShaderCache* shader_cache_, const UberShader::PixelShaderUid& uid_,
+                            std::string source_)
+        : shader_cache(shader_cache_), uid(uid_), source(std::move(source_))
     {
     }
 
     bool Compile() override
     {
-      shader = shader_cache->CompilePixelUberShader(uid);
+      if (source.empty())
+        shader = shader_cache->CompilePixelUberShader(uid);
+      else
+        shader = CompileShaderSource(ShaderStage::Pixel, source);
       return true;
     }
 
@@ -772,10 +1128,12 @@ void ShaderCache::QueuePixelUberShaderCompile(const UberShader::PixelShaderUid&
     ShaderCache* shader_cache;
     std::unique_ptr<AbstractShader> shader;
     UberShader::PixelShaderUid uid;
+    std::string source;
   };
 
   m_uber_ps_cache.shader_map[uid].pending = true;
-  auto wi = m_async_shader_compiler->CreateWorkItem<PixelUberShaderWorkItem>(this, uid);
+  auto wi = m_async_shader_compiler->CreateWorkItem<PixelUberShaderWorkItem>(
+      this, uid, TakePregeneratedSource(m_uber_ps_cache, uid));
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
 }
 
@@ -819,6 +1177,14 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
 
     void Retrieve() override
     {
+      // The priority may have been raised by a prediction since this item was queued.
+      auto iter = shader_cache->m_queued_gx_pipelines.find(uid);
+      if (iter != shader_cache->m_queued_gx_pipelines.end() && iter->second.work_item == this)
+      {
+        priority = iter->second.priority;
+        shader_cache->m_queued_gx_pipelines.erase(iter);
+      }
+
       if (stages_ready)
       {
         shader_cache->InsertGXPipeline(uid, std::move(pipeline));
@@ -826,9 +1192,7 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
       else
       {
         // Re-queue for next frame.
-        auto wi = shader_cache->m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(
-            shader_cache, uid, priority);
-        shader_cache->m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
+        shader_cache->QueuePipelineCompile(uid, priority);
       }
     }
 
@@ -842,6 +1206,7 @@ void ShaderCache::QueuePipelineCompile(const GXPipelineUid& uid, u32 priority)
   };
 
   auto wi = m_async_shader_compiler->CreateWorkItem<PipelineWorkItem>(this, uid, priority);
+  m_queued_gx_pipelines[uid] = {wi.get(), priority};
   m_async_shader_compiler->QueueWorkItem(std::move(wi), priority);
   m_gx_pipeline_cache[uid].second = true;
 }
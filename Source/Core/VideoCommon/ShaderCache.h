@@ -10,13 +10,16 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/File.h"
 #include "Common/LinearDiskCache.h"
+#include "Common/WorkerPool.h"
 
 #include "VideoCommon/AbstractPipeline.h"
 #include "VideoCommon/AbstractShader.h"
@@ -73,6 +76,13 @@ private:
   void InvalidateCachedPipelines();
   void ClearPipelineCaches();
   void QueueUberShaderPipelines();
+  // Generates the sources of the shaders of all pipelines which are yet to be compiled on helper
+  // threads. With compiler worker threads, those generate the sources of the vertex and pixel
+  // shaders they compile, so only the geometry shaders are generated up front.
+  void PregenerateShaderSources();
+  template <typename T, typename Uid, typename Generator>
+  void PregenerateShaderSources(T& cache, const std::set<Uid>& uids, Common::WorkerPool& workers,
+                                const Generator& generator) const;
 
   // GX shader compiler methods
   std::unique_ptr<AbstractShader> CompileVertexShader(const VertexShaderUid& uid) const;
@@ -105,8 +115,27 @@ private:
   const AbstractPipeline* InsertGXUberPipeline(const GXUberPipelineUid& config,
                                                std::unique_ptr<AbstractPipeline> pipeline);
   void AddSerializedGXPipelineUID(const SerializedGXPipelineUid& uid);
+  void AddGXPipelineUID(const GXPipelineUid& uid);
   void AppendGXPipelineUID(const GXPipelineUid& config);
 
+  // Pipeline transition tracking. For every pipeline, we remember the pipelines which were most
+  // often used directly after it. When the pipeline changes, the likely successors of the new one
+  // which have not been compiled yet are queued, or moved to the front of the compile queue.
+  struct GXPipelineSuccessor
+  {
+    GXPipelineUid uid;
+    u32 count;
+  };
+  using GXPipelineSuccessors = std::vector<GXPipelineSuccessor>;
+  static constexpr size_t MAX_GX_PIPELINE_SUCCESSORS = 4;
+  void LoadPipelineTransitionCache();
+  void AppendGXPipelineTransition(const GXPipelineUid& from, const GXPipelineUid& to);
+  bool AddGXPipelineSuccessor(GXPipelineSuccessors& successors, const GXPipelineUid& uid);
+  void TrackGXPipelineTransition(const GXPipelineUid& uid);
+  const GXPipelineSuccessors& RecordGXPipelineTransition(const GXPipelineUid& uid);
+  void PredictGXPipelines(const GXPipelineSuccessors& successors);
+  void CheckGXPipelinePrediction(const GXPipelineUid& uid, bool ready);
+
   // ASync Compiler Methods
   void QueueVertexShaderCompile(const VertexShaderUid& uid, u32 priority);
   void QueueVertexUberShaderCompile(const UberShader::VertexShaderUid& uid, u32 priority);
@@ -118,11 +147,13 @@ private:
   // Priorities for compiling. The lower the value, the sooner the pipeline is compiled.
   // The shader cache is compiled last, as it is the least likely to be required. On demand
   // shaders are always compiled before pending ubershaders, as we want to use the ubershader
-  // for as few frames as possible, otherwise we risk framerate drops.
+  // for as few frames as possible, otherwise we risk framerate drops. Pipelines which are likely
+  // to be used next are moved ahead of the rest of the shader cache.
   enum : u32
   {
     COMPILE_PRIORITY_ONDEMAND_PIPELINE = 100,
     COMPILE_PRIORITY_UBERSHADER_PIPELINE = 200,
+    COMPILE_PRIORITY_PREDICTED_PIPELINE = 250,
     COMPILE_PRIORITY_SHADERCACHE_PIPELINE = 300
   };
 
@@ -143,6 +174,8 @@ private:
     };
     std::map<Uid, Shader> shader_map;
     LinearDiskCache<Uid, u8> disk_cache;
+    // Sources generated ahead of time, which are taken when the shader is queued.
+    std::map<Uid, std::string> pregenerated_sources;
   };
   ShaderModuleCache<VertexShaderUid> m_vs_cache;
   ShaderModuleCache<GeometryShaderUid> m_gs_cache;
@@ -155,6 +188,23 @@ private:
   std::map<GXUberPipelineUid, std::pair<std::unique_ptr<AbstractPipeline>, bool>>
       m_gx_uber_pipeline_cache;
   File::IOFile m_gx_pipeline_uid_cache_file;
+
+  // Pipelines which are waiting in the compile queue, with the work item and its priority.
+  struct QueuedGXPipeline
+  {
+    const AsyncShaderCompiler::WorkItem* work_item;
+    u32 priority;
+  };
+  std::map<GXPipelineUid, QueuedGXPipeline> m_queued_gx_pipelines;
+
+  // Transition tracking and prediction state.
+  using GXPipelineTransitionMap = std::map<GXPipelineUid, GXPipelineSuccessors>;
+  GXPipelineTransitionMap m_gx_pipeline_transitions;
+  GXPipelineTransitionMap::value_type* m_last_gx_pipeline_transition = nullptr;
+  std::set<GXPipelineUid> m_predicted_gx_pipelines;
+  File::IOFile m_gx_pipeline_transition_cache_file;
+  bool m_frame_used_predicted_pipeline = false;
+  bool m_frame_missed_pipeline = false;
 };
 
 }  // namespace VideoCommon
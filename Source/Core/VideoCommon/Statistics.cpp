@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "Common/StringUtil.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VideoConfig.h"
@@ -51,22 +52,49 @@ std::string Statistics::ToString()
   str += StringFromFormat("pshaders alive: %i\n", stats.numPixelShadersAlive);
   str += StringFromFormat("vshaders created: %i\n", stats.numVertexShadersCreated);
   str += StringFromFormat("vshaders alive: %i\n", stats.numVertexShadersAlive);
+  str += StringFromFormat("Pipelines predicted: %i\n", stats.numPipelinesPredicted);
+  str += StringFromFormat("Pipeline prediction hits: %i (%i%%)\n", stats.numPipelinePredictionHits,
+                          stats.numPipelinesPredicted ?
+                              stats.numPipelinePredictionHits * 100 / stats.numPipelinesPredicted :
+                              0);
+  str += StringFromFormat("Stutter frames avoided: %i\n", stats.numStutterFramesAvoided);
+  str += StringFromFormat("Frame dump frames pending: %i\n", stats.numFrameDumpFramesPending);
+  str += StringFromFormat("Frame dump frames dropped: %i\n", stats.numFrameDumpFramesDropped);
   str += StringFromFormat("shaders changes: %i\n", stats.thisFrame.numShaderChanges);
   str += StringFromFormat("dlists called: %i\n", stats.thisFrame.numDListsCalled);
+  str += StringFromFormat("dlists replayed: %i\n", stats.thisFrame.numDListsReplayed);
   str += StringFromFormat("Primitive joins: %i\n", stats.thisFrame.numPrimitiveJoins);
   str += StringFromFormat("Draw calls: %i\n", stats.thisFrame.numDrawCalls);
+  str += StringFromFormat("Draw calls saved: %i\n", stats.thisFrame.numDrawsSaved);
   str += StringFromFormat("Primitives: %i\n", stats.thisFrame.numPrims);
   str += StringFromFormat("Primitives (DL): %i\n", stats.thisFrame.numDLPrims);
   str += StringFromFormat("XF loads: %i\n", stats.thisFrame.numXFLoads);
   str += StringFromFormat("XF loads (DL): %i\n", stats.thisFrame.numXFLoadsInDL);
+  str += StringFromFormat("XF loads (redundant): %i\n", stats.thisFrame.numRedundantXFLoads);
   str += StringFromFormat("CP loads: %i\n", stats.thisFrame.numCPLoads);
   str += StringFromFormat("CP loads (DL): %i\n", stats.thisFrame.numCPLoadsInDL);
   str += StringFromFormat("BP loads: %i\n", stats.thisFrame.numBPLoads);
   str += StringFromFormat("BP loads (DL): %i\n", stats.thisFrame.numBPLoadsInDL);
+  str += StringFromFormat("BP loads (deferred): %i\n", stats.thisFrame.numDeferredBPLoads);
   str += StringFromFormat("Vertex streamed: %i kB\n", stats.thisFrame.bytesVertexStreamed / 1024);
   str += StringFromFormat("Index streamed: %i kB\n", stats.thisFrame.bytesIndexStreamed / 1024);
   str += StringFromFormat("Uniform streamed: %i kB\n", stats.thisFrame.bytesUniformStreamed / 1024);
   str += StringFromFormat("Vertex Loaders: %i\n", stats.numVertexLoaders);
+  str += StringFromFormat("CPU stalled on GPU: %i us\n", stats.thisFrame.microsecondsCPUStalled);
+  str += StringFromFormat("GPU idle: %i us\n", stats.thisFrame.microsecondsGPUIdle);
+  str += StringFromFormat("GPU wakeups: %i\n", stats.thisFrame.numGPUWakeups);
+  str += StringFromFormat("GPU wakeups batched: %i\n", stats.thisFrame.numGPUWakeupsBatched);
+  str += StringFromFormat("EFB copies deferred: %i\n", stats.thisFrame.numEFBCopiesDeferred);
+  str += StringFromFormat("EFB copy syncs avoided: %i\n", stats.thisFrame.numEFBCopySyncsAvoided);
+  if (FrameProfiler::g_enabled)
+  {
+    for (u32 i = 0; i < static_cast<u32>(FrameProfiler::Section::NumSections); i++)
+    {
+      const auto section = static_cast<FrameProfiler::Section>(i);
+      str += StringFromFormat("%s time: %.0f us\n", FrameProfiler::GetSectionName(section),
+                              FrameProfiler::GetLastFrameTime(section));
+    }
+  }
 
   std::string vertex_list = VertexLoaderManager::VertexLoadersToString();
 
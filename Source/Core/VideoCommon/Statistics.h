@@ -19,6 +19,14 @@ struct Statistics
 
   int numVertexLoaders;
 
+  int numPipelinesPredicted;
+  int numPipelinePredictionHits;
+  int numStutterFramesAvoided;
+
+  // Frames waiting for the encoder thread.
+  int numFrameDumpFramesPending;
+  int numFrameDumpFramesDropped;
+
   float proj_0, proj_1, proj_2, proj_3, proj_4, proj_5;
   float gproj_0, gproj_1, gproj_2, gproj_3, gproj_4, gproj_5;
   float gproj_6, gproj_7, gproj_8, gproj_9, gproj_10, gproj_11, gproj_12, gproj_13, gproj_14,
@@ -44,8 +52,12 @@ struct Statistics
 
     int numPrimitiveJoins;
     int numDrawCalls;
+    int numDrawsSaved;
+    int numDeferredBPLoads;
+    int numRedundantXFLoads;
 
     int numDListsCalled;
+    int numDListsReplayed;
 
     int bytesVertexStreamed;
     int bytesIndexStreamed;
@@ -61,6 +73,14 @@ struct Statistics
     int numVerticesLoaded;
     int tevPixelsIn;
     int tevPixelsOut;
+
+    int microsecondsCPUStalled;
+    int microsecondsGPUIdle;
+    int numGPUWakeups;
+    int numGPUWakeupsBatched;
+
+    int numEFBCopiesDeferred;
+    int numEFBCopySyncsAvoided;
   };
   ThisFrame thisFrame;
   void ResetFrame();
@@ -8,9 +8,11 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #if defined(_M_X86) || defined(_M_X86_64)
 #include <pmmintrin.h>
 #endif
+#include <xxhash.h>
 
 #include "Common/Align.h"
 #include "Common/Assert.h"
@@ -30,6 +32,7 @@
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/Debugger.h"
 #include "VideoCommon/FramebufferManagerBase.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/HiresTextures.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
@@ -43,9 +46,22 @@ static const u64 TEXHASH_INVALID = 0;
 // Sonic the Fighters (inside Sonic Gems Collection) loops a 64 frames animation
 static const int TEXTURE_KILL_THRESHOLD = 64;
 static const int TEXTURE_POOL_KILL_THRESHOLD = 3;
+// Decoded size (all levels, in bytes) from which textures are decoded on multiple threads.
+// Below this, handing the work to other threads costs more than it saves.
+static const size_t PARALLEL_DECODE_THRESHOLD = 256 * 256 * 4;
+// Readback textures kept for deferred EFB copies. Games usually make the same few copies every
+// frame, so this only has to cover one frame's worth of distinct copy sizes.
+static const size_t MAX_EFB_COPY_STAGING_TEXTURES = 32;
 
 std::unique_ptr<TextureCacheBase> g_texture_cache;
 
+static u64 GetTextureHash(const u8* src, u32 len, u32 samples)
+{
+  if (samples == 0 && g_ActiveConfig.texture_hash_function == TextureHashFunction::XXH64)
+    return XXH64(src, len, 0);
+  return GetHash64(src, len, samples);
+}
+
 std::bitset<8> TextureCacheBase::valid_bind_points;
 
 TextureCacheBase::TCacheEntry::TCacheEntry(std::unique_ptr<AbstractTexture> tex)
@@ -83,11 +99,16 @@ TextureCacheBase::TextureCacheBase()
 
   SetHash64Function();
 
+  m_decode_workers.Start(backup_config.texture_decoding_threads, "Texture Decoding");
+
   InvalidateAllBindPoints();
 }
 
 void TextureCacheBase::Invalidate()
 {
+  FlushEFBCopies();
+  m_efb_copy_staging_pool.clear();
+
   InvalidateAllBindPoints();
   for (size_t i = 0; i < bound_textures.size(); ++i)
   {
@@ -100,6 +121,7 @@ void TextureCacheBase::Invalidate()
   }
   textures_by_address.clear();
   textures_by_hash.clear();
+  m_tracked_hashes.clear();
 
   texture_pool.clear();
 }
@@ -107,6 +129,8 @@ void TextureCacheBase::Invalidate()
 TextureCacheBase::~TextureCacheBase()
 {
   HiresTexture::Shutdown();
+  // Emulated memory may already be gone, so copies which are still pending are dropped.
+  m_pending_efb_copies.Discard();
   Invalidate();
   Common::FreeAlignedMemory(temp);
   temp = nullptr;
@@ -125,7 +149,8 @@ void TextureCacheBase::OnConfigChanged(VideoConfig& config)
       config.bTexFmtOverlayEnable != backup_config.texfmt_overlay ||
       config.bTexFmtOverlayCenter != backup_config.texfmt_overlay_center ||
       config.bHiresTextures != backup_config.hires_textures ||
-      config.bEnableGPUTextureDecoding != backup_config.gpu_texture_decoding)
+      config.bEnableGPUTextureDecoding != backup_config.gpu_texture_decoding ||
+      config.texture_hash_function != backup_config.texture_hash_function)
   {
     Invalidate();
 
@@ -141,6 +166,9 @@ void TextureCacheBase::OnConfigChanged(VideoConfig& config)
       PanicAlert("Failed to recompile one or more texture conversion shaders.");
   }
 
+  if (config.GetTextureDecodingThreads() != backup_config.texture_decoding_threads)
+    m_decode_workers.Start(config.GetTextureDecodingThreads(), "Texture Decoding");
+
   SetBackupConfig(config);
 }
 
@@ -205,6 +233,24 @@ void TextureCacheBase::Cleanup(int _frameCount)
       ++iter2;
     }
   }
+
+  // Forget hashes which were not looked up since the last sweep, or which are stale anyway.
+  if (_frameCount % TEXTURE_KILL_THRESHOLD == 0)
+  {
+    for (auto iter3 = m_tracked_hashes.begin(); iter3 != m_tracked_hashes.end();)
+    {
+      if (!iter3->second.used ||
+          Memory::WasWrittenSince(iter3->first, iter3->second.size, iter3->second.write_stamp))
+      {
+        iter3 = m_tracked_hashes.erase(iter3);
+      }
+      else
+      {
+        iter3->second.used = false;
+        ++iter3;
+      }
+    }
+  }
 }
 
 bool TextureCacheBase::TCacheEntry::OverlapsMemoryRange(u32 range_address, u32 range_size) const
@@ -228,6 +274,32 @@ void TextureCacheBase::SetBackupConfig(const VideoConfig& config)
   backup_config.stereo_3d = config.stereo_mode != StereoMode::Off;
   backup_config.efb_mono_depth = config.bStereoEFBMonoDepth;
   backup_config.gpu_texture_decoding = config.bEnableGPUTextureDecoding;
+  backup_config.texture_decoding_threads = config.GetTextureDecodingThreads();
+  backup_config.texture_hash_function = config.texture_hash_function;
+}
+
+u64 TextureCacheBase::GetTrackedTextureHash(u32 address, const u8* src, u32 size, int samples)
+{
+  if (!g_ActiveConfig.bTextureWriteTracking || !Memory::IsWriteTrackingEnabled())
+    return GetTextureHash(src, size, samples);
+
+  auto iter = m_tracked_hashes.find(address);
+  if (iter != m_tracked_hashes.end() && iter->second.size == size &&
+      iter->second.samples == samples &&
+      !Memory::WasWrittenSince(address, size, iter->second.write_stamp))
+  {
+    iter->second.used = true;
+    return iter->second.hash;
+  }
+
+  // Tracking has to start before hashing, so that no write can slip in between the two.
+  TrackedHash& tracked = m_tracked_hashes[address];
+  tracked.size = size;
+  tracked.samples = samples;
+  tracked.used = true;
+  tracked.write_stamp = Memory::TrackWrites(address, size);
+  tracked.hash = GetTextureHash(src, size, samples);
+  return tracked.hash;
 }
 
 TextureCacheBase::TCacheEntry*
@@ -626,6 +698,8 @@ TextureCacheBase::TCacheEntry* TextureCacheBase::Load(const u32 stage)
     return bound_textures[stage];
   }
 
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::TextureCache);
+
   const FourTexUnits& tex = bpmem.tex[stage >> 2];
   const u32 id = stage & 3;
   const u32 address = (tex.texImage3[id].image_base /* & 0x1FFFFF*/) << 5;
@@ -723,6 +797,9 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
     return nullptr;
   }
 
+  if (!from_tmem)
+    FlushEFBCopiesInRange(address, texture_size + additional_mips_size);
+
   // If we are recording a FifoLog, keep track of what memory we read. FifoRecorder does
   // its own memory modification tracking independent of the texture hashing below.
   if (g_bRecordFifoData && !from_tmem)
@@ -731,13 +808,18 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  base_hash = GetHash64(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  if (from_tmem)
+    base_hash = GetTextureHash(src_data, texture_size, textureCacheSafetyColorSampleSize);
+  else
+    base_hash =
+        GetTrackedTextureHash(address, src_data, texture_size, textureCacheSafetyColorSampleSize);
   u32 palette_size = 0;
   if (isPaletteTexture)
   {
     palette_size = TexDecoder_GetPaletteSize(texformat);
     full_hash =
-        base_hash ^ GetHash64(&texMem[tlutaddr], palette_size, textureCacheSafetyColorSampleSize);
+        base_hash ^
+        GetTextureHash(&texMem[tlutaddr], palette_size, textureCacheSafetyColorSampleSize);
   }
   else
   {
@@ -961,6 +1043,8 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
   // Initialized to null because only software loading uses this buffer
   u8* dst_buffer = nullptr;
+  // Whether all levels were already decoded up front by the decoding workers.
+  bool levels_predecoded = false;
 
   if (!hires_tex)
   {
@@ -993,7 +1077,18 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
 
       CheckTempSize(total_texture_size);
       dst_buffer = temp;
-      if (!(texformat == TextureFormat::RGBA8 && from_tmem))
+      // RGBA8 textures in TMEM are split across both banks, so they keep the serial path.
+      levels_predecoded = !(texformat == TextureFormat::RGBA8 && from_tmem) &&
+                          m_decode_workers.GetThreadCount() != 0 &&
+                          total_texture_size >= PARALLEL_DECODE_THRESHOLD;
+      if (levels_predecoded)
+      {
+        DecodeTextureLevelsInParallel(dst_buffer, src_data,
+                                      from_tmem ? &texMem[tmem_address_odd] : nullptr,
+                                      expandedWidth, expandedHeight, tex_levels, texformat, tlut,
+                                      tlutfmt);
+      }
+      else if (!(texformat == TextureFormat::RGBA8 && from_tmem))
       {
         TexDecoder_Decode(dst_buffer, src_data, expandedWidth, expandedHeight, texformat, tlut,
                           tlutfmt);
@@ -1078,8 +1173,11 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
       {
         // No need to call CheckTempSize here, as the whole buffer is preallocated at the beginning
         size_t decoded_mip_size = expanded_mip_width * sizeof(u32) * expanded_mip_height;
-        TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
-                          texformat, tlut, tlutfmt);
+        if (!levels_predecoded)
+        {
+          TexDecoder_Decode(dst_buffer, mip_src_data, expanded_mip_width, expanded_mip_height,
+                            texformat, tlut, tlutfmt);
+        }
         entry->texture->Load(level, mip_width, mip_height, expanded_mip_width, dst_buffer,
                              decoded_mip_size);
 
@@ -1111,6 +1209,66 @@ TextureCacheBase::GetTexture(u32 address, u32 width, u32 height, const TextureFo
   return entry;
 }
 
+void TextureCacheBase::DecodeTextureLevelsInParallel(u8* dst, const u8* src, const u8* odd_src,
+                                                     u32 width, u32 height, u32 levels,
+                                                     TextureFormat texformat, const u8* tlut,
+                                                     TLUTFormat tlutfmt)
+{
+  struct DecodeJob
+  {
+    u8* dst;
+    const u8* src;
+    u32 width;
+    u32 first_block_row;
+    u32 num_block_rows;
+  };
+  struct DecodedLevel
+  {
+    u8* dst;
+    u32 width;
+    u32 height;
+  };
+
+  const u32 bsw = TexDecoder_GetBlockWidthInTexels(texformat);
+  const u32 bsh = TexDecoder_GetBlockHeightInTexels(texformat);
+  const u32 max_bands = m_decode_workers.GetThreadCount() + 1;
+
+  std::vector<DecodeJob> jobs;
+  std::vector<DecodedLevel> decoded_levels;
+  for (u32 level = 0; level < levels; ++level)
+  {
+    const u32 expanded_width = Common::AlignUp(CalculateLevelSize(width, level), bsw);
+    const u32 expanded_height = Common::AlignUp(CalculateLevelSize(height, level), bsh);
+    const size_t decoded_size = expanded_width * sizeof(u32) * expanded_height;
+    // Mips from TMEM alternate between the even and odd banks, like in GetTexture.
+    const u8*& level_src = (odd_src && level % 2) ? odd_src : src;
+
+    // Only split levels which are large by themselves, the smaller mips are one job each.
+    const u32 block_rows = expanded_height / bsh;
+    const u32 bands =
+        decoded_size >= PARALLEL_DECODE_THRESHOLD / 2 ? std::min(block_rows, max_bands) : 1;
+    const u32 rows_per_band = (block_rows + bands - 1) / bands;
+    for (u32 row = 0; row < block_rows; row += rows_per_band)
+    {
+      jobs.push_back(
+          {dst, level_src, expanded_width, row, std::min(rows_per_band, block_rows - row)});
+    }
+
+    decoded_levels.push_back({dst, expanded_width, expanded_height});
+    dst += decoded_size;
+    level_src += TexDecoder_GetTextureSizeInBytes(expanded_width, expanded_height, texformat);
+  }
+
+  m_decode_workers.ParallelFor(static_cast<u32>(jobs.size()), [&](u32 index) {
+    const DecodeJob& job = jobs[index];
+    TexDecoder_DecodeBlockRows(job.dst, job.src, job.width, job.first_block_row,
+                               job.num_block_rows, texformat, tlut, tlutfmt);
+  });
+
+  for (const DecodedLevel& level : decoded_levels)
+    TexDecoder_DrawFormatOverlay(level.dst, level.width, level.height, texformat);
+}
+
 TextureCacheBase::TCacheEntry*
 TextureCacheBase::GetXFBTexture(u32 address, u32 width, u32 height, TextureFormat tex_format,
                                 int texture_cache_safety_color_sample_size)
@@ -1223,8 +1381,17 @@ std::optional<TextureLookupInformation> TextureCacheBase::ComputeTextureInformat
 
   // TODO: This doesn't hash GB tiles for preloaded RGBA8 textures (instead, it's hashing more data
   // from the low tmem bank than it should)
-  tex_info.base_hash = GetHash64(tex_info.src_data, tex_info.total_bytes,
-                                 tex_info.texture_cache_safety_color_sample_size);
+  if (tex_info.from_tmem)
+  {
+    tex_info.base_hash = GetTextureHash(tex_info.src_data, tex_info.total_bytes,
+                                        tex_info.texture_cache_safety_color_sample_size);
+  }
+  else
+  {
+    tex_info.base_hash =
+        GetTrackedTextureHash(tex_info.address, tex_info.src_data, tex_info.total_bytes,
+                              tex_info.texture_cache_safety_color_sample_size);
+  }
 
   tex_info.is_palette_texture = IsColorIndexed(tex_format);
 
@@ -1232,8 +1399,8 @@ std::optional<TextureLookupInformation> TextureCacheBase::ComputeTextureInformat
   {
     tex_info.palette_size = TexDecoder_GetPaletteSize(tex_format);
     tex_info.full_hash =
-        tex_info.base_hash ^ GetHash64(&texMem[tex_info.tlut_address], tex_info.palette_size,
-                                       tex_info.texture_cache_safety_color_sample_size);
+        tex_info.base_hash ^ GetTextureHash(&texMem[tex_info.tlut_address], tex_info.palette_size,
+                                            tex_info.texture_cache_safety_color_sample_size);
   }
   else
   {
@@ -1619,11 +1786,31 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, EFBCopyFormat dstF
   const u32 bytes_per_row = num_blocks_x * bytes_per_block;
   const u32 covered_range = num_blocks_y * dstStride;
 
+  // An earlier deferred copy to the same memory has to be written first.
+  FlushEFBCopiesInRange(dstAddr, std::max(covered_range, bytes_per_row));
+
+  PendingEFBCopies::Copy* pending_copy = nullptr;
   if (copy_to_ram)
   {
     PEControl::PixelFormat srcFormat = bpmem.zcontrol.pixel_format;
     EFBCopyParams format(srcFormat, dstFormat, is_depth_copy, isIntensity, y_scale);
-    CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, srcRect, scaleByHalf);
+    std::unique_ptr<AbstractStagingTexture> staging_texture;
+    if (g_ActiveConfig.bDeferEFBCopies && num_blocks_y != 0)
+    {
+      staging_texture = CopyEFBToStagingTexture(format, tex_w, bytes_per_row, num_blocks_y,
+                                                srcRect, scaleByHalf);
+    }
+
+    if (staging_texture)
+    {
+      pending_copy = &m_pending_efb_copies.Add(
+          {dstAddr, bytes_per_row, num_blocks_y, dstStride, false, 0, std::move(staging_texture)});
+      INCSTAT(stats.thisFrame.numEFBCopiesDeferred);
+    }
+    else
+    {
+      CopyEFB(dst, format, tex_w, bytes_per_row, num_blocks_y, dstStride, srcRect, scaleByHalf);
+    }
   }
   else
   {
@@ -1762,6 +1949,13 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, EFBCopyFormat dstF
       u64 hash = entry->CalculateHash();
       entry->SetHashes(hash, hash);
 
+      // The hash is updated again once the deferred copy has been written to RAM.
+      if (pending_copy)
+      {
+        pending_copy->has_entry = true;
+        pending_copy->entry_id = entry->id;
+      }
+
       if (g_ActiveConfig.bDumpEFBTarget && !is_xfb_copy)
       {
         static int efb_count = 0;
@@ -1785,6 +1979,80 @@ void TextureCacheBase::CopyRenderTargetToTexture(u32 dstAddr, EFBCopyFormat dstF
   }
 }
 
+void TextureCacheBase::FlushEFBCopies()
+{
+  if (m_pending_efb_copies.IsEmpty())
+    return;
+
+  // Only the first readback waits for the GPU, the later ones have finished by then.
+  ADDSTAT(stats.thisFrame.numEFBCopySyncsAvoided,
+          static_cast<int>(m_pending_efb_copies.GetCount()) - 1);
+  RecycleEFBCopyStagingTextures(m_pending_efb_copies.Flush(
+      [this](const PendingEFBCopies::Copy& copy) { WriteEFBCopyToRAM(copy); }));
+}
+
+void TextureCacheBase::FlushEFBCopiesInRange(u32 address, u32 size)
+{
+  if (m_pending_efb_copies.Overlaps(address, size))
+    FlushEFBCopies();
+}
+
+void TextureCacheBase::DiscardEFBCopies()
+{
+  RecycleEFBCopyStagingTextures(m_pending_efb_copies.Discard());
+}
+
+void TextureCacheBase::RecycleEFBCopyStagingTextures(PendingEFBCopies::StagingTextures textures)
+{
+  for (auto& texture : textures)
+  {
+    const TextureConfig config = texture->GetConfig();
+    m_efb_copy_staging_pool.emplace(config, std::move(texture));
+  }
+
+  while (m_efb_copy_staging_pool.size() > MAX_EFB_COPY_STAGING_TEXTURES)
+    m_efb_copy_staging_pool.erase(m_efb_copy_staging_pool.begin());
+}
+
+void TextureCacheBase::WriteEFBCopyToRAM(const PendingEFBCopies::Copy& copy)
+{
+  u8* dst = Memory::GetPointer(copy.dst_addr);
+  const MathUtil::Rectangle<int> rect(0, 0, copy.bytes_per_row / sizeof(u32), copy.num_blocks_y);
+  copy.texture->ReadTexels(rect, dst, copy.memory_stride);
+
+  // Cache entries which depend on the copied memory were hashed before the data arrived, see
+  // CopyRenderTargetToTexture.
+  const u32 covered_range = copy.num_blocks_y * copy.memory_stride;
+  auto iter = FindOverlappingTextures(copy.dst_addr, covered_range);
+  for (; iter.first != iter.second; ++iter.first)
+  {
+    TCacheEntry* entry = iter.first->second;
+    if (copy.has_entry && entry->id == copy.entry_id)
+    {
+      const u64 hash = entry->CalculateHash();
+      entry->SetHashes(hash, hash);
+    }
+    else if (entry->is_xfb_copy && entry->OverlapsMemoryRange(copy.dst_addr, covered_range))
+    {
+      entry->hash = entry->CalculateHash();
+    }
+  }
+}
+
+std::unique_ptr<AbstractStagingTexture>
+TextureCacheBase::AllocateEFBCopyStagingTexture(const TextureConfig& config)
+{
+  auto iter = m_efb_copy_staging_pool.find(config);
+  if (iter != m_efb_copy_staging_pool.end())
+  {
+    std::unique_ptr<AbstractStagingTexture> texture = std::move(iter->second);
+    m_efb_copy_staging_pool.erase(iter);
+    return texture;
+  }
+
+  return g_renderer->CreateStagingTexture(StagingTextureType::Readback, config);
+}
+
 void TextureCacheBase::UninitializeXFBMemory(u8* dst, u32 stride, u32 bytes_per_row,
                                              u32 num_blocks_y)
 {
@@ -2010,7 +2278,7 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
   u8* ptr = Memory::GetPointer(addr);
   if (memory_stride == BytesPerRow())
   {
-    return GetHash64(ptr, size_in_bytes, HashSampleSize());
+    return GetTextureHash(ptr, size_in_bytes, HashSampleSize());
   }
   else
   {
@@ -2029,7 +2297,7 @@ u64 TextureCacheBase::TCacheEntry::CalculateHash() const
     {
       // Multiply by a prime number to mix the hash up a bit. This prevents identical blocks from
       // canceling each other out
-      temp_hash = (temp_hash * 397) ^ GetHash64(ptr, BytesPerRow(), samples_per_row);
+      temp_hash = (temp_hash * 397) ^ GetTextureHash(ptr, BytesPerRow(), samples_per_row);
       ptr += memory_stride;
     }
     return temp_hash;
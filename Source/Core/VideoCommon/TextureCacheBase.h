@@ -13,14 +13,19 @@
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
+#include "VideoCommon/AbstractStagingTexture.h"
 #include "VideoCommon/AbstractTexture.h"
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/PendingEFBCopies.h"
 #include "VideoCommon/TextureConfig.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VideoCommon.h"
 
+enum class TextureHashFunction : int;
 struct VideoConfig;
 
 struct TextureAndTLUTFormat
@@ -218,6 +223,24 @@ public:
                        u32 num_blocks_y, u32 memory_stride, const EFBRectangle& src_rect,
                        bool scale_by_half) = 0;
 
+  // Encodes an EFB copy like CopyEFB, but only starts the readback into a staging texture of
+  // bytes_per_row / 4 by num_blocks_y texels, without waiting for the GPU. Returns nullptr if
+  // the backend can only write EFB copies to RAM immediately.
+  virtual std::unique_ptr<AbstractStagingTexture>
+  CopyEFBToStagingTexture(const EFBCopyParams& params, u32 native_width, u32 bytes_per_row,
+                          u32 num_blocks_y, const EFBRectangle& src_rect, bool scale_by_half)
+  {
+    return nullptr;
+  }
+
+  // Writes all deferred EFB copies to RAM. This waits for the GPU once for the whole batch.
+  void FlushEFBCopies();
+  // Only flushes if a deferred EFB copy overlaps the range. As copies have to reach RAM in the
+  // order they were made, any overlap flushes all of them.
+  void FlushEFBCopiesInRange(u32 address, u32 size);
+  // Drops deferred EFB copies without writing them, when RAM is replaced by a savestate.
+  void DiscardEFBCopies();
+
   virtual bool CompileShaders() = 0;
   virtual void DeleteShaders() = 0;
 
@@ -275,6 +298,11 @@ public:
 protected:
   TextureCacheBase();
 
+  // Returns a readback texture for CopyEFBToStagingTexture, reusing one of a previous copy if
+  // possible.
+  std::unique_ptr<AbstractStagingTexture>
+  AllocateEFBCopyStagingTexture(const TextureConfig& config);
+
   alignas(16) u8* temp = nullptr;
   size_t temp_size = 0;
 
@@ -303,6 +331,17 @@ private:
   void DumpTexture(TCacheEntry* entry, std::string basename, unsigned int level, bool is_arbitrary);
   void CheckTempSize(size_t required_size);
 
+  // Decodes all levels of a texture into dst, laid out like the serial path in GetTexture.
+  // Large levels are split into bands of block rows, and every band is a job on the workers.
+  // For textures in TMEM, odd_src is where the odd levels start, otherwise it is null.
+  void DecodeTextureLevelsInParallel(u8* dst, const u8* src, const u8* odd_src, u32 width,
+                                     u32 height, u32 levels, TextureFormat texformat,
+                                     const u8* tlut, TLUTFormat tlutfmt);
+
+  // Hashes texture memory, or returns the previous hash if write tracking shows that the memory
+  // has not been written since.
+  u64 GetTrackedTextureHash(u32 address, const u8* src, u32 size, int samples);
+
   TCacheEntry* AllocateCacheEntry(const TextureConfig& config);
   std::unique_ptr<AbstractTexture> AllocateTexture(const TextureConfig& config);
   TexPool::iterator FindMatchingTextureFromPool(const TextureConfig& config);
@@ -322,11 +361,31 @@ private:
 
   void UninitializeXFBMemory(u8* dst, u32 stride, u32 bytes_per_row, u32 num_blocks_y);
 
+  void WriteEFBCopyToRAM(const PendingEFBCopies::Copy& copy);
+  void RecycleEFBCopyStagingTextures(PendingEFBCopies::StagingTextures textures);
+
   TexAddrCache textures_by_address;
   TexHashCache textures_by_hash;
   TexPool texture_pool;
   u64 last_entry_id = 0;
 
+  Common::WorkerPool m_decode_workers;
+
+  struct TrackedHash
+  {
+    u32 size;
+    int samples;
+    u64 write_stamp;
+    u64 hash;
+    // Whether the hash was looked up since the last sweep in Cleanup.
+    bool used;
+  };
+  std::unordered_map<u32, TrackedHash> m_tracked_hashes;
+
+  PendingEFBCopies m_pending_efb_copies;
+  std::unordered_multimap<TextureConfig, std::unique_ptr<AbstractStagingTexture>>
+      m_efb_copy_staging_pool;
+
   // Backup configuration values
   struct BackupConfig
   {
@@ -339,6 +398,8 @@ private:
     bool stereo_3d;
     bool efb_mono_depth;
     bool gpu_texture_decoding;
+    u32 texture_decoding_threads;
+    TextureHashFunction texture_hash_function;
   };
   BackupConfig backup_config = {};
 };
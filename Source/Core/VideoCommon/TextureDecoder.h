@@ -110,6 +110,13 @@ TextureFormat TexDecoder_GetEFBCopyBaseFormat(EFBCopyFormat format);
 
 void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFormat texformat,
                        const u8* tlut, TLUTFormat tlutfmt);
+// Decodes only the given range of block rows of a texture, which allows splitting the work
+// across threads. Unlike TexDecoder_Decode, this doesn't draw the format overlay; call
+// TexDecoder_DrawFormatOverlay once the whole texture has been decoded.
+void TexDecoder_DecodeBlockRows(u8* dst, const u8* src, int width, int first_block_row,
+                                int num_block_rows, TextureFormat texformat, const u8* tlut,
+                                TLUTFormat tlutfmt);
+void TexDecoder_DrawFormatOverlay(u8* dst, int width, int height, TextureFormat texformat);
 void TexDecoder_DecodeRGBA8FromTmem(u8* dst, const u8* src_ar, const u8* src_gb, int width,
                                     int height);
 void TexDecoder_DecodeTexel(u8* dst, const u8* src, int s, int t, int imageWidth,
@@ -122,3 +129,6 @@ void TexDecoder_SetTexFmtOverlayOptions(bool enable, bool center);
 /* Internal method, implemented by TextureDecoder_Generic and TextureDecoder_x64. */
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt);
+// The portable decoder, which _TexDecoder_DecodeImpl uses on platforms without a specialized one.
+void TexDecoder_DecodeImplGeneric(u32* dst, const u8* src, int width, int height,
+                                  TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt);
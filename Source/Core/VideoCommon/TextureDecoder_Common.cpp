@@ -380,6 +380,29 @@ void TexDecoder_Decode(u8* dst, const u8* src, int width, int height, TextureFor
     TexDecoder_DrawOverlay(dst, width, height, texformat);
 }
 
+void TexDecoder_DecodeBlockRows(u8* dst, const u8* src, int width, int first_block_row,
+                                int num_block_rows, TextureFormat texformat, const u8* tlut,
+                                TLUTFormat tlutfmt)
+{
+  // Blocks are stored row by row, so a band of block rows is just a smaller texture.
+  const int block_width = TexDecoder_GetBlockWidthInTexels(texformat);
+  const int block_height = TexDecoder_GetBlockHeightInTexels(texformat);
+  const int texel_nibbles = TexDecoder_GetTexelSizeInNibbles(texformat);
+  const size_t block_size = static_cast<size_t>(block_width * block_height * texel_nibbles / 2);
+  const size_t src_row_size = static_cast<size_t>(width / block_width) * block_size;
+  const size_t dst_row_size = static_cast<size_t>(width) * block_height * sizeof(u32);
+
+  _TexDecoder_DecodeImpl(reinterpret_cast<u32*>(dst + first_block_row * dst_row_size),
+                         src + first_block_row * src_row_size, width, num_block_rows * block_height,
+                         texformat, tlut, tlutfmt);
+}
+
+void TexDecoder_DrawFormatOverlay(u8* dst, int width, int height, TextureFormat texformat)
+{
+  if (TexFmt_Overlay_Enable)
+    TexDecoder_DrawOverlay(dst, width, height, texformat);
+}
+
 static inline u32 DecodePixel_IA8(u16 val)
 {
   int a = val & 0xFF;
@@ -7,6 +7,8 @@
 
 #include "Common/CPUDetect.h"
 #include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "Common/MsgHandler.h"
 #include "Common/Swap.h"
 
 #include "VideoCommon/LookUpTables.h"
@@ -195,8 +197,8 @@ static void DecodeDXTBlock(u32* dst, const DXTBlock* src, int pitch)
 // TODO: complete SSE2 optimization of less often used texture formats.
 // TODO: refactor algorithms using _mm_loadl_epi64 unaligned loads to prefer 128-bit aligned loads.
 
-void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
-                            const u8* tlut, TLUTFormat tlutfmt)
+void TexDecoder_DecodeImplGeneric(u32* dst, const u8* src, int width, int height,
+                                  TextureFormat texformat, const u8* tlut, TLUTFormat tlutfmt)
 {
   const int Wsteps4 = (width + 3) / 4;
   const int Wsteps8 = (width + 7) / 8;
@@ -346,5 +348,51 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
       }
       break;
     }
+
+  case TextureFormat::XFB:
+  {
+    for (int y = 0; y < height; y += 1)
+    {
+      for (int x = 0; x < width; x += 2)
+      {
+        size_t offset = static_cast<size_t>((y * width + x) * 2);
+
+        // We do this one color sample (aka 2 RGB pixles) at a time
+        int Y1 = int(src[offset]) - 16;
+        int U = int(src[offset + 1]) - 128;
+        int Y2 = int(src[offset + 2]) - 16;
+        int V = int(src[offset + 3]) - 128;
+
+        // We do the inverse BT.601 conversion for YCbCr to RGB
+        // http://www.equasys.de/colorconversion.html#YCbCr-RGBColorFormatConversion
+        u8 R1 = static_cast<u8>(MathUtil::Clamp(int(1.164f * Y1 + 1.596f * V), 0, 255));
+        u8 G1 =
+            static_cast<u8>(MathUtil::Clamp(int(1.164f * Y1 - 0.392f * U - 0.813f * V), 0, 255));
+        u8 B1 = static_cast<u8>(MathUtil::Clamp(int(1.164f * Y1 + 2.017f * U), 0, 255));
+
+        u8 R2 = static_cast<u8>(MathUtil::Clamp(int(1.164f * Y2 + 1.596f * V), 0, 255));
+        u8 G2 =
+            static_cast<u8>(MathUtil::Clamp(int(1.164f * Y2 - 0.392f * U - 0.813f * V), 0, 255));
+        u8 B2 = static_cast<u8>(MathUtil::Clamp(int(1.164f * Y2 + 2.017f * U), 0, 255));
+
+        dst[y * width + x] = 0xff000000 | B1 << 16 | G1 << 8 | R1;
+        dst[y * width + x + 1] = 0xff000000 | B2 << 16 | G2 << 8 | R2;
+      }
+    }
+  }
+  break;
+
+  default:
+    PanicAlert("Invalid Texture Format (0x%X)! (TexDecoder_DecodeImplGeneric)",
+               static_cast<int>(texformat));
+    break;
   }
 }
+
+#if !defined(_M_X86)
+void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
+                            const u8* tlut, TLUTFormat tlutfmt)
+{
+  TexDecoder_DecodeImplGeneric(dst, src, width, height, texformat, tlut, tlutfmt);
+}
+#endif
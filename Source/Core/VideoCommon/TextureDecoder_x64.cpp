@@ -1410,6 +1410,452 @@ static void TexDecoder_DecodeImpl_CMPR(u32* dst, const u8* src, int width, int h
   }
 }
 
+// AVX2 decoders for every format except XFB. Each register holds 8 output texels; 16-bit colors are
+// converted with integer SIMD instead of per-texel branches, and the palette formats either decode
+// the whole TLUT up front (C4, C8) or gather straight from it (C14X2).
+
+// Byte-swaps 16-bit values which have been zero-extended to 32-bit lanes.
+FUNCTION_TARGET_AVX2
+static inline __m256i Swap16_AVX2(__m256i val)
+{
+  return _mm256_or_si256(_mm256_srli_epi32(val, 8),
+                         _mm256_and_si256(_mm256_slli_epi32(val, 8), _mm256_set1_epi32(0xFF00)));
+}
+
+// Loads 8 little-endian 16-bit values into 32-bit lanes.
+FUNCTION_TARGET_AVX2
+static inline __m256i Load16x8_AVX2(const u8* src)
+{
+  return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+// Loads 4 bytes as 8 nibbles in 32-bit lanes, high nibble first.
+FUNCTION_TARGET_AVX2
+static inline __m256i LoadNibbles_AVX2(const u8* src)
+{
+  const __m128i duplicate = _mm_setr_epi8(0, 0, 1, 1, 2, 2, 3, 3, -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m256i shift = _mm256_setr_epi32(4, 0, 4, 0, 4, 0, 4, 0);
+  u32 bytes;
+  std::memcpy(&bytes, src, sizeof(bytes));
+  const __m128i pairs = _mm_shuffle_epi8(_mm_cvtsi32_si128(static_cast<int>(bytes)), duplicate);
+  return _mm256_and_si256(_mm256_srlv_epi32(_mm256_cvtepu8_epi32(pairs), shift),
+                          _mm256_set1_epi32(0xF));
+}
+
+// Writes texels 0-3 to the first row and texels 4-7 to the row below it.
+FUNCTION_TARGET_AVX2
+static inline void StoreRowPair_AVX2(u32* dst, int width, __m256i texels)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm256_castsi256_si128(texels));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + width), _mm256_extracti128_si256(texels, 1));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert3To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(v, 5), _mm256_slli_epi32(v, 2)),
+                         _mm256_srli_epi32(v, 1));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert4To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 4), v);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert5To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 3), _mm256_srli_epi32(v, 2));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i Convert6To8_AVX2(__m256i v)
+{
+  return _mm256_or_si256(_mm256_slli_epi32(v, 2), _mm256_srli_epi32(v, 4));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i MakeRGBA_AVX2(__m256i r, __m256i g, __m256i b, __m256i a)
+{
+  return _mm256_or_si256(_mm256_or_si256(r, _mm256_slli_epi32(g, 8)),
+                         _mm256_or_si256(_mm256_slli_epi32(b, 16), _mm256_slli_epi32(a, 24)));
+}
+
+// Same as DecodePixel_IA8, on values that have not been byte-swapped.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_IA8_AVX2(__m256i val)
+{
+  const __m256i i = _mm256_srli_epi32(val, 8);
+  const __m256i a = _mm256_and_si256(val, _mm256_set1_epi32(0xFF));
+  return MakeRGBA_AVX2(i, i, i, a);
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB565_AVX2(__m256i val)
+{
+  const __m256i r = Convert5To8_AVX2(_mm256_srli_epi32(val, 11));
+  const __m256i g = Convert6To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 5),
+                                                      _mm256_set1_epi32(0x3F)));
+  const __m256i b = Convert5To8_AVX2(_mm256_and_si256(val, _mm256_set1_epi32(0x1F)));
+  return MakeRGBA_AVX2(r, g, b, _mm256_set1_epi32(0xFF));
+}
+
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodePixels_RGB5A3_AVX2(__m256i val)
+{
+  const __m256i mask_x1f = _mm256_set1_epi32(0x1F);
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0F);
+
+  // Top bit set: RGB555, opaque.
+  const __m256i r5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 10), mask_x1f));
+  const __m256i g5 = Convert5To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 5), mask_x1f));
+  const __m256i b5 = Convert5To8_AVX2(_mm256_and_si256(val, mask_x1f));
+  const __m256i opaque = MakeRGBA_AVX2(r5, g5, b5, _mm256_set1_epi32(0xFF));
+
+  // Top bit clear: RGB444 with 3 bits of alpha.
+  const __m256i a3 = Convert3To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 12),
+                                                       _mm256_set1_epi32(0x7)));
+  const __m256i r4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 8), mask_x0f));
+  const __m256i g4 = Convert4To8_AVX2(_mm256_and_si256(_mm256_srli_epi32(val, 4), mask_x0f));
+  const __m256i b4 = Convert4To8_AVX2(_mm256_and_si256(val, mask_x0f));
+  const __m256i translucent = MakeRGBA_AVX2(r4, g4, b4, a3);
+
+  const __m256i top_bit = _mm256_set1_epi32(0x8000);
+  const __m256i is_opaque = _mm256_cmpeq_epi32(_mm256_and_si256(val, top_bit), top_bit);
+  return _mm256_blendv_epi8(translucent, opaque, is_opaque);
+}
+
+// Decodes raw TLUT entries, as they are stored in texture memory.
+FUNCTION_TARGET_AVX2
+static inline __m256i DecodeTLUTPixels_AVX2(__m256i val, TLUTFormat tlutfmt)
+{
+  switch (tlutfmt)
+  {
+  case TLUTFormat::IA8:
+    return DecodePixels_IA8_AVX2(val);
+  case TLUTFormat::RGB565:
+    return DecodePixels_RGB565_AVX2(Swap16_AVX2(val));
+  case TLUTFormat::RGB5A3:
+  default:
+    return DecodePixels_RGB5A3_AVX2(Swap16_AVX2(val));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void DecodeTLUT_AVX2(u32* palette, const u8* tlut, TLUTFormat tlutfmt, int num_entries)
+{
+  for (int i = 0; i < num_entries; i += 8)
+  {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(palette + i),
+                       DecodeTLUTPixels_AVX2(Load16x8_AVX2(tlut + i * 2), tlutfmt));
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  if (!IsValidTLUTFormat(tlutfmt))
+    return;
+
+  // The 16 palette entries fit in two registers, so lookups are permutes rather than gathers.
+  alignas(32) u32 palette[16];
+  DecodeTLUT_AVX2(palette, tlut, tlutfmt, 16);
+  const __m256i palette_lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(palette));
+  const __m256i palette_hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(palette + 8));
+  const __m256i seven = _mm256_set1_epi32(7);
+
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      for (int iy = 0; iy < 8; iy++, src += 4)
+      {
+        const __m256i index = LoadNibbles_AVX2(src);
+        const __m256i lo = _mm256_permutevar8x32_epi32(palette_lo, index);
+        const __m256i hi = _mm256_permutevar8x32_epi32(palette_hi, index);
+        const __m256i texels = _mm256_blendv_epi8(lo, hi, _mm256_cmpgt_epi32(index, seven));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I4_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Replicates each nibble into all 8 nibbles of the texel.
+  const __m256i replicate = _mm256_set1_epi32(0x11111111);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      for (int iy = 0; iy < 8; iy++, src += 4)
+      {
+        const __m256i texels = _mm256_mullo_epi32(LoadNibbles_AVX2(src), replicate);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_I8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Copies the low byte of each 32-bit lane into the other three.
+  const __m256i replicate = _mm256_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12, 0,
+                                             0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      for (int iy = 0; iy < 4; iy++, src += 8)
+      {
+        const __m256i i =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+        const __m256i texels = _mm256_shuffle_epi8(i, replicate);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C8_AVX2(u32* dst, const u8* src, int width, int height,
+                                          TextureFormat texformat, const u8* tlut,
+                                          TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  if (!IsValidTLUTFormat(tlutfmt))
+    return;
+
+  alignas(32) u32 palette[256];
+  DecodeTLUT_AVX2(palette, tlut, tlutfmt, 256);
+  const int* palette_ptr = reinterpret_cast<const int*>(palette);
+
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      for (int iy = 0; iy < 4; iy++, src += 8)
+      {
+        const __m256i index =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+        const __m256i texels = _mm256_i32gather_epi32(palette_ptr, index, 4);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (y + iy) * width + x), texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA4_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Multiplying a nibble by these places copies of it in the alpha byte and the color bytes.
+  const __m256i replicate_a = _mm256_set1_epi32(0x11000000);
+  const __m256i replicate_i = _mm256_set1_epi32(0x00111111);
+  const __m256i mask_x0f = _mm256_set1_epi32(0x0F);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      for (int iy = 0; iy < 4; iy++, src += 8)
+      {
+        const __m256i val =
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)));
+        const __m256i a = _mm256_mullo_epi32(_mm256_srli_epi32(val, 4), replicate_a);
+        const __m256i i = _mm256_mullo_epi32(_mm256_and_si256(val, mask_x0f), replicate_i);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + (y + iy) * width + x),
+                            _mm256_or_si256(a, i));
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_IA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                           TextureFormat texformat, const u8* tlut,
+                                           TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 4)
+    {
+      for (int iy = 0; iy < 4; iy += 2, src += 16)
+      {
+        const __m256i texels = DecodePixels_IA8_AVX2(Load16x8_AVX2(src));
+        StoreRowPair_AVX2(dst + (y + iy) * width + x, width, texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_C14X2_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  if (!IsValidTLUTFormat(tlutfmt))
+    return;
+
+  // The TLUT is too large to decode up front for every texture, so gather the raw entries instead.
+  // Each gather reads the aligned pair of entries containing the wanted one, which keeps the reads
+  // inside the TLUT even for the last index.
+  const int* tlut_ptr = reinterpret_cast<const int*>(tlut);
+  const __m256i mask_index = _mm256_set1_epi32(0x3FFF);
+  const __m256i mask_entry = _mm256_set1_epi32(0xFFFF);
+  const __m256i one = _mm256_set1_epi32(1);
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 4)
+    {
+      for (int iy = 0; iy < 4; iy += 2, src += 16)
+      {
+        const __m256i index = _mm256_and_si256(Swap16_AVX2(Load16x8_AVX2(src)), mask_index);
+        const __m256i pair = _mm256_i32gather_epi32(tlut_ptr, _mm256_srli_epi32(index, 1), 4);
+        const __m256i shift = _mm256_slli_epi32(_mm256_and_si256(index, one), 4);
+        const __m256i entry = _mm256_and_si256(_mm256_srlv_epi32(pair, shift), mask_entry);
+        StoreRowPair_AVX2(dst + (y + iy) * width + x, width,
+                          DecodeTLUTPixels_AVX2(entry, tlutfmt));
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB565_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 4)
+    {
+      for (int iy = 0; iy < 4; iy += 2, src += 16)
+      {
+        const __m256i texels = DecodePixels_RGB565_AVX2(Swap16_AVX2(Load16x8_AVX2(src)));
+        StoreRowPair_AVX2(dst + (y + iy) * width + x, width, texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGB5A3_AVX2(u32* dst, const u8* src, int width, int height,
+                                              TextureFormat texformat, const u8* tlut,
+                                              TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 4)
+    {
+      for (int iy = 0; iy < 4; iy += 2, src += 16)
+      {
+        const __m256i texels = DecodePixels_RGB5A3_AVX2(Swap16_AVX2(Load16x8_AVX2(src)));
+        StoreRowPair_AVX2(dst + (y + iy) * width + x, width, texels);
+      }
+    }
+  }
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_RGBA8_AVX2(u32* dst, const u8* src, int width, int height,
+                                             TextureFormat texformat, const u8* tlut,
+                                             TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  for (int y = 0; y < height; y += 4)
+  {
+    for (int x = 0; x < width; x += 4, src += 64)
+    {
+      // The first 32 bytes hold the AR pairs of all 16 texels, the next 32 bytes the GB pairs.
+      for (int iy = 0; iy < 4; iy += 2)
+      {
+        const __m256i ar = Load16x8_AVX2(src + iy * 8);
+        const __m256i gb = Load16x8_AVX2(src + 32 + iy * 8);
+        // (R << 8 | A) and (B << 8 | G) -> (A << 24 | B << 16 | G << 8 | R)
+        const __m256i texels = _mm256_or_si256(
+            _mm256_or_si256(_mm256_srli_epi32(ar, 8), _mm256_slli_epi32(ar, 24)),
+            _mm256_slli_epi32(gb, 8));
+        StoreRowPair_AVX2(dst + (y + iy) * width + x, width, texels);
+      }
+    }
+  }
+}
+
+// Builds the 4-entry color table of a CMPR sub-block, exactly like the generic DecodeDXTBlock.
+static inline __m128i DecodeDXTColors(const DXTBlock* block)
+{
+  const u16 c1 = Common::swap16(block->color1);
+  const u16 c2 = Common::swap16(block->color2);
+  const int blue1 = Convert5To8(c1 & 0x1F);
+  const int blue2 = Convert5To8(c2 & 0x1F);
+  const int green1 = Convert6To8((c1 >> 5) & 0x3F);
+  const int green2 = Convert6To8((c2 >> 5) & 0x3F);
+  const int red1 = Convert5To8((c1 >> 11) & 0x1F);
+  const int red2 = Convert5To8((c2 >> 11) & 0x1F);
+
+  u32 colors[4];
+  colors[0] = MakeRGBA(red1, green1, blue1, 255);
+  colors[1] = MakeRGBA(red2, green2, blue2, 255);
+  if (c1 > c2)
+  {
+    colors[2] =
+        MakeRGBA(DXTBlend(red2, red1), DXTBlend(green2, green1), DXTBlend(blue2, blue1), 255);
+    colors[3] =
+        MakeRGBA(DXTBlend(red1, red2), DXTBlend(green1, green2), DXTBlend(blue1, blue2), 255);
+  }
+  else
+  {
+    colors[2] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 255);
+    colors[3] = MakeRGBA((red1 + red2) / 2, (green1 + green2) / 2, (blue1 + blue2) / 2, 0);
+  }
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(colors));
+}
+
+FUNCTION_TARGET_AVX2
+static void TexDecoder_DecodeImpl_CMPR_AVX2(u32* dst, const u8* src, int width, int height,
+                                            TextureFormat texformat, const u8* tlut,
+                                            TLUTFormat tlutfmt, int Wsteps4, int Wsteps8)
+{
+  // Shift amounts which bring the 2-bit index of each texel of rows 0-1 and rows 2-3 down to
+  // bit 0. The leftmost texel of each row is in the top bits of its line byte.
+  const __m256i shift_rows01 = _mm256_setr_epi32(6, 4, 2, 0, 14, 12, 10, 8);
+  const __m256i shift_rows23 = _mm256_setr_epi32(22, 20, 18, 16, 30, 28, 26, 24);
+  const __m256i mask_x03 = _mm256_set1_epi32(3);
+  for (int y = 0; y < height; y += 8)
+  {
+    for (int x = 0; x < width; x += 8)
+    {
+      // Four 4x4 sub-blocks: top left, top right, bottom left, bottom right.
+      for (int i = 0; i < 4; i++, src += sizeof(DXTBlock))
+      {
+        const DXTBlock* block = reinterpret_cast<const DXTBlock*>(src);
+        const __m256i colors = _mm256_broadcastsi128_si256(DecodeDXTColors(block));
+
+        u32 lines;
+        std::memcpy(&lines, block->lines, sizeof(lines));
+        const __m256i lines_vec = _mm256_set1_epi32(static_cast<int>(lines));
+        const __m256i index01 =
+            _mm256_and_si256(_mm256_srlv_epi32(lines_vec, shift_rows01), mask_x03);
+        const __m256i index23 =
+            _mm256_and_si256(_mm256_srlv_epi32(lines_vec, shift_rows23), mask_x03);
+
+        u32* block_dst = dst + (y + (i >> 1) * 4) * width + x + (i & 1) * 4;
+        StoreRowPair_AVX2(block_dst, width, _mm256_permutevar8x32_epi32(colors, index01));
+        StoreRowPair_AVX2(block_dst + 2 * width, width,
+                          _mm256_permutevar8x32_epi32(colors, index23));
+      }
+    }
+  }
+}
+
 void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, TextureFormat texformat,
                             const u8* tlut, TLUTFormat tlutfmt)
 {
@@ -1419,11 +1865,18 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
   switch (texformat)
   {
   case TextureFormat::C4:
-    TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::I4:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I4_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1431,7 +1884,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::I8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_I8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_I8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                      Wsteps8);
     else
@@ -1439,15 +1895,27 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C8:
-    TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                    Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C8(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
     break;
 
   case TextureFormat::IA4:
-    TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA4_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else
+      TexDecoder_DecodeImpl_IA4(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                Wsteps8);
     break;
 
   case TextureFormat::IA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_IA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                     Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_IA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                       Wsteps8);
     else
@@ -1456,17 +1924,28 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::C14X2:
-    TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_C14X2_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else
+      TexDecoder_DecodeImpl_C14X2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                  Wsteps8);
     break;
 
   case TextureFormat::RGB565:
-    TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
-                                 Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB565_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else
+      TexDecoder_DecodeImpl_RGB565(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                   Wsteps8);
     break;
 
   case TextureFormat::RGB5A3:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGB5A3_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                        Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGB5A3_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                          Wsteps8);
     else
@@ -1475,7 +1954,10 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::RGBA8:
-    if (cpu_info.bSSSE3)
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_RGBA8_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                       Wsteps8);
+    else if (cpu_info.bSSSE3)
       TexDecoder_DecodeImpl_RGBA8_SSSE3(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
                                         Wsteps8);
     else
@@ -1484,7 +1966,12 @@ void _TexDecoder_DecodeImpl(u32* dst, const u8* src, int width, int height, Text
     break;
 
   case TextureFormat::CMPR:
-    TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4, Wsteps8);
+    if (cpu_info.bAVX2)
+      TexDecoder_DecodeImpl_CMPR_AVX2(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                      Wsteps8);
+    else
+      TexDecoder_DecodeImpl_CMPR(dst, src, width, height, texformat, tlut, tlutfmt, Wsteps4,
+                                 Wsteps8);
     break;
 
   case TextureFormat::XFB:
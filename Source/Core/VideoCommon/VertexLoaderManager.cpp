@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -17,6 +19,7 @@
 
 #include "VideoCommon/BPMemory.h"
 #include "VideoCommon/DataReader.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
 #include "VideoCommon/Statistics.h"
@@ -37,10 +40,164 @@ static NativeVertexFormatMap s_native_vertex_map;
 static NativeVertexFormat* s_current_vtx_fmt;
 u32 g_current_components;
 
-typedef std::unordered_map<VertexLoaderUID, std::unique_ptr<VertexLoaderBase>> VertexLoaderMap;
+namespace
+{
+// Hash table of every vertex loader created so far. Lookups are lock-free, so the GPU thread never
+// waits on the preprocessing thread or on VertexLoadersToString. Insertions must hold
+// s_vertex_loader_map_lock. Entries are only removed by Clear(), when no lookups are running.
+class VertexLoaderTable
+{
+public:
+  VertexLoaderBase* Find(const VertexLoaderUID& uid) const
+  {
+    const Table* table = m_table.load(std::memory_order_acquire);
+    if (!table)
+      return nullptr;
+
+    for (size_t i = table->GetSlot(uid);; i = (i + 1) & table->mask)
+    {
+      const Entry& entry = table->entries[i];
+      VertexLoaderBase* loader = entry.loader.load(std::memory_order_acquire);
+      if (!loader)
+        return nullptr;
+      if (entry.uid == uid)
+        return loader;
+    }
+  }
+
+  void Insert(const VertexLoaderUID& uid, VertexLoaderBase* loader)
+  {
+    Table* table = m_table.load(std::memory_order_relaxed);
+    // Keep the load factor at or below one half so that probe sequences stay short.
+    if (!table || (m_size + 1) * 2 > table->mask + 1)
+      table = Grow(table);
+
+    InsertInto(table, uid, loader);
+    m_size++;
+  }
+
+  void Clear()
+  {
+    m_table.store(nullptr, std::memory_order_relaxed);
+    m_tables.clear();
+    m_size = 0;
+  }
+
+private:
+  static constexpr u32 INITIAL_SIZE_LOG2 = 6;
+
+  struct Entry
+  {
+    // Only written before loader is published.
+    VertexLoaderUID uid;
+    std::atomic<VertexLoaderBase*> loader{nullptr};
+  };
+
+  struct Table
+  {
+    explicit Table(u32 size_log2)
+        : shift(64 - size_log2), mask((size_t(1) << size_log2) - 1),
+          entries(std::make_unique<Entry[]>(mask + 1))
+    {
+    }
+
+    // Fibonacci hashing, as the low bits of the UID hash mostly depend on the last VAT word.
+    size_t GetSlot(const VertexLoaderUID& uid) const
+    {
+      return static_cast<size_t>((static_cast<u64>(uid.GetHash()) * 0x9E3779B97F4A7C15ULL) >>
+                                 shift);
+    }
+
+    u32 shift;
+    size_t mask;
+    std::unique_ptr<Entry[]> entries;
+  };
+
+  static void InsertInto(Table* table, const VertexLoaderUID& uid, VertexLoaderBase* loader)
+  {
+    size_t i = table->GetSlot(uid);
+    while (table->entries[i].loader.load(std::memory_order_relaxed))
+      i = (i + 1) & table->mask;
+
+    table->entries[i].uid = uid;
+    table->entries[i].loader.store(loader, std::memory_order_release);
+  }
+
+  Table* Grow(const Table* old_table)
+  {
+    const u32 size_log2 = old_table ? 64 - old_table->shift + 1 : INITIAL_SIZE_LOG2;
+    auto table = std::make_unique<Table>(size_log2);
+    if (old_table)
+    {
+      for (size_t i = 0; i <= old_table->mask; i++)
+      {
+        const Entry& entry = old_table->entries[i];
+        VertexLoaderBase* loader = entry.loader.load(std::memory_order_relaxed);
+        if (loader)
+          InsertInto(table.get(), entry.uid, loader);
+      }
+    }
+
+    // Lookups may still be walking the old tables, so they are kept around until Clear().
+    Table* new_table = table.get();
+    m_tables.push_back(std::move(table));
+    m_table.store(new_table, std::memory_order_release);
+    return new_table;
+  }
+
+  std::atomic<Table*> m_table{nullptr};
+  std::vector<std::unique_ptr<Table>> m_tables;
+  size_t m_size = 0;
+};
+
+// The most recently used loaders of a VAT slot, most recent first. Games often switch a slot
+// between a handful of formats, and rewriting the VCD dirties every slot even if the formats stay
+// the same, so most refreshes are resolved here without hashing into the shared table.
+struct RecentLoaders
+{
+  static constexpr size_t SIZE = 4;
+
+  VertexLoaderBase* Find(const VertexLoaderUID& uid)
+  {
+    for (size_t i = 0; i < SIZE && loaders[i]; i++)
+    {
+      if (uids[i] == uid)
+      {
+        VertexLoaderBase* loader = loaders[i];
+        MoveToFront(i, uid, loader);
+        return loader;
+      }
+    }
+    return nullptr;
+  }
+
+  void Add(const VertexLoaderUID& uid, VertexLoaderBase* loader)
+  {
+    MoveToFront(SIZE - 1, uid, loader);
+  }
+
+  void MoveToFront(size_t index, const VertexLoaderUID& uid, VertexLoaderBase* loader)
+  {
+    for (size_t i = index; i > 0; i--)
+    {
+      uids[i] = uids[i - 1];
+      loaders[i] = loaders[i - 1];
+    }
+    uids[0] = uid;
+    loaders[0] = loader;
+  }
+
+  std::array<VertexLoaderUID, SIZE> uids;
+  std::array<VertexLoaderBase*, SIZE> loaders{};
+};
+}  // Anonymous namespace
+
+// Guards s_vertex_loaders and insertions into s_vertex_loader_table.
 static std::mutex s_vertex_loader_map_lock;
-static VertexLoaderMap s_vertex_loader_map;
-// TODO - change into array of pointers. Keep a map of all seen so far.
+static std::vector<std::unique_ptr<VertexLoaderBase>> s_vertex_loaders;
+static VertexLoaderTable s_vertex_loader_table;
+// Indexed by [is_preprocess][vtx_attr_group]. Each is only used by the thread owning that state.
+static std::array<std::array<RecentLoaders, 8>, 2> s_recent_loaders;
 
 u8* cached_arraybases[12];
 
@@ -51,13 +208,16 @@ void Init()
     map_entry = nullptr;
   for (auto& map_entry : g_preprocess_cp_state.vertex_loaders)
     map_entry = nullptr;
+  s_recent_loaders = {};
   SETSTAT(stats.numVertexLoaders, 0);
 }
 
 void Clear()
 {
   std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
-  s_vertex_loader_map.clear();
+  s_recent_loaders = {};
+  s_vertex_loader_table.Clear();
+  s_vertex_loaders.clear();
   s_native_vertex_map.clear();
 }
 
@@ -98,10 +258,9 @@ std::string VertexLoadersToString()
   std::vector<entry> entries;
 
   size_t total_size = 0;
-  for (const auto& map_entry : s_vertex_loader_map)
+  for (const auto& loader : s_vertex_loaders)
   {
-    entry e = {map_entry.second->ToString(),
-               static_cast<u64>(map_entry.second->m_numLoadedVertices)};
+    entry e = {loader->ToString(), static_cast<u64>(loader->m_numLoadedVertices)};
 
     total_size += e.text.size() + 1;
     entries.push_back(std::move(e));
@@ -208,20 +367,28 @@ static VertexLoaderBase* RefreshLoader(int vtx_attr_group, bool preprocess = fal
     bool check_for_native_format = !preprocess;
 
     VertexLoaderUID uid(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-    std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
-    VertexLoaderMap::iterator iter = s_vertex_loader_map.find(uid);
-    if (iter != s_vertex_loader_map.end())
-    {
-      loader = iter->second.get();
-      check_for_native_format &= !loader->m_native_vertex_format;
-    }
-    else
+    RecentLoaders& recent = s_recent_loaders[preprocess][vtx_attr_group];
+    loader = recent.Find(uid);
+    if (!loader)
     {
-      s_vertex_loader_map[uid] =
-          VertexLoaderBase::CreateVertexLoader(state->vtx_desc, state->vtx_attr[vtx_attr_group]);
-      loader = s_vertex_loader_map[uid].get();
-      INCSTAT(stats.numVertexLoaders);
+      loader = s_vertex_loader_table.Find(uid);
+      if (!loader)
+      {
+        std::lock_guard<std::mutex> lk(s_vertex_loader_map_lock);
+        // The other thread may have created it in the meantime.
+        loader = s_vertex_loader_table.Find(uid);
+        if (!loader)
+        {
+          s_vertex_loaders.push_back(VertexLoaderBase::CreateVertexLoader(
+              state->vtx_desc, state->vtx_attr[vtx_attr_group]));
+          loader = s_vertex_loaders.back().get();
+          s_vertex_loader_table.Insert(uid, loader);
+          INCSTAT(stats.numVertexLoaders);
+        }
+      }
+      recent.Add(uid, loader);
     }
+    check_for_native_format &= !loader->m_native_vertex_format;
     if (check_for_native_format)
     {
       // search for a cached native vertex format
@@ -262,6 +429,8 @@ int RunVertices(int vtx_attr_group, int primitive, int count, DataReader src, bo
   if (is_preprocess)
     return size;
 
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::VertexLoading);
+
   // If the native vertex format changed, force a flush.
   if (loader->m_native_vertex_format != s_current_vtx_fmt ||
       loader->m_native_components != g_current_components)
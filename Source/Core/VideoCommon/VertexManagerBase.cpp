@@ -7,6 +7,7 @@
 #include <array>
 #include <cmath>
 #include <memory>
+#include <optional>
 
 #include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
@@ -17,8 +18,10 @@
 #include "Core/ConfigManager.h"
 
 #include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
 #include "VideoCommon/DataReader.h"
 #include "VideoCommon/Debugger.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/NativeVertexFormat.h"
@@ -27,6 +30,7 @@
 #include "VideoCommon/PixelShaderManager.h"
 #include "VideoCommon/RenderBase.h"
 #include "VideoCommon/SamplerCommon.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/VertexLoaderManager.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -96,6 +100,10 @@ DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count,
   // The SSE vertex loader can write up to 4 bytes past the end
   u32 const needed_vertex_bytes = count * stride + 4;
 
+  // BP writes deferred since the last draw only require a flush if they changed anything.
+  if (!m_is_flushed && HasDeferredBPWrites() && !DiscardRedundantDeferredBPWrites())
+    Flush();
+
   // We can't merge different kinds of primitives, so we have to flush here
   PrimitiveType new_primitive_type = g_ActiveConfig.backend_info.bSupportsPrimitiveRestart ?
                                          primitive_from_gx_pr[primitive] :
@@ -126,6 +134,13 @@ DataReader VertexManagerBase::PrepareForAdditionalData(int primitive, u32 count,
                        "Increase MAXVBUFFERSIZE or we need primitive breaking after all.");
   }
 
+  // The new vertices are merged into a draw which used to be split by a state change.
+  if (m_flush_skipped)
+  {
+    INCSTAT(stats.thisFrame.numDrawsSaved);
+    m_flush_skipped = false;
+  }
+
   m_cull_all = cullall;
 
   // need to alloc new buffer
@@ -274,9 +289,16 @@ void VertexManagerBase::Flush()
   if (m_is_flushed)
     return;
 
+  FrameProfiler::ScopedSection profile(FrameProfiler::Section::Flush);
+
   // loading a state will invalidate BP, so check for it
   g_video_backend->CheckInvalidState();
 
+  // Draw with the BP state the pending vertices were loaded with, see BPStructs.h.
+  std::optional<BPMemory> current_bp_state;
+  if (HasDeferredBPWrites())
+    current_bp_state.emplace(LoadPendingBPState());
+
 #if defined(_DEBUG) || defined(DEBUGFAST)
   PRIM_LOG("frame%d:\n texgen=%u, numchan=%u, dualtex=%u, ztex=%u, cole=%u, alpe=%u, ze=%u",
            g_ActiveConfig.iSaveTargetId, xfmem.numTexGen.numTexGens, xfmem.numChan.numColorChans,
@@ -407,7 +429,17 @@ void VertexManagerBase::Flush()
               xfmem.numTexGen.numTexGens, bpmem.genMode.numtexgens.Value());
 
   m_is_flushed = true;
+  m_flush_skipped = false;
   m_cull_all = false;
+
+  if (current_bp_state)
+    ApplyDeferredBPWrites(*current_bp_state);
+}
+
+void VertexManagerBase::SkipFlush()
+{
+  if (!m_is_flushed)
+    m_flush_skipped = true;
 }
 
 void VertexManagerBase::DoState(PointerWrap& p)
@@ -51,6 +51,9 @@ public:
   void FlushData(u32 count, u32 stride);
 
   void Flush();
+  bool IsFlushed() const { return m_is_flushed; }
+  // Called instead of Flush() for state changes which don't affect the pending vertices.
+  void SkipFlush();
 
   virtual std::unique_ptr<NativeVertexFormat>
   CreateNativeVertexFormat(const PortableVertexDeclaration& vtx_decl) = 0;
@@ -95,6 +98,7 @@ protected:
 
 private:
   bool m_is_flushed = true;
+  bool m_flush_skipped = false;
   size_t m_flush_count_4_3 = 0;
   size_t m_flush_count_anamorphic = 0;
 
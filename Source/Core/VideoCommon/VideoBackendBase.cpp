@@ -32,6 +32,7 @@
 #include "VideoCommon/CPMemory.h"
 #include "VideoCommon/CommandProcessor.h"
 #include "VideoCommon/Fifo.h"
+#include "VideoCommon/FrameProfiler.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/IndexGenerator.h"
 #include "VideoCommon/OnScreenDisplay.h"
@@ -296,6 +297,7 @@ void VideoBackendBase::InitializeShared()
 
   g_Config.Refresh();
   UpdateActiveConfig();
+  FrameProfiler::Init();
 }
 
 void VideoBackendBase::ShutdownShared()
@@ -307,4 +309,5 @@ void VideoBackendBase::ShutdownShared()
 
   VertexLoaderManager::Clear();
   Fifo::Shutdown();
+  FrameProfiler::Shutdown();
 }
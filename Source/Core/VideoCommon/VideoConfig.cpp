@@ -67,10 +67,15 @@ void VideoConfig::Refresh()
     aspect_mode = config_aspect_mode;
   bCrop = Config::Get(Config::GFX_CROP);
   iSafeTextureCache_ColorSamples = Config::Get(Config::GFX_SAFE_TEXTURE_CACHE_COLOR_SAMPLES);
+  texture_hash_function =
+      static_cast<TextureHashFunction>(Config::Get(Config::GFX_TEXTURE_HASH_FUNCTION));
+  bTextureWriteTracking = Config::Get(Config::GFX_TEXTURE_WRITE_TRACKING);
+  bDisplayListCache = Config::Get(Config::GFX_DISPLAY_LIST_CACHE);
   bShowFPS = Config::Get(Config::GFX_SHOW_FPS);
   bShowNetPlayPing = Config::Get(Config::GFX_SHOW_NETPLAY_PING);
   bShowNetPlayMessages = Config::Get(Config::GFX_SHOW_NETPLAY_MESSAGES);
   bLogRenderTimeToFile = Config::Get(Config::GFX_LOG_RENDER_TIME_TO_FILE);
+  bLogFrameTraceToFile = Config::Get(Config::GFX_LOG_FRAME_TRACE_TO_FILE);
   bOverlayStats = Config::Get(Config::GFX_OVERLAY_STATS);
   bOverlayProjStats = Config::Get(Config::GFX_OVERLAY_PROJ_STATS);
   bDumpTextures = Config::Get(Config::GFX_DUMP_TEXTURES);
@@ -87,6 +92,7 @@ void VideoConfig::Refresh()
   sDumpPath = Config::Get(Config::GFX_DUMP_PATH);
   iBitrateKbps = Config::Get(Config::GFX_BITRATE_KBPS);
   bInternalResolutionFrameDumps = Config::Get(Config::GFX_INTERNAL_RESOLUTION_FRAME_DUMPS);
+  bFrameDumpsDropFrames = Config::Get(Config::GFX_FRAME_DUMPS_DROP_FRAMES);
   bEnableGPUTextureDecoding = Config::Get(Config::GFX_ENABLE_GPU_TEXTURE_DECODING);
   bEnablePixelLighting = Config::Get(Config::GFX_ENABLE_PIXEL_LIGHTING);
   bFastDepthCalc = Config::Get(Config::GFX_FAST_DEPTH_CALC);
@@ -107,6 +113,7 @@ void VideoConfig::Refresh()
       static_cast<ShaderCompilationMode>(Config::Get(Config::GFX_SHADER_COMPILATION_MODE));
   iShaderCompilerThreads = Config::Get(Config::GFX_SHADER_COMPILER_THREADS);
   iShaderPrecompilerThreads = Config::Get(Config::GFX_SHADER_PRECOMPILER_THREADS);
+  iTextureDecodingThreads = Config::Get(Config::GFX_TEXTURE_DECODING_THREADS);
 
   bZComploc = Config::Get(Config::GFX_SW_ZCOMPLOC);
   bZFreeze = Config::Get(Config::GFX_SW_ZFREEZE);
@@ -115,6 +122,8 @@ void VideoConfig::Refresh()
   bDumpTevTextureFetches = Config::Get(Config::GFX_SW_DUMP_TEV_TEX_FETCHES);
   drawStart = Config::Get(Config::GFX_SW_DRAW_START);
   drawEnd = Config::Get(Config::GFX_SW_DRAW_END);
+  sw_offscreen_dump_format =
+      static_cast<SWOffscreenDumpFormat>(Config::Get(Config::GFX_SW_OFFSCREEN_DUMP_FORMAT));
 
   bForceFiltering = Config::Get(Config::GFX_ENHANCE_FORCE_FILTERING);
   iMaxAnisotropy = Config::Get(Config::GFX_ENHANCE_MAX_ANISOTROPY);
@@ -137,6 +146,7 @@ void VideoConfig::Refresh()
   bSkipEFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_EFB_COPY_TO_RAM);
   bSkipXFBCopyToRam = Config::Get(Config::GFX_HACK_SKIP_XFB_COPY_TO_RAM);
   bDisableCopyToVRAM = Config::Get(Config::GFX_HACK_DISABLE_COPY_TO_VRAM);
+  bDeferEFBCopies = Config::Get(Config::GFX_HACK_DEFER_EFB_COPIES);
   bImmediateXFB = Config::Get(Config::GFX_HACK_IMMEDIATE_XFB);
   bCopyEFBScaled = Config::Get(Config::GFX_HACK_COPY_EFB_SCALED);
   bEFBEmulateFormatChanges = Config::Get(Config::GFX_HACK_EFB_EMULATE_FORMAT_CHANGES);
@@ -206,8 +216,25 @@ u32 VideoConfig::GetShaderPrecompilerThreads() const
   if (!backend_info.bSupportsBackgroundCompiling)
     return 0;
 
+  return GetShaderGenerationThreads();
+}
+
+u32 VideoConfig::GetShaderGenerationThreads() const
+{
+  // Generating shader sources only needs the CPU, so unlike compiling, it can be spread over
+  // helper threads on every backend. The calling thread generates too.
   if (iShaderPrecompilerThreads >= 0)
     return static_cast<u32>(iShaderPrecompilerThreads);
   else
     return GetNumAutoShaderCompilerThreads();
 }
+
+u32 VideoConfig::GetTextureDecodingThreads() const
+{
+  // These are helper threads, the GPU thread decodes too. Automatic number is
+  // clamp(cpus - 3, 0, 3), which leaves room for the CPU, GPU and audio threads.
+  if (iTextureDecodingThreads >= 0)
+    return static_cast<u32>(iTextureDecodingThreads);
+  else
+    return static_cast<u32>(std::min(std::max(cpu_info.num_cores - 3, 0), 3));
+}
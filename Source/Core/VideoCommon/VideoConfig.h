@@ -50,6 +50,22 @@ enum class ShaderCompilationMode : int
   AsynchronousSkipRendering
 };
 
+// Hash used by the texture cache to detect changes to texture memory. Sampled hashing (see
+// iSafeTextureCache_ColorSamples) always uses the default hash.
+enum class TextureHashFunction : int
+{
+  Default,
+  XXH64
+};
+
+// Output of the software renderer when running without a render window.
+enum class SWOffscreenDumpFormat : int
+{
+  None,
+  PNG,
+  Raw
+};
+
 // NEVER inherit from this class.
 struct VideoConfig final
 {
@@ -83,6 +99,8 @@ struct VideoConfig final
   bool bTexFmtOverlayEnable;
   bool bTexFmtOverlayCenter;
   bool bLogRenderTimeToFile;
+  // Time the GPU thread's work per frame, and write it to a Chrome trace file when disabled.
+  bool bLogFrameTraceToFile;
 
   // Render
   bool bWireFrame;
@@ -101,6 +119,8 @@ struct VideoConfig final
   std::string sDumpFormat;
   std::string sDumpPath;
   bool bInternalResolutionFrameDumps;
+  // Drop frames from the dump instead of waiting when the encoder falls behind.
+  bool bFrameDumpsDropFrames;
   bool bFreeLook;
   bool bBorderlessFullscreen;
   bool bEnableGPUTextureDecoding;
@@ -117,9 +137,19 @@ struct VideoConfig final
   bool bSkipEFBCopyToRam;
   bool bSkipXFBCopyToRam;
   bool bDisableCopyToVRAM;
+  // Queue the readbacks of EFB copies to RAM, and only wait for them at the end of the frame or
+  // when the copied memory is about to be used.
+  bool bDeferEFBCopies;
   bool bImmediateXFB;
   bool bCopyEFBScaled;
   int iSafeTextureCache_ColorSamples;
+  TextureHashFunction texture_hash_function;
+  // Skip rehashing textures whose memory has not been written since the last lookup.
+  // Needs fastmem, as writes are detected through page faults.
+  bool bTextureWriteTracking;
+  // Replay display lists from a cache of decoded commands while their memory is unchanged.
+  // Like texture write tracking, this needs fastmem.
+  bool bDisplayListCache;
   float fAspectRatioHackW, fAspectRatioHackH;
   bool bEnablePixelLighting;
   bool bFastDepthCalc;
@@ -147,6 +177,7 @@ struct VideoConfig final
   bool bDumpObjects;
   bool bDumpTevStages;
   bool bDumpTevTextureFetches;
+  SWOffscreenDumpFormat sw_offscreen_dump_format;
 
   // Enable API validation layers, currently only supported with Vulkan.
   bool bEnableValidationLayer;
@@ -167,6 +198,7 @@ struct VideoConfig final
   // -1 uses an automatic number based on the CPU threads.
   int iShaderCompilerThreads;
   int iShaderPrecompilerThreads;
+  int iTextureDecodingThreads;
 
   // Static config per API
   // TODO: Move this out of VideoConfig
@@ -231,6 +263,10 @@ struct VideoConfig final
   bool UsingUberShaders() const;
   u32 GetShaderCompilerThreads() const;
   u32 GetShaderPrecompilerThreads() const;
+  // Helper threads for generating the sources of cached shaders up front, on any backend (see
+  // ShaderCache::PregenerateShaderSources).
+  u32 GetShaderGenerationThreads() const;
+  u32 GetTextureDecodingThreads() const;
 };
 
 extern VideoConfig g_Config;
@@ -13,6 +13,7 @@
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PixelEngine.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/TextureCacheBase.h"
 #include "VideoCommon/TextureDecoder.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
@@ -21,6 +22,14 @@
 
 void VideoCommon_DoState(PointerWrap& p)
 {
+  // Deferred EFB copies belong in the saved RAM, which is written after the video state. On load,
+  // they were made before the state and must not overwrite the loaded RAM. With dual core, the GPU
+  // thread has already flushed them before pausing.
+  if (p.GetMode() == PointerWrap::MODE_READ)
+    g_texture_cache->DiscardEFBCopies();
+  else
+    g_texture_cache->FlushEFBCopies();
+
   // BP Memory
   p.Do(bpmem);
   p.DoMarker("BP Memory");
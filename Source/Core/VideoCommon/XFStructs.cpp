@@ -13,10 +13,28 @@
 #include "VideoCommon/Fifo.h"
 #include "VideoCommon/GeometryShaderManager.h"
 #include "VideoCommon/PixelShaderManager.h"
+#include "VideoCommon/Statistics.h"
 #include "VideoCommon/VertexManagerBase.h"
 #include "VideoCommon/VertexShaderManager.h"
 #include "VideoCommon/XFMemory.h"
 
+// Returns true if writing the next count words of src, up to transfer_size, to xfmem starting at
+// address changes anything. Rewriting the same values doesn't need to flush pending vertices.
+static bool XFDataChanged(u32 address, u32 count, int transfer_size, const DataReader& src,
+                          u32 src_index = 0)
+{
+  const u32* const regs = reinterpret_cast<const u32*>(&xfmem);
+  for (u32 i = 0; i < count && static_cast<int>(i) < transfer_size; i++)
+  {
+    if (regs[address + i] != src.Peek<u32>((src_index + i) * sizeof(u32)))
+      return true;
+  }
+
+  INCSTAT(stats.thisFrame.numRedundantXFLoads);
+  g_vertex_manager->SkipFlush();
+  return false;
+}
+
 static void XFMemWritten(u32 transferSize, u32 baseAddress)
 {
   g_vertex_manager->Flush();
@@ -111,10 +129,13 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETVIEWPORT + 3:
     case XFMEM_SETVIEWPORT + 4:
     case XFMEM_SETVIEWPORT + 5:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetViewportChanged();
-      PixelShaderManager::SetViewportChanged();
-      GeometryShaderManager::SetViewportChanged();
+      if (XFDataChanged(address, XFMEM_SETVIEWPORT + 6 - address, transferSize, src, dataIndex))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetViewportChanged();
+        PixelShaderManager::SetViewportChanged();
+        GeometryShaderManager::SetViewportChanged();
+      }
 
       nextAddress = XFMEM_SETVIEWPORT + 6;
       break;
@@ -126,9 +147,12 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETPROJECTION + 4:
     case XFMEM_SETPROJECTION + 5:
     case XFMEM_SETPROJECTION + 6:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetProjectionChanged();
-      GeometryShaderManager::SetProjectionChanged();
+      if (XFDataChanged(address, XFMEM_SETPROJECTION + 7 - address, transferSize, src, dataIndex))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetProjectionChanged();
+        GeometryShaderManager::SetProjectionChanged();
+      }
 
       nextAddress = XFMEM_SETPROJECTION + 7;
       break;
@@ -146,8 +170,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETTEXMTXINFO + 5:
     case XFMEM_SETTEXMTXINFO + 6:
     case XFMEM_SETTEXMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      if (XFDataChanged(address, XFMEM_SETTEXMTXINFO + 8 - address, transferSize, src, dataIndex))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETTEXMTXINFO);
+      }
 
       nextAddress = XFMEM_SETTEXMTXINFO + 8;
       break;
@@ -160,8 +187,11 @@ static void XFRegWritten(int transferSize, u32 baseAddress, DataReader src)
     case XFMEM_SETPOSMTXINFO + 5:
     case XFMEM_SETPOSMTXINFO + 6:
     case XFMEM_SETPOSMTXINFO + 7:
-      g_vertex_manager->Flush();
-      VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSMTXINFO);
+      if (XFDataChanged(address, XFMEM_SETPOSMTXINFO + 8 - address, transferSize, src, dataIndex))
+      {
+        g_vertex_manager->Flush();
+        VertexShaderManager::SetTexMatrixInfoChanged(address - XFMEM_SETPOSMTXINFO);
+      }
 
       nextAddress = XFMEM_SETPOSMTXINFO + 8;
       break;
@@ -235,7 +265,8 @@ void LoadXFReg(u32 transferSize, u32 baseAddress, DataReader src)
       transferSize = 0;
     }
 
-    XFMemWritten(xfMemTransferSize, xfMemBase);
+    if (XFDataChanged(xfMemBase, xfMemTransferSize, xfMemTransferSize, src))
+      XFMemWritten(xfMemTransferSize, xfMemBase);
     for (u32 i = 0; i < xfMemTransferSize; i++)
     {
       ((u32*)&xfmem)[xfMemBase + i] = src.Read<u32>();
@@ -0,0 +1,284 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Generates the sources of every shader used by the pipelines in a pipeline UID cache.
+// Shader generation only needs the CPU, so this can precompute the sources, or benchmark the
+// generators, on machines which cannot run the emulator.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/File.h"
+#include "Common/FileUtil.h"
+#include "Common/StringUtil.h"
+#include "Common/WorkerPool.h"
+#include "VideoCommon/GXPipelineTypes.h"
+#include "VideoCommon/GeometryShaderGen.h"
+#include "VideoCommon/PixelShaderGen.h"
+#include "VideoCommon/ShaderGenCommon.h"
+#include "VideoCommon/UberShaderPixel.h"
+#include "VideoCommon/UberShaderVertex.h"
+#include "VideoCommon/VertexShaderGen.h"
+#include "VideoCommon/VideoCommon.h"
+#include "VideoCommon/VideoConfig.h"
+
+struct ShaderJob
+{
+  std::string name;
+  std::function<ShaderCode()> generate;
+};
+
+// The generators read a few settings from the active config as well as the host config,
+// so both have to describe the same configuration.
+static void ApplyHostConfig(APIType api_type, const ShaderHostConfig& host_config)
+{
+  VideoConfig& config = g_ActiveConfig;
+  config.backend_info.api_type = api_type;
+  config.stereo_mode = host_config.stereo ? StereoMode::SBS : StereoMode::Off;
+  config.bWireFrame = host_config.wireframe;
+  config.bEnablePixelLighting = host_config.per_pixel_lighting;
+  config.bFastDepthCalc = host_config.fast_depth_calc;
+  config.bBBoxEnable = host_config.bounding_box;
+  config.backend_info.bSupportsDualSourceBlend = host_config.backend_dual_source_blend;
+  config.backend_info.bSupportsGeometryShaders = host_config.backend_geometry_shaders;
+  config.backend_info.bSupportsEarlyZ = host_config.backend_early_z;
+  config.backend_info.bSupportsBBox = host_config.backend_bbox;
+  config.backend_info.bSupportsGSInstancing = host_config.backend_gs_instancing;
+  config.backend_info.bSupportsClipControl = host_config.backend_clip_control;
+  config.backend_info.bSupportsSSAA = host_config.backend_ssaa;
+  config.backend_info.bSupportsFragmentStoresAndAtomics = host_config.backend_atomics;
+  config.backend_info.bSupportsDepthClamp = host_config.backend_depth_clamp;
+  config.backend_info.bSupportsReversedDepthRange = host_config.backend_reversed_depth_range;
+  config.backend_info.bSupportsBitfield = host_config.backend_bitfield;
+  config.backend_info.bSupportsDynamicSamplerIndexing =
+      host_config.backend_dynamic_sampler_indexing;
+  config.backend_info.bSupportsFramebufferFetch = host_config.backend_shader_framebuffer_fetch;
+  config.backend_info.bSupportsPrimitiveRestart = true;
+}
+
+// The features of a typical desktop GPU, used when no host config is given.
+static ShaderHostConfig GetDefaultHostConfig()
+{
+  ShaderHostConfig host_config = {};
+  host_config.backend_dual_source_blend = true;
+  host_config.backend_geometry_shaders = true;
+  host_config.backend_early_z = true;
+  host_config.backend_bbox = true;
+  host_config.backend_gs_instancing = true;
+  host_config.backend_clip_control = true;
+  host_config.backend_ssaa = true;
+  host_config.backend_atomics = true;
+  host_config.backend_depth_clamp = true;
+  host_config.backend_bitfield = true;
+  host_config.backend_dynamic_sampler_indexing = true;
+  return host_config;
+}
+
+static bool ReadPipelineUIDCache(const std::string& filename,
+                                 std::vector<VideoCommon::SerializedGXPipelineUid>* uids)
+{
+  File::IOFile file(filename, "rb");
+  u32 magic;
+  u32 version;
+  if (!file.ReadBytes(&magic, sizeof(magic)) || !file.ReadBytes(&version, sizeof(version)) ||
+      magic != VideoCommon::GX_PIPELINE_UID_CACHE_MAGIC)
+  {
+    printf("ERROR: %s is not a pipeline UID cache.\n", filename.c_str());
+    return false;
+  }
+  if (version != VideoCommon::GX_PIPELINE_UID_VERSION)
+  {
+    printf("ERROR: %s has version %u, expected %u.\n", filename.c_str(), version,
+           VideoCommon::GX_PIPELINE_UID_VERSION);
+    return false;
+  }
+
+  VideoCommon::SerializedGXPipelineUid uid;
+  while (file.ReadBytes(&uid, sizeof(uid)))
+    uids->push_back(uid);
+  return true;
+}
+
+static const char* GetSourceExtension(APIType api_type)
+{
+  return api_type == APIType::D3D ? "hlsl" : "glsl";
+}
+
+int main(int argc, const char* argv[])
+{
+  if (argc == 1 || (argc == 2 && (!strcmp(argv[1], "--help") || (!strcmp(argv[1], "-?")))))
+  {
+    printf("USAGE: ShaderGenTool [-?] [--help] [-a <API>] [-c <HOST CONFIG>] [-j <THREADS>] "
+           "[-o <DIRECTORY>] [-u] <UID CACHE FILE>\n");
+    printf("-? / --help: Prints this message\n");
+    printf("-a <API>: Generate shaders for d3d, opengl (default) or vulkan\n");
+    printf("-c <HOST CONFIG>: Host config bits in hex (default: a typical desktop GPU)\n");
+    printf("-j <THREADS>: Number of helper threads (default: one per CPU core)\n");
+    printf("-o <DIRECTORY>: Write every generated source to the directory\n");
+    printf("-u: Also generate all ubershaders\n");
+
+    return 0;
+  }
+
+  std::string input_name;
+  std::string output_directory;
+  APIType api_type = APIType::OpenGL;
+  ShaderHostConfig host_config = GetDefaultHostConfig();
+  u32 num_threads = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+  bool ubershaders = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!strcmp(argv[i], "-a") && i + 1 < argc)
+    {
+      const std::string api = argv[++i];
+      if (api == "d3d")
+        api_type = APIType::D3D;
+      else if (api == "opengl")
+        api_type = APIType::OpenGL;
+      else if (api == "vulkan")
+        api_type = APIType::Vulkan;
+      else
+      {
+        printf("ERROR: Unknown API %s.\n", api.c_str());
+        return 1;
+      }
+    }
+    else if (!strcmp(argv[i], "-c") && i + 1 < argc)
+    {
+      host_config.bits = static_cast<u32>(strtoul(argv[++i], nullptr, 16));
+    }
+    else if (!strcmp(argv[i], "-j") && i + 1 < argc)
+    {
+      num_threads = static_cast<u32>(strtoul(argv[++i], nullptr, 10));
+    }
+    else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+    {
+      output_directory = argv[++i];
+    }
+    else if (!strcmp(argv[i], "-u"))
+    {
+      ubershaders = true;
+    }
+    else
+    {
+      if (!input_name.empty())
+      {
+        printf("ERROR: Can only take one input file.\n");
+        return 1;
+      }
+      input_name = argv[i];
+      if (!File::Exists(input_name))
+      {
+        printf("ERROR: Input path does not exist.\n");
+        return 1;
+      }
+    }
+  }
+
+  if (input_name.empty())
+  {
+    printf("ERROR: No UID cache file given.\n");
+    return 1;
+  }
+
+  std::vector<VideoCommon::SerializedGXPipelineUid> pipeline_uids;
+  if (!ReadPipelineUIDCache(input_name, &pipeline_uids))
+    return 1;
+
+  if (!output_directory.empty())
+  {
+    if (output_directory.back() != '/')
+      output_directory += '/';
+    if (!File::IsDirectory(output_directory) && !File::CreateFullPath(output_directory))
+    {
+      printf("ERROR: Could not create %s.\n", output_directory.c_str());
+      return 1;
+    }
+  }
+
+  ApplyHostConfig(api_type, host_config);
+
+  // Pipelines share most of their shaders, so every shader is only generated once.
+  std::set<VertexShaderUid> vs_uids;
+  std::set<GeometryShaderUid> gs_uids;
+  std::set<PixelShaderUid> ps_uids;
+  for (const VideoCommon::SerializedGXPipelineUid& uid : pipeline_uids)
+  {
+    vs_uids.insert(uid.vs_uid);
+    ps_uids.insert(uid.ps_uid);
+    if (host_config.backend_geometry_shaders && !uid.gs_uid.GetUidData()->IsPassthrough())
+      gs_uids.insert(uid.gs_uid);
+  }
+
+  std::vector<ShaderJob> jobs;
+  const auto add_job = [&jobs](const char* prefix, std::function<ShaderCode()> generate) {
+    jobs.push_back({StringFromFormat("%s_%04zu", prefix, jobs.size()), std::move(generate)});
+  };
+  for (const VertexShaderUid& uid : vs_uids)
+  {
+    add_job("vs", [=] {
+      return GenerateVertexShaderCode(api_type, host_config, uid.GetUidData());
+    });
+  }
+  for (const GeometryShaderUid& uid : gs_uids)
+  {
+    add_job("gs", [=] {
+      return GenerateGeometryShaderCode(api_type, host_config, uid.GetUidData());
+    });
+  }
+  for (const PixelShaderUid& uid : ps_uids)
+  {
+    add_job("ps", [=] {
+      return GeneratePixelShaderCode(api_type, host_config, uid.GetUidData());
+    });
+  }
+  if (ubershaders)
+  {
+    UberShader::EnumerateVertexShaderUids([&](const UberShader::VertexShaderUid& uid) {
+      add_job("uber_vs",
+              [=] { return UberShader::GenVertexShader(api_type, host_config, uid.GetUidData()); });
+    });
+    UberShader::EnumeratePixelShaderUids([&](const UberShader::PixelShaderUid& uid) {
+      add_job("uber_ps",
+              [=] { return UberShader::GenPixelShader(api_type, host_config, uid.GetUidData()); });
+    });
+  }
+
+  std::vector<size_t> source_sizes(jobs.size());
+  Common::WorkerPool workers;
+  workers.Start(num_threads, "Shader Generation");
+  const auto start_time = std::chrono::steady_clock::now();
+  workers.ParallelFor(static_cast<u32>(jobs.size()), [&](u32 index) {
+    const ShaderCode code = jobs[index].generate();
+    source_sizes[index] = code.GetBuffer().size();
+    if (!output_directory.empty())
+    {
+      File::WriteStringToFile(code.GetBuffer(), output_directory + jobs[index].name + "." +
+                                                    GetSourceExtension(api_type));
+    }
+  });
+  const auto end_time = std::chrono::steady_clock::now();
+  workers.Stop();
+
+  size_t total_size = 0;
+  for (size_t size : source_sizes)
+    total_size += size;
+
+  const double milliseconds =
+      std::chrono::duration<double, std::milli>(end_time - start_time).count();
+  printf("%zu pipelines, %zu vertex, %zu geometry and %zu pixel shaders\n", pipeline_uids.size(),
+         vs_uids.size(), gs_uids.size(), ps_uids.size());
+  printf("Generated %zu shaders (%zu KiB) in %.1f ms on %u threads\n", jobs.size(),
+         total_size / 1024, milliseconds, num_threads + 1);
+  return 0;
+}
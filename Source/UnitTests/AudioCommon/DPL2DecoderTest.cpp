@@ -0,0 +1,146 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/DPL2Decoder.h"
+
+namespace
+{
+constexpr double PI = 3.14159265358979323846;
+constexpr unsigned int LFE_TAPS = 256;
+
+// The 125 Hz lowpass of the LFE channel, designed like the decoder does.
+std::vector<float> LowpassTaps()
+{
+  const float fc = 125.0f / 24000 / 2;
+  std::vector<float> w(LFE_TAPS);
+  for (unsigned int i = 0; i < LFE_TAPS; ++i)
+    w[i] = static_cast<float>(0.54 - 0.46 * cos(static_cast<float>(2.0 * PI / (LFE_TAPS - 1)) * i));
+
+  const unsigned int end = LFE_TAPS / 2;
+  float gain = 0.0f;
+  for (unsigned int i = 0; i < end; ++i)
+  {
+    const float t = static_cast<float>(i + 1) - 0.5f;
+    w[end - i - 1] = w[LFE_TAPS - end + i] =
+        static_cast<float>(w[end - i - 1] * sin(2 * static_cast<float>(PI) * fc * t) / (PI * t));
+    gain += 2 * w[end - i - 1];
+  }
+  for (float& tap : w)
+    tap *= (1 / gain) * 0.7071067812f;
+  return w;
+}
+
+// The per-sample ring buffer filter which the decoder used before it filtered whole blocks.
+class ReferenceLowpass
+{
+public:
+  float Filter(float sample)
+  {
+    m_buffer[m_pos] = sample;
+    const unsigned int count1 = LFE_TAPS - m_pos;
+    float r1 = 0.0f;
+    for (unsigned int i = 0; i < count1; ++i)
+      r1 += m_buffer[m_pos + i] * m_taps[i];
+    float r2 = 0.0f;
+    for (unsigned int i = 0; i < m_pos; ++i)
+      r2 += m_buffer[i] * m_taps[count1 + i];
+    m_pos = (m_pos + 1) % LFE_TAPS;
+    return r1 + r2;
+  }
+
+private:
+  std::vector<float> m_taps = LowpassTaps();
+  std::vector<float> m_buffer = std::vector<float>(LFE_TAPS);
+  unsigned int m_pos = 0;
+};
+
+std::vector<float> TestInput(unsigned int frames)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+  std::vector<float> input(frames * 2);
+  for (unsigned int i = 0; i < frames; ++i)
+  {
+    const double bass = 0.5 * std::sin(2.0 * PI * 60.0 * i / 48000);
+    const double voice = 0.3 * std::sin(2.0 * PI * 700.0 * i / 48000);
+    input[i * 2] = static_cast<float>(bass + voice) + noise(rng);
+    input[i * 2 + 1] = static_cast<float>(bass - 0.5 * voice) + noise(rng);
+  }
+  return input;
+}
+
+std::vector<float> Decode(std::vector<float> input, unsigned int chunk_size)
+{
+  DPL2Reset();
+  const unsigned int frames = static_cast<unsigned int>(input.size() / 2);
+  std::vector<float> output(frames * 6);
+  for (unsigned int i = 0; i < frames; i += chunk_size)
+  {
+    const unsigned int count = std::min(chunk_size, frames - i);
+    DPL2Decode(&input[i * 2], count, &output[i * 6]);
+  }
+  return output;
+}
+}  // Anonymous namespace
+
+TEST(DPL2Decoder, ChunkSizeDoesNotMatter)
+{
+  const std::vector<float> input = TestInput(20000);
+  const std::vector<float> expected = Decode(input, 20000);
+  for (unsigned int chunk_size : {1u, 37u, 160u, 240u, 256u, 1024u})
+    EXPECT_EQ(expected, Decode(input, chunk_size)) << "chunk size " << chunk_size;
+}
+
+TEST(DPL2Decoder, LFEMatchesPerSampleFilter)
+{
+  const std::vector<float> output = Decode(TestInput(20000), 240);
+
+  ReferenceLowpass lowpass;
+  float max_lfe = 0.0f;
+  for (size_t i = 0; i < output.size(); i += 6)
+  {
+    const float* frame = &output[i];
+    const float lfe_in = (frame[0] + frame[1] + 2.0f * frame[2] + frame[4] + frame[5]) / 2.0f;
+    const float expected = lowpass.Filter(lfe_in);
+    ASSERT_NEAR(expected, frame[3], 1e-5f) << "frame " << i / 6;
+    max_lfe = std::max(max_lfe, std::abs(frame[3]));
+  }
+  // The bass passes the lowpass.
+  EXPECT_GT(max_lfe, 0.3f);
+}
+
+// Rough measurement of the CPU cost of the decoder for typical chunks of the mixer.
+TEST(DPL2Decoder, DecodeCost)
+{
+  constexpr unsigned int frames = 48000 * 4;
+  const std::vector<float> input = TestInput(frames);
+
+  for (unsigned int chunk_size : {160u, 240u, 512u})
+  {
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<float> output = Decode(input, chunk_size);
+    const double nanoseconds =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    printf("DPL2 decoder, %u frame chunks: %.1f ns per frame\n", chunk_size, nanoseconds / frames);
+  }
+
+  // For comparison, the LFE filter alone as it ran before.
+  ReferenceLowpass lowpass;
+  float sum = 0.0f;
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned int i = 0; i < frames; ++i)
+    sum += lowpass.Filter(input[i * 2]);
+  const double nanoseconds =
+      std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  printf("Per-sample LFE filter: %.1f ns per frame (%f)\n", nanoseconds / frames, sum);
+}
@@ -0,0 +1,290 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/FlacEncoder.h"
+#include "Common/CommonTypes.h"
+
+using AudioCommon::FlacEncoder;
+
+namespace
+{
+class BitReader
+{
+public:
+  BitReader(const std::vector<u8>& data, size_t byte_position)
+      : m_data(data), m_position(byte_position * 8)
+  {
+  }
+
+  u32 Read(u32 bits)
+  {
+    u32 value = 0;
+    for (u32 i = 0; i < bits; ++i, ++m_position)
+      value = (value << 1) | ((m_data.at(m_position / 8) >> (7 - m_position % 8)) & 1);
+    return value;
+  }
+
+  s32 ReadSigned(u32 bits)
+  {
+    const u32 shift = 32 - bits;
+    return static_cast<s32>(Read(bits) << shift) >> shift;
+  }
+
+  u32 ReadUnary()
+  {
+    u32 zeroes = 0;
+    while (Read(1) == 0)
+      ++zeroes;
+    return zeroes;
+  }
+
+  void AlignToByte() { m_position = (m_position + 7) / 8 * 8; }
+  size_t GetBytePosition() const { return m_position / 8; }
+
+private:
+  const std::vector<u8>& m_data;
+  size_t m_position;
+};
+
+u32 CRC(const u8* data, size_t size, u32 bits, u32 polynomial)
+{
+  const u32 top = 1u << (bits - 1);
+  u32 crc = 0;
+  for (size_t i = 0; i < size; ++i)
+  {
+    crc ^= u32{data[i]} << (bits - 8);
+    for (int bit = 0; bit < 8; ++bit)
+      crc = ((crc & top) ? (crc << 1) ^ polynomial : crc << 1) & ((top << 1) - 1);
+  }
+  return crc;
+}
+
+std::vector<s32> DecodeSubframe(BitReader* reader, u32 count, u32 bits_per_sample)
+{
+  EXPECT_EQ(0u, reader->Read(1));
+  const u32 type = reader->Read(6);
+  EXPECT_EQ(0u, reader->Read(1));
+
+  std::vector<s32> samples(count);
+  if (type == 0)
+  {
+    std::fill(samples.begin(), samples.end(), reader->ReadSigned(bits_per_sample));
+  }
+  else if (type == 1)
+  {
+    for (s32& sample : samples)
+      sample = reader->ReadSigned(bits_per_sample);
+  }
+  else
+  {
+    EXPECT_EQ(0x08u, type & 0x38);
+    const u32 order = type & 0x7;
+    for (u32 i = 0; i < order; ++i)
+      samples[i] = reader->ReadSigned(bits_per_sample);
+
+    EXPECT_EQ(0u, reader->Read(2));
+    const u32 partition_order = reader->Read(4);
+    const u32 partition_size = count >> partition_order;
+    u32 i = order;
+    for (u32 partition = 0; partition < (1u << partition_order); ++partition)
+    {
+      const u32 parameter = reader->Read(4);
+      for (; i < (partition + 1) * partition_size; ++i)
+      {
+        const u32 folded = (reader->ReadUnary() << parameter) | reader->Read(parameter);
+        const s32 residual = static_cast<s32>(folded >> 1) ^ -static_cast<s32>(folded & 1);
+        const s32* x = &samples[i];
+        static constexpr std::array<std::array<s32, 4>, 5> coefficients{
+            {{{0, 0, 0, 0}}, {{1, 0, 0, 0}}, {{2, -1, 0, 0}}, {{3, -3, 1, 0}}, {{4, -6, 4, -1}}}};
+        s32 prediction = 0;
+        for (u32 j = 0; j < order; ++j)
+          prediction += coefficients[order][j] * x[-1 - static_cast<s32>(j)];
+        samples[i] = prediction + residual;
+      }
+    }
+  }
+  return samples;
+}
+
+// Decodes the subset of FLAC which the encoder produces, checking the CRCs on the way.
+std::vector<s16> Decode(const std::vector<u8>& stream, u64* total_frames)
+{
+  std::vector<s16> frames;
+  EXPECT_EQ((std::vector<u8>{'f', 'L', 'a', 'C', 0x80, 0, 0, 34}),
+            std::vector<u8>(stream.begin(), stream.begin() + 8));
+  BitReader header(stream, 8);
+  EXPECT_EQ(FlacEncoder::BLOCK_SIZE, header.Read(16));
+  EXPECT_EQ(FlacEncoder::BLOCK_SIZE, header.Read(16));
+  header.Read(48);
+  EXPECT_EQ(32000u, header.Read(20));
+  EXPECT_EQ(1u, header.Read(3));
+  EXPECT_EQ(15u, header.Read(5));
+  *total_frames = u64{header.Read(4)} << 32;
+  *total_frames |= header.Read(32);
+
+  size_t position = FlacEncoder::HEADER_SIZE;
+  for (u32 frame_number = 0; position < stream.size(); ++frame_number)
+  {
+    BitReader reader(stream, position);
+    EXPECT_EQ(0x3FFEu, reader.Read(14));
+    EXPECT_EQ(0u, reader.Read(2));
+    EXPECT_EQ(0x7u, reader.Read(4));
+    EXPECT_EQ(0x8u, reader.Read(4));
+    const u32 assignment = reader.Read(4);
+    EXPECT_EQ(0x4u, reader.Read(3));
+    EXPECT_EQ(0u, reader.Read(1));
+
+    u32 number = reader.Read(8);
+    // Coded like UTF-8 characters, the leading ones give the length.
+    u32 length = 0;
+    while (number & (0x80 >> length))
+      ++length;
+    if (length != 0)
+    {
+      number &= 0x7F >> length;
+      for (u32 i = 1; i < length; ++i)
+        number = (number << 6) | (reader.Read(8) & 0x3F);
+    }
+    EXPECT_EQ(frame_number, number);
+
+    const u32 count = reader.Read(16) + 1;
+    const size_t header_size = reader.GetBytePosition() - position;
+    EXPECT_EQ(CRC(&stream[position], header_size, 8, 0x07), reader.Read(8));
+
+    const bool first_is_side = assignment == 0x9;
+    const bool second_is_side = assignment == 0x8 || assignment == 0xA;
+    const std::vector<s32> first = DecodeSubframe(&reader, count, first_is_side ? 17 : 16);
+    const std::vector<s32> second = DecodeSubframe(&reader, count, second_is_side ? 17 : 16);
+    reader.AlignToByte();
+    const size_t frame_size = reader.GetBytePosition() - position;
+    EXPECT_EQ(CRC(&stream[position], frame_size, 16, 0x8005), reader.Read(16));
+    position += frame_size + 2;
+
+    for (u32 i = 0; i < count; ++i)
+    {
+      s32 left = first[i];
+      s32 right = second[i];
+      if (assignment == 0x8)
+      {
+        right = first[i] - second[i];
+      }
+      else if (assignment == 0x9)
+      {
+        left = first[i] + second[i];
+      }
+      else if (assignment == 0xA)
+      {
+        const s32 mid = (first[i] << 1) | (second[i] & 1);
+        left = (mid + second[i]) >> 1;
+        right = (mid - second[i]) >> 1;
+      }
+      else
+      {
+        EXPECT_EQ(0x1u, assignment);
+      }
+      frames.push_back(static_cast<s16>(left));
+      frames.push_back(static_cast<s16>(right));
+    }
+  }
+  return frames;
+}
+
+std::vector<u8> Encode(const std::vector<s16>& frames, u32 chunk_size)
+{
+  FlacEncoder encoder(32000);
+  std::vector<u8> stream(FlacEncoder::HEADER_SIZE);
+  const u32 count = static_cast<u32>(frames.size() / 2);
+  for (u32 i = 0; i < count; i += chunk_size)
+    encoder.AddFrames(&frames[i * 2], std::min(chunk_size, count - i), &stream);
+  encoder.Finish(&stream);
+
+  const auto header = encoder.GetHeader();
+  std::copy(header.begin(), header.end(), stream.begin());
+  EXPECT_EQ(count, encoder.GetFrameCount());
+  return stream;
+}
+
+std::vector<s16> SineFrames(u32 count)
+{
+  std::vector<s16> frames(count * 2);
+  for (u32 i = 0; i < count; ++i)
+  {
+    const double value = 12000.0 * std::sin(2.0 * 3.14159265358979323846 * 440.0 * i / 32000.0);
+    frames[i * 2] = static_cast<s16>(std::lround(value));
+    frames[i * 2 + 1] = static_cast<s16>(std::lround(value * 0.5));
+  }
+  return frames;
+}
+}  // Anonymous namespace
+
+TEST(FlacEncoder, RoundTrip)
+{
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> full_scale(-32768, 32767);
+  std::uniform_int_distribution<int> noise(-300, 300);
+
+  // Segments which favor every subframe type and stereo mode, over more than 128 blocks so that
+  // the frame numbers take several bytes.
+  std::vector<s16> frames;
+  const std::vector<s16> sine = SineFrames(5000);
+  for (int segment = 0; segment < 200; ++segment)
+  {
+    const u32 count = 1000 + segment * 17;
+    for (u32 i = 0; i < count; ++i)
+    {
+      s16 left = 0;
+      s16 right = 0;
+      switch (segment % 5)
+      {
+      case 0:
+        left = sine[i * 2] + noise(rng);
+        right = sine[i * 2 + 1] + noise(rng);
+        break;
+      case 1:
+        left = right = static_cast<s16>(full_scale(rng));
+        break;
+      case 2:
+        left = static_cast<s16>(full_scale(rng));
+        right = static_cast<s16>(full_scale(rng));
+        break;
+      case 3:
+        left = -32768;
+        right = 32767;
+        break;
+      default:
+        left = sine[i * 2];
+        right = -sine[i * 2];
+        break;
+      }
+      frames.push_back(left);
+      frames.push_back(right);
+    }
+  }
+
+  for (u32 chunk_size : {FlacEncoder::BLOCK_SIZE, 560u, 1u})
+  {
+    const std::vector<u8> stream = Encode(frames, chunk_size);
+    u64 total_frames;
+    EXPECT_EQ(frames, Decode(stream, &total_frames)) << "chunk size " << chunk_size;
+    EXPECT_EQ(frames.size() / 2, total_frames);
+  }
+}
+
+TEST(FlacEncoder, CompressesTones)
+{
+  const std::vector<s16> frames = SineFrames(32000 * 5);
+  const std::vector<u8> stream = Encode(frames, 560);
+
+  u64 total_frames;
+  EXPECT_EQ(frames, Decode(stream, &total_frames));
+  EXPECT_LT(stream.size(), frames.size() * sizeof(s16) / 3);
+}
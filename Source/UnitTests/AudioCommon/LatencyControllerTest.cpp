@@ -0,0 +1,108 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/LatencyController.h"
+#include "Common/CommonTypes.h"
+
+using AudioCommon::LatencyController;
+
+namespace
+{
+constexpr float TRANSFER_MS = 10.0f;
+
+// Runs transfers of TRANSFER_MS with a constant fill level and no underruns.
+void RunStable(LatencyController* controller, float buffered_ms, float duration_ms,
+               bool adaptive = true)
+{
+  for (float elapsed = 0.0f; elapsed < duration_ms; elapsed += TRANSFER_MS)
+    controller->Update(buffered_ms, TRANSFER_MS, false, adaptive);
+}
+}  // Anonymous namespace
+
+TEST(LatencyController, UnderrunsRaiseTheTarget)
+{
+  LatencyController controller("Test", 5, 40);
+  controller.Reset(20);
+
+  controller.Update(0.0f, TRANSFER_MS, true, true);
+  EXPECT_EQ(25u, controller.GetTarget());
+
+  // A burst of underruns only raises the target once.
+  controller.Update(0.0f, TRANSFER_MS, true, true);
+  EXPECT_EQ(25u, controller.GetTarget());
+
+  RunStable(&controller, 20.0f, 200.0f);
+  controller.ReportUnderrun();
+  controller.Update(0.0f, TRANSFER_MS, false, true);
+  EXPECT_EQ(31u, controller.GetTarget());
+
+  for (int i = 0; i < 10; ++i)
+  {
+    RunStable(&controller, 20.0f, 200.0f);
+    controller.Update(0.0f, TRANSFER_MS, true, true);
+  }
+  EXPECT_EQ(40u, controller.GetTarget());
+  EXPECT_EQ(13u, controller.GetStats().underruns);
+}
+
+TEST(LatencyController, FixedTargetWithoutAdaptation)
+{
+  LatencyController controller("Test", 5, 200);
+  controller.Reset(80);
+
+  controller.Update(0.0f, TRANSFER_MS, true, false);
+  RunStable(&controller, 60.0f, 20000.0f, false);
+
+  EXPECT_EQ(80u, controller.GetTarget());
+  EXPECT_EQ(1u, controller.GetStats().underruns);
+}
+
+TEST(LatencyController, StableBuffersLowerTheTarget)
+{
+  LatencyController controller("Test", 5, 200);
+  controller.Reset(100);
+
+  // The target is only lowered after ten windows without underruns.
+  RunStable(&controller, 80.0f, 9000.0f);
+  EXPECT_EQ(100u, controller.GetTarget());
+  RunStable(&controller, 80.0f, 1000.0f);
+  EXPECT_EQ(88u, controller.GetTarget());
+
+  // Half of the lowest fill level is kept as headroom.
+  RunStable(&controller, 4.0f, 10000.0f);
+  EXPECT_EQ(86u, controller.GetTarget());
+
+  // The headroom also covers a dip in an early window of the quiet period.
+  RunStable(&controller, 80.0f, 1000.0f);
+  RunStable(&controller, 6.0f, 1000.0f);
+  RunStable(&controller, 80.0f, 8000.0f);
+  EXPECT_EQ(83u, controller.GetTarget());
+
+  // Underruns restart the count of stable windows.
+  RunStable(&controller, 80.0f, 5000.0f);
+  controller.Update(0.0f, TRANSFER_MS, true, true);
+  RunStable(&controller, 80.0f, 9000.0f);
+  EXPECT_EQ(103u, controller.GetTarget());
+
+  for (int i = 0; i < 100; ++i)
+    RunStable(&controller, 80.0f, 10000.0f);
+  EXPECT_EQ(5u, controller.GetTarget());
+}
+
+TEST(LatencyController, FillLevelStats)
+{
+  LatencyController controller("Test", 5, 200);
+  controller.Reset(40);
+
+  for (int i = 0; i < 100; ++i)
+    controller.Update(i % 2 ? 30.0f : 50.0f, TRANSFER_MS, false, true);
+
+  const LatencyController::Stats stats = controller.GetStats();
+  EXPECT_EQ(40u, stats.target_ms);
+  EXPECT_EQ(40u, stats.buffered_ms);
+  EXPECT_EQ(20u, stats.jitter_ms);
+  EXPECT_EQ(0u, stats.underruns);
+}
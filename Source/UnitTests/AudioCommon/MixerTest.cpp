@@ -0,0 +1,210 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/Mixer.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/MathUtil.h"
+#include "Common/Swap.h"
+#include "Core/ConfigManager.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+constexpr unsigned int OUTPUT_SAMPLE_RATE = 48000;
+constexpr unsigned int CHUNK_SIZE = 100;
+
+class MixerTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    // Resample at the nominal rate of the FIFOs, without the frame limiter adjustments.
+    SConfig::GetInstance().m_EmulationSpeed = 0.0f;
+    m_mixer = std::make_unique<Mixer>(OUTPUT_SAMPLE_RATE);
+  }
+
+  void TearDown() override
+  {
+    m_mixer.reset();
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  void SetQuality(Mixer::ResamplerQuality quality) { m_mixer->SetResamplerQuality(quality); }
+
+  // Mixes count output frames in chunks, like an audio backend would.
+  std::vector<short> MixFrames(unsigned int count, unsigned int chunk_size = CHUNK_SIZE)
+  {
+    std::vector<short> output(count * 2);
+    for (unsigned int i = 0; i < count; i += chunk_size)
+      m_mixer->Mix(&output[i * 2], std::min(chunk_size, count - i));
+    return output;
+  }
+
+  std::unique_ptr<Mixer> m_mixer;
+
+private:
+  std::string m_profile_path;
+};
+
+// Interleaved left and right frames, in the big endian order of the FIFOs.
+std::vector<short> ToBigEndian(const std::vector<s16>& frames)
+{
+  std::vector<short> swapped(frames.size());
+  std::transform(frames.begin(), frames.end(), swapped.begin(),
+                 [](s16 sample) { return Common::swap16(sample); });
+  return swapped;
+}
+
+std::vector<s16> SineFrames(unsigned int count, unsigned int sample_rate, double frequency)
+{
+  std::vector<s16> frames(count * 2);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    const double value = 10000.0 * std::sin(2.0 * 3.14159265358979323846 * frequency * i /
+                                            sample_rate);
+    frames[i * 2] = static_cast<s16>(std::lround(value));
+    frames[i * 2 + 1] = static_cast<s16>(std::lround(-value));
+  }
+  return frames;
+}
+
+// The per-frame interpolation loop of the mixer before resampling was done in blocks.
+void ReferenceMix(const std::vector<s16>& frames, u32* index, u32* frac, short* samples,
+                  unsigned int count, u32 ratio, s32 lvolume, s32 rvolume)
+{
+  const u32 frame_count = static_cast<u32>(frames.size() / 2);
+  for (unsigned int i = 0; i < count * 2 && frame_count - *index > 1; i += 2)
+  {
+    s16 l1 = frames[*index * 2];
+    s16 l2 = frames[*index * 2 + 2];
+    int sampleL = ((l1 << 16) + (l2 - l1) * (u16)*frac) >> 16;
+    sampleL = (sampleL * lvolume) >> 8;
+    sampleL += samples[i + 1];
+    samples[i + 1] = MathUtil::Clamp(sampleL, -32767, 32767);
+
+    s16 r1 = frames[*index * 2 + 1];
+    s16 r2 = frames[*index * 2 + 3];
+    int sampleR = ((r1 << 16) + (r2 - r1) * (u16)*frac) >> 16;
+    sampleR = (sampleR * rvolume) >> 8;
+    sampleR += samples[i];
+    samples[i] = MathUtil::Clamp(sampleR, -32767, 32767);
+
+    *frac += ratio;
+    *index += (u16)(*frac >> 16);
+    *frac &= 0xffff;
+  }
+}
+}  // Anonymous namespace
+
+TEST_F(MixerTest, LinearMatchesPerFrameInterpolation)
+{
+  SetQuality(Mixer::ResamplerQuality::Linear);
+  constexpr unsigned int input_rate = 44100;
+  m_mixer->SetStreamInputSampleRate(input_rate);
+  m_mixer->SetStreamingVolume(200, 100);
+
+  std::mt19937 rng(1);
+  std::uniform_int_distribution<int> distribution(-32768, 32767);
+  std::vector<s16> frames(2000 * 2);
+  for (s16& sample : frames)
+    sample = static_cast<s16>(distribution(rng));
+  const std::vector<short> input = ToBigEndian(frames);
+  m_mixer->PushStreamingSamples(input.data(), static_cast<unsigned int>(frames.size() / 2));
+
+  constexpr unsigned int output_count = 2000;
+  const std::vector<short> output = MixFrames(output_count);
+
+  const u32 ratio = (u32)(65536.0f * input_rate / (float)OUTPUT_SAMPLE_RATE);
+  std::vector<short> expected(output_count * 2);
+  u32 index = 0;
+  u32 frac = 0;
+  for (unsigned int i = 0; i < output_count; i += CHUNK_SIZE)
+    ReferenceMix(frames, &index, &frac, &expected[i * 2], CHUNK_SIZE, ratio, 201, 100);
+
+  EXPECT_EQ(expected, output);
+}
+
+TEST_F(MixerTest, HigherQualitiesAreMoreAccurate)
+{
+  // A 2 kHz tone at the 32 kHz DMA rate, which linear interpolation noticeably distorts.
+  constexpr unsigned int input_rate = 32000;
+  constexpr double frequency = 2000.0;
+  constexpr unsigned int output_count = 2000;
+  const std::vector<short> input = ToBigEndian(SineFrames(output_count, input_rate, frequency));
+  const u32 ratio = (u32)(65536.0f * input_rate / (float)OUTPUT_SAMPLE_RATE);
+
+  double linear_error = 0.0;
+  for (auto quality : {Mixer::ResamplerQuality::Linear, Mixer::ResamplerQuality::Cubic,
+                       Mixer::ResamplerQuality::Sinc})
+  {
+    m_mixer = std::make_unique<Mixer>(OUTPUT_SAMPLE_RATE);
+    SetQuality(quality);
+    m_mixer->PushSamples(input.data(), output_count);
+    const std::vector<short> output = MixFrames(output_count);
+
+    // The first frames are interpolated with the silence before the start of the input.
+    double squared_error = 0.0;
+    unsigned int compared = 0;
+    for (unsigned int i = 8; i < output_count * input_rate / OUTPUT_SAMPLE_RATE - 8; ++i)
+    {
+      const double position = static_cast<double>(u64{i} * ratio) / 65536.0;
+      const double expected = 10000.0 * std::sin(2.0 * 3.14159265358979323846 * frequency *
+                                                 position / input_rate);
+      squared_error += (output[i * 2 + 1] - expected) * (output[i * 2 + 1] - expected);
+      squared_error += (output[i * 2] + expected) * (output[i * 2] + expected);
+      compared += 2;
+    }
+    const double error = std::sqrt(squared_error / compared);
+
+    EXPECT_LT(error, 150.0);
+    if (quality == Mixer::ResamplerQuality::Linear)
+    {
+      linear_error = error;
+    }
+    else
+    {
+      EXPECT_LT(error, linear_error / 4);
+    }
+  }
+}
+
+TEST_F(MixerTest, QualityChangeAppliesToNextMix)
+{
+  constexpr unsigned int input_rate = 32000;
+  constexpr unsigned int output_count = 1000;
+  const std::vector<short> input = ToBigEndian(SineFrames(output_count, input_rate, 2000.0));
+
+  // The first chunk is mixed with linear interpolation, and the others with the sinc filter.
+  m_mixer->PushSamples(input.data(), output_count);
+  std::vector<short> output = MixFrames(CHUNK_SIZE);
+  SetQuality(Mixer::ResamplerQuality::Sinc);
+  const std::vector<short> switched = MixFrames(output_count - CHUNK_SIZE);
+  output.insert(output.end(), switched.begin(), switched.end());
+
+  m_mixer = std::make_unique<Mixer>(OUTPUT_SAMPLE_RATE);
+  SetQuality(Mixer::ResamplerQuality::Sinc);
+  m_mixer->PushSamples(input.data(), output_count);
+  const std::vector<short> expected = MixFrames(output_count);
+
+  EXPECT_FALSE(std::equal(output.begin(), output.begin() + CHUNK_SIZE * 2, expected.begin()));
+  EXPECT_TRUE(std::equal(output.begin() + CHUNK_SIZE * 2, output.end(),
+                         expected.begin() + CHUNK_SIZE * 2));
+}
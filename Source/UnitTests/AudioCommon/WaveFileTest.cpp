@@ -0,0 +1,135 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioCommon/FlacEncoder.h"
+#include "AudioCommon/WaveFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/Config/Config.h"
+#include "Common/FileUtil.h"
+#include "Common/Swap.h"
+#include "Core/ConfigManager.h"
+#include "UICommon/UICommon.h"
+
+namespace
+{
+class WaveFileTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_profile_path = File::CreateTempDir();
+    UICommon::SetUserDirectory(m_profile_path);
+    Config::Init();
+    SConfig::Init();
+    // Overwrite files without asking.
+    SConfig::GetInstance().m_DumpAudioSilent = true;
+    m_dump_path = File::GetUserPath(D_DUMPAUDIO_IDX);
+    File::CreateFullPath(m_dump_path);
+  }
+
+  void TearDown() override
+  {
+    SConfig::Shutdown();
+    Config::Shutdown();
+    File::DeleteDirRecursively(m_profile_path);
+  }
+
+  std::string m_dump_path;
+
+private:
+  std::string m_profile_path;
+};
+
+// Frames in the big endian right/left order of the mixer.
+std::vector<short> MixerFrames(u32 count, int seed)
+{
+  std::vector<short> frames(count * 2);
+  for (u32 i = 0; i < count; ++i)
+  {
+    frames[i * 2] = Common::swap16(static_cast<u16>(seed + i));
+    frames[i * 2 + 1] = Common::swap16(static_cast<u16>(seed - i));
+  }
+  return frames;
+}
+
+u32 ReadU32(const std::string& data, size_t offset)
+{
+  u32 value;
+  std::memcpy(&value, &data[offset], sizeof(value));
+  return value;
+}
+}  // Anonymous namespace
+
+TEST_F(WaveFileTest, WritesQueuedSamples)
+{
+  const std::string path = m_dump_path + "test.wav";
+  WaveFileWriter writer;
+  ASSERT_TRUE(writer.Start(path, 32000));
+
+  constexpr u32 chunk_count = 2000;
+  constexpr u32 chunk_size = 160;
+  for (u32 i = 0; i < chunk_count; ++i)
+    writer.AddStereoSamplesBE(MixerFrames(chunk_size, i).data(), chunk_size, 32000);
+  writer.Stop();
+
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(path, data));
+  ASSERT_EQ(44 + chunk_count * chunk_size * 4, data.size());
+  EXPECT_EQ("RIFF", data.substr(0, 4));
+  EXPECT_EQ(data.size() - 8, ReadU32(data, 4));
+  EXPECT_EQ(32000u, ReadU32(data, 24));
+  EXPECT_EQ(data.size() - 44, ReadU32(data, 40));
+
+  // The channels are swapped to left/right and stored in little endian.
+  const u32 last_chunk = 44 + (chunk_count - 1) * chunk_size * 4;
+  for (u32 i = 0; i < chunk_size; ++i)
+  {
+    s16 samples[2];
+    std::memcpy(samples, &data[last_chunk + i * 4], sizeof(samples));
+    EXPECT_EQ(static_cast<s16>(chunk_count - 1 - i), samples[0]);
+    EXPECT_EQ(static_cast<s16>(chunk_count - 1 + i), samples[1]);
+  }
+}
+
+TEST_F(WaveFileTest, SplitsFilesOnSampleRateChange)
+{
+  WaveFileWriter writer;
+  ASSERT_TRUE(writer.Start(m_dump_path + "split.wav", 32000));
+  writer.AddStereoSamplesBE(MixerFrames(100, 0).data(), 100, 32000);
+  writer.AddStereoSamplesBE(MixerFrames(200, 0).data(), 200, 48000);
+  writer.Stop();
+
+  std::string first;
+  std::string second;
+  ASSERT_TRUE(File::ReadFileToString(m_dump_path + "split.wav", first));
+  ASSERT_TRUE(File::ReadFileToString(m_dump_path + "split1.wav", second));
+  EXPECT_EQ(100u * 4, ReadU32(first, 40));
+  EXPECT_EQ(200u * 4, ReadU32(second, 40));
+  EXPECT_EQ(48000u, ReadU32(second, 24));
+}
+
+TEST_F(WaveFileTest, WritesFlacFiles)
+{
+  const std::string path = m_dump_path + "test.flac";
+  WaveFileWriter writer;
+  ASSERT_TRUE(writer.Start(path, 32000));
+  constexpr u32 frame_count = 10000;
+  writer.AddStereoSamplesBE(MixerFrames(frame_count, 0).data(), frame_count, 32000);
+  writer.Stop();
+  EXPECT_EQ(frame_count * 4, writer.GetAudioSize());
+
+  std::string data;
+  ASSERT_TRUE(File::ReadFileToString(path, data));
+  ASSERT_LT(AudioCommon::FlacEncoder::HEADER_SIZE, data.size());
+  EXPECT_LT(data.size(), frame_count * 4);
+  EXPECT_EQ("fLaC", data.substr(0, 4));
+  // The total sample count in STREAMINFO is only known when the file is closed.
+  EXPECT_EQ(frame_count, Common::swap32(ReadU32(data, 22)));
+}
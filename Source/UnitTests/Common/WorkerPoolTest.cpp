@@ -0,0 +1,61 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/WorkerPool.h"
+
+TEST(WorkerPool, RunsEveryJobOnce)
+{
+  Common::WorkerPool pool;
+  pool.Start(3, "WorkerPoolTest");
+  EXPECT_EQ(3u, pool.GetThreadCount());
+
+  for (u32 count = 0; count < 100; count++)
+  {
+    std::vector<std::atomic<int>> runs(count);
+    pool.ParallelFor(count, [&](u32 index) { runs[index]++; });
+    for (u32 i = 0; i < count; i++)
+      EXPECT_EQ(1, runs[i].load());
+  }
+}
+
+TEST(WorkerPool, Inline)
+{
+  Common::WorkerPool pool;
+  const std::thread::id caller = std::this_thread::get_id();
+  int sum = 0;
+  pool.ParallelFor(10, [&](u32 index) {
+    EXPECT_EQ(caller, std::this_thread::get_id());
+    sum += index;
+  });
+  EXPECT_EQ(45, sum);
+}
+
+TEST(WorkerPool, ConcurrentSubmitters)
+{
+  Common::WorkerPool pool;
+  pool.Start(2, "WorkerPoolTest");
+
+  std::atomic<u32> total{0};
+  auto submit = [&] {
+    for (int i = 0; i < 200; i++)
+      pool.ParallelFor(16, [&](u32 index) { total += index; });
+  };
+  std::thread other(submit);
+  submit();
+  other.join();
+
+  EXPECT_EQ(2u * 200u * 120u, total.load());
+
+  // Restarting must leave the pool usable.
+  pool.Start(1, "WorkerPoolTest");
+  u32 count = 0;
+  pool.ParallelFor(1, [&](u32) { count++; });
+  EXPECT_EQ(1u, count);
+}
@@ -0,0 +1,216 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/DSP.h"
+#include "Core/HW/Memmap.h"
+
+#define AX_GC
+#include "Core/HW/DSPHLE/UCodes/AXVoice.h"
+
+using namespace DSP::HLE;
+
+namespace
+{
+constexpr u32 PB_LIST_ADDRESS = 0x10000;
+constexpr u32 PB_STRIDE = 0x200;
+static_assert(sizeof(AXPB) <= PB_STRIDE, "PBs must not overlap");
+// Any ucode whose PBs have a low pass filter.
+constexpr u32 PB_CRC = 0;
+// Size of the ARAM region the voices play from.
+constexpr u32 SAMPLE_DATA_SIZE = 0x10000;
+
+u32 GetPBAddress(u32 index)
+{
+  return PB_LIST_ADDRESS + index * PB_STRIDE;
+}
+
+// Mixes the five milliseconds of a frame like AXUCode::ProcessPBList, without PB updates. The
+// mixer control bits of the GameCube PBs are used as they are.
+void MixVoice(AXPB& pb, AXBuffers buffers)
+{
+  for (int ms = 0; ms < 5; ++ms)
+  {
+    ProcessVoice(pb, buffers, 32, static_cast<AXMixControl>(pb.mixer_control), nullptr);
+    for (int*& ptr : buffers.ptrs)
+      ptr += 32;
+  }
+}
+
+struct MixResult
+{
+  std::vector<int> buffers;
+  std::vector<u8> pbs;
+};
+
+// Voice processing reads and writes PBs in emulated RAM, and reads samples from ARAM.
+class AXVoiceListTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_ram.assign(Memory::RAM_SIZE, 0);
+    Memory::m_pRAM = m_ram.data();
+    SConfig::Init();
+    DSP::Reinit(true);
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<int> u8_distribution(0, 0xff);
+    for (u32 i = 0; i < SAMPLE_DATA_SIZE; ++i)
+      DSP::GetARAMPtr()[i] = static_cast<u8>(u8_distribution(rng));
+  }
+
+  void TearDown() override
+  {
+    DSP::Shutdown();
+    SConfig::Shutdown();
+    Memory::m_pRAM = nullptr;
+  }
+
+  void WritePBList(u32 count, u32 seed)
+  {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> u16_distribution(0, 0xffff);
+    std::uniform_int_distribution<int> delta_distribution(-64, 64);
+    std::uniform_int_distribution<u32> length_distribution(16, 3000);
+    std::uniform_int_distribution<u32> ratio_distribution(0x200, 0x40000);
+    for (u32 i = 0; i < count; ++i)
+    {
+      AXPB pb{};
+      const u32 next_pb = i + 1 < count ? GetPBAddress(i + 1) : 0;
+      pb.next_pb_hi = static_cast<u16>(next_pb >> 16);
+      pb.next_pb_lo = static_cast<u16>(next_pb);
+      pb.this_pb_hi = static_cast<u16>(GetPBAddress(i) >> 16);
+      pb.this_pb_lo = static_cast<u16>(GetPBAddress(i));
+      pb.running = i % 7 != 3;
+      pb.is_stream = i % 5 == 1;
+      pb.src_type = i % 3 == 0 ? SRCTYPE_NEAREST : SRCTYPE_LINEAR;
+      pb.mixer_control = static_cast<u16>(u16_distribution(rng));
+      u16* mixer = reinterpret_cast<u16*>(&pb.mixer);
+      for (size_t j = 0; j < sizeof(pb.mixer) / sizeof(u16); j += 2)
+      {
+        mixer[j] = static_cast<u16>(u16_distribution(rng));
+        mixer[j + 1] = static_cast<u16>(delta_distribution(rng));
+      }
+      pb.vol_env.cur_volume = static_cast<u16>(u16_distribution(rng) & 0x7fff);
+      pb.vol_env.cur_volume_delta = static_cast<s16>(delta_distribution(rng));
+
+      // Short voices, some of which end or loop within the frame. Addresses count nibbles for
+      // ADPCM, bytes for PCM8 and samples for PCM16.
+      static constexpr u16 formats[] = {AUDIOFORMAT_ADPCM, AUDIOFORMAT_PCM8, AUDIOFORMAT_PCM16};
+      pb.audio_addr.sample_format = formats[i % 3];
+      const u32 units_per_byte = pb.audio_addr.sample_format == AUDIOFORMAT_ADPCM ? 2 : 1;
+      const u32 bytes_per_unit = pb.audio_addr.sample_format == AUDIOFORMAT_PCM16 ? 2 : 1;
+      const u32 data_size = SAMPLE_DATA_SIZE * units_per_byte / bytes_per_unit;
+      const u32 length = length_distribution(rng);
+      const u32 start = (static_cast<u32>(u16_distribution(rng)) % (data_size - length)) & ~15;
+      const u32 loop_addr = start + 2;
+      const u32 end_addr = start + length;
+      const u32 cur_addr = loop_addr + (length - 2) * (i % 4) / 4;
+      pb.audio_addr.looping = i % 2;
+      pb.audio_addr.loop_addr_hi = static_cast<u16>(loop_addr >> 16);
+      pb.audio_addr.loop_addr_lo = static_cast<u16>(loop_addr);
+      pb.audio_addr.end_addr_hi = static_cast<u16>(end_addr >> 16);
+      pb.audio_addr.end_addr_lo = static_cast<u16>(end_addr);
+      pb.audio_addr.cur_addr_hi = static_cast<u16>(cur_addr >> 16);
+      pb.audio_addr.cur_addr_lo = static_cast<u16>(cur_addr);
+      for (s16& coef : pb.adpcm.coefs)
+        coef = static_cast<s16>(delta_distribution(rng) * 64);
+      pb.adpcm.pred_scale = static_cast<u16>(u16_distribution(rng) & 0x7f);
+      pb.adpcm_loop_info.pred_scale = static_cast<u16>(u16_distribution(rng) & 0x7f);
+
+      const u32 ratio = ratio_distribution(rng);
+      pb.src.ratio_hi = static_cast<u16>(ratio >> 16);
+      pb.src.ratio_lo = static_cast<u16>(ratio);
+      pb.src.cur_addr_frac = static_cast<u16>(u16_distribution(rng));
+      WritePB(GetPBAddress(i), pb, PB_CRC);
+    }
+    m_count = count;
+    m_initial_ram = m_ram;
+  }
+
+  template <typename ProcessPB>
+  MixResult Mix(u32 num_threads, ProcessPB process_pb)
+  {
+    m_ram = m_initial_ram;
+
+    MixResult result;
+    AXBuffers buffers;
+    const size_t buffer_size = GetMixBufferSize(0);
+    result.buffers.resize(ArraySize(buffers.ptrs) * buffer_size);
+    // The voices are added to what the buffers already hold.
+    for (size_t i = 0; i < result.buffers.size(); ++i)
+      result.buffers[i] = static_cast<int>(i * 101) - 20000;
+    for (size_t i = 0; i < ArraySize(buffers.ptrs); ++i)
+      buffers.ptrs[i] = &result.buffers[i * buffer_size];
+
+    Common::WorkerPool workers;
+    workers.Start(num_threads, "AX voice test");
+    std::vector<int> group_buffers;
+    ProcessVoices(PB_LIST_ADDRESS, buffers, PB_CRC, workers, &group_buffers, process_pb);
+    workers.Stop();
+
+    result.pbs.assign(m_ram.begin() + PB_LIST_ADDRESS, m_ram.begin() + GetPBAddress(m_count));
+    return result;
+  }
+
+  std::vector<u8> m_ram;
+  std::vector<u8> m_initial_ram;
+  u32 m_count = 0;
+};
+}  // Anonymous namespace
+
+TEST_F(AXVoiceListTest, ParallelProcessingMatchesSerialProcessing)
+{
+  for (u32 count : {1u, 5u, 64u, 300u})
+  {
+    WritePBList(count, count);
+    const MixResult serial = Mix(0, MixVoice);
+    for (u32 num_threads : {1u, 3u, 8u})
+    {
+      const MixResult parallel = Mix(num_threads, MixVoice);
+      EXPECT_EQ(serial.buffers, parallel.buffers) << count << " voices, " << num_threads
+                                                  << " threads";
+      EXPECT_TRUE(serial.pbs == parallel.pbs) << count << " voices, " << num_threads
+                                              << " threads";
+    }
+  }
+}
+
+TEST_F(AXVoiceListTest, ChangedNextPBFallsBackToSerialProcessing)
+{
+  constexpr u32 count = 40;
+  WritePBList(count, 1);
+
+  // An update of voice 10 unlinks voice 11 from the list.
+  const auto process_pb = [](AXPB& pb, AXBuffers buffers) {
+    if (static_cast<u32>(HILO_TO_32(pb.this_pb)) == GetPBAddress(10))
+    {
+      pb.next_pb_hi = static_cast<u16>(GetPBAddress(12) >> 16);
+      pb.next_pb_lo = static_cast<u16>(GetPBAddress(12));
+    }
+    MixVoice(pb, buffers);
+  };
+
+  const MixResult serial = Mix(0, process_pb);
+  const u32 skipped_offset = GetPBAddress(11) - PB_LIST_ADDRESS;
+  EXPECT_TRUE(std::equal(serial.pbs.begin() + skipped_offset,
+                         serial.pbs.begin() + skipped_offset + PB_STRIDE,
+                         m_initial_ram.begin() + GetPBAddress(11)));
+
+  for (u32 num_threads : {1u, 3u})
+  {
+    const MixResult parallel = Mix(num_threads, process_pb);
+    EXPECT_EQ(serial.buffers, parallel.buffers) << num_threads << " threads";
+    EXPECT_TRUE(serial.pbs == parallel.pbs) << num_threads << " threads";
+  }
+}
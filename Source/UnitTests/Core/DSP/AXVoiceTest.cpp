@@ -0,0 +1,208 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+
+#define AX_GC
+#include "Core/HW/DSPHLE/UCodes/AXVoice.h"
+
+using namespace DSP::HLE;
+
+static std::vector<s16> RandomSamples(std::mt19937& rng, size_t count)
+{
+  std::uniform_int_distribution<int> distribution(-32768, 32767);
+  std::vector<s16> samples(count);
+  for (s16& sample : samples)
+    sample = static_cast<s16>(distribution(rng));
+  // Make sure that the extreme values are covered.
+  samples[0] = -32768;
+  samples[count / 2] = 32767;
+  return samples;
+}
+
+// The scalar mixing code of the AX ucodes, which the batched code must match bit for bit.
+namespace Reference
+{
+static void MixAdd(int* out, const s16* input, u32 count, u16* pvol, s16* dpop, bool ramp)
+{
+  u16& volume = pvol[0];
+  u16 volume_delta = pvol[1];
+  if (!ramp)
+    volume_delta = 0;
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    s64 sample = input[i];
+    sample *= volume;
+    sample >>= 15;
+    sample = MathUtil::Clamp((s32)sample, -32767, 32767);
+
+    out[i] += (s16)sample;
+    volume += volume_delta;
+
+    *dpop = (s16)sample;
+  }
+}
+
+static u16 ApplyEnvelope(s16* samples, u32 count, u16 cur_volume, s16 cur_volume_delta)
+{
+  for (u32 i = 0; i < count; ++i)
+  {
+    samples[i] = MathUtil::Clamp(((s32)samples[i] * cur_volume) >> 15, -32767, 32767);
+    cur_volume += cur_volume_delta;
+  }
+  return cur_volume;
+}
+
+static u32 ResampleLinear(std::function<s16(u32)> input_callback, s16* output, u32 count,
+                          s16* last_samples, u32 curr_pos, u32 ratio)
+{
+  int read_samples_count = 0;
+  s16 temp[4];
+  u32 idx = 0;
+
+  temp[idx++ & 3] = last_samples[0];
+  temp[idx++ & 3] = last_samples[1];
+  temp[idx++ & 3] = last_samples[2];
+  temp[idx++ & 3] = last_samples[3];
+
+  for (u32 i = 0; i < count; ++i)
+  {
+    curr_pos += ratio;
+    while (curr_pos >= 0x10000)
+    {
+      temp[idx++ & 3] = input_callback(read_samples_count++);
+      curr_pos -= 0x10000;
+    }
+
+    u16 curr_frac = curr_pos & 0xFFFF;
+    u16 inv_curr_frac = -curr_frac;
+    s16 sample;
+    if (curr_frac)
+    {
+      s32 s0 = temp[idx++ & 3];
+      s32 s1 = temp[idx++ & 3];
+      sample = ((s0 * inv_curr_frac) + (s1 * curr_frac)) >> 16;
+      idx += 2;
+    }
+    else
+    {
+      sample = temp[idx++ & 3];
+      idx += 3;
+    }
+    output[i] = sample;
+  }
+
+  last_samples[3] = temp[--idx & 3];
+  last_samples[2] = temp[--idx & 3];
+  last_samples[1] = temp[--idx & 3];
+  last_samples[0] = temp[--idx & 3];
+  return curr_pos;
+}
+}  // namespace Reference
+
+TEST(AXVoice, MixAddMatchesScalarMixing)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> u16_distribution(0, 0xffff);
+  const std::vector<s16> input = RandomSamples(rng, MAX_SAMPLES_PER_FRAME);
+
+  for (u32 count : {0u, 1u, 7u, 8u, 18u, 31u, 32u})
+  {
+    for (int iteration = 0; iteration < 200; ++iteration)
+    {
+      const bool ramp = iteration % 2 != 0;
+      std::array<u16, 2> volume = {{static_cast<u16>(u16_distribution(rng)),
+                                    static_cast<u16>(u16_distribution(rng))}};
+      if (iteration < 4)
+        volume[0] = iteration < 2 ? 0xffff : 0x8000;
+      std::array<u16, 2> expected_volume = volume;
+
+      std::array<int, MAX_SAMPLES_PER_FRAME> out{};
+      std::array<int, MAX_SAMPLES_PER_FRAME> expected_out{};
+      for (size_t i = 0; i < out.size(); ++i)
+        out[i] = expected_out[i] = u16_distribution(rng) - 0x8000;
+      s16 dpop = 0x1234;
+      s16 expected_dpop = dpop;
+
+      MixAdd(out.data(), input.data(), count, volume.data(), &dpop, ramp);
+      Reference::MixAdd(expected_out.data(), input.data(), count, expected_volume.data(),
+                        &expected_dpop, ramp);
+
+      ASSERT_EQ(expected_out, out) << "count " << count << ", iteration " << iteration;
+      ASSERT_EQ(expected_volume, volume);
+      ASSERT_EQ(expected_dpop, dpop);
+    }
+  }
+}
+
+TEST(AXVoice, ApplyVolumeMatchesScalarEnvelope)
+{
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> u16_distribution(0, 0xffff);
+
+  for (u32 count : {1u, 5u, 16u, 32u, 96u})
+  {
+    for (int iteration = 0; iteration < 200; ++iteration)
+    {
+      std::vector<s16> samples = RandomSamples(rng, count + 1);
+      std::vector<s16> expected = samples;
+      const u16 volume = static_cast<u16>(u16_distribution(rng));
+      const s16 delta = static_cast<s16>(u16_distribution(rng) >> (iteration % 16));
+
+      const u16 new_volume = ApplyVolume(samples.data(), samples.data(), count, volume, delta);
+      const u16 expected_volume = Reference::ApplyEnvelope(expected.data(), count, volume, delta);
+
+      ASSERT_EQ(expected, samples) << "count " << count << ", iteration " << iteration;
+      ASSERT_EQ(expected_volume, new_volume);
+    }
+  }
+}
+
+TEST(AXVoice, BatchedResamplingMatchesScalarResampling)
+{
+  std::mt19937 rng(5678);
+  const std::vector<s16> input = RandomSamples(rng, MAX_SAMPLES_PER_FRAME * 16);
+
+  for (u32 ratio : {0x10000u, 0x8000u, 0x1u, 0xabcdu, 0x18000u, 0x2c9a3u, 0x55555u, 0x7ffffu})
+  {
+    for (u32 curr_pos : {0u, 1u, 0x8000u, 0xffffu})
+    {
+      std::array<s16, MAX_SAMPLES_PER_FRAME> output;
+      std::array<s16, MAX_SAMPLES_PER_FRAME> expected_output;
+      std::array<s16, 4> last_samples = {{1, -2, 300, -32768}};
+      std::array<s16, 4> expected_last_samples = last_samples;
+
+      u32 expected_reads = 0;
+      const u32 expected_pos = Reference::ResampleLinear(
+          [&](u32 i) {
+            expected_reads = i + 1;
+            return input[i];
+          },
+          expected_output.data(), MAX_SAMPLES_PER_FRAME, expected_last_samples.data(), curr_pos,
+          ratio);
+
+      const u32 input_count =
+          GetResampleInputCount(MAX_SAMPLES_PER_FRAME, curr_pos, ratio, SRCTYPE_LINEAR);
+      ASSERT_EQ(expected_reads, input_count) << "ratio " << ratio << ", position " << curr_pos;
+
+      const std::vector<s16> batch(input.begin(), input.begin() + input_count);
+      const u32 pos = ResampleAudio([&batch](u32 i) { return batch[i]; }, output.data(),
+                                    MAX_SAMPLES_PER_FRAME, last_samples.data(), curr_pos, ratio,
+                                    SRCTYPE_LINEAR, nullptr);
+
+      EXPECT_EQ(expected_pos, pos);
+      EXPECT_EQ(expected_output, output);
+      EXPECT_EQ(expected_last_samples, last_samples);
+    }
+  }
+}
@@ -2,7 +2,10 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <random>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -33,6 +36,36 @@ protected:
   bool m_accov_raised = false;
 };
 
+// Accelerator reading ADPCM data from memory, which loops like AX voices do.
+class ADPCMAccelerator : public DSP::Accelerator
+{
+public:
+  ADPCMAccelerator(const std::vector<u8>& memory, bool looping)
+      : m_memory(memory), m_looping(looping)
+  {
+  }
+
+  u32 GetEndExceptionCount() const { return m_end_exceptions; }
+
+protected:
+  void OnEndException() override
+  {
+    ++m_end_exceptions;
+    if (!m_looping)
+      return;
+    // Restart with the loop context, which also resumes reads.
+    SetPredScale(m_memory[m_start_address >> 1]);
+    SetYn1(0x123);
+    SetYn2(-0x456);
+  }
+  u8 ReadMemory(u32 address) override { return m_memory.at(address); }
+  void WriteMemory(u32 address, u8 value) override {}
+
+  const std::vector<u8>& m_memory;
+  bool m_looping;
+  u32 m_end_exceptions = 0;
+};
+
 TEST(DSPAccelerator, Initialization)
 {
   TestAccelerator accelerator;
@@ -185,3 +218,128 @@ TEST(DSPAccelerator, CurrentAddressSkips)
   accelerator.TestRead();
   EXPECT_EQ(accelerator.GetCurrentAddress(), 0x00000013u);
 }
+
+namespace
+{
+struct ADPCMSetup
+{
+  u32 start;
+  u32 end;
+  u32 current;
+  bool looping;
+};
+
+void ConfigureADPCM(DSP::Accelerator* accelerator, const ADPCMSetup& setup, u16 pred_scale)
+{
+  accelerator->SetStartAddress(setup.start);
+  accelerator->SetEndAddress(setup.end);
+  accelerator->SetCurrentAddress(setup.current);
+  accelerator->SetSampleFormat(0x00);
+  accelerator->SetPredScale(pred_scale);
+  accelerator->SetYn1(-0x200);
+  accelerator->SetYn2(0x100);
+}
+
+// Checks that ReadSamples() returns the samples and leaves the state of Read() in a loop.
+void CompareBulkReads(const ADPCMSetup& setup, u32 chunk_size, u32 total)
+{
+  std::mt19937 rng(setup.end * 31 + chunk_size);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<u8> memory(0x400);
+  for (u8& value : memory)
+    value = static_cast<u8>(byte(rng));
+  std::uniform_int_distribution<int> coef(-4096, 4095);
+  std::array<s16, 16> coefs;
+  for (s16& value : coefs)
+    value = static_cast<s16>(coef(rng));
+
+  ADPCMAccelerator single(memory, setup.looping);
+  ADPCMAccelerator bulk(memory, setup.looping);
+  const u16 pred_scale = memory[(setup.current & ~15) >> 1];
+  ConfigureADPCM(&single, setup, pred_scale);
+  ConfigureADPCM(&bulk, setup, pred_scale);
+
+  std::vector<s16> samples(chunk_size);
+  for (u32 done = 0; done < total; done += chunk_size)
+  {
+    bulk.ReadSamples(coefs.data(), samples.data(), chunk_size);
+    for (u32 i = 0; i < chunk_size; ++i)
+    {
+      ASSERT_EQ(static_cast<s16>(single.Read(coefs.data())), samples[i])
+          << "sample " << done + i << ", end " << setup.end << ", chunk size " << chunk_size;
+    }
+    ASSERT_EQ(single.GetCurrentAddress(), bulk.GetCurrentAddress());
+    ASSERT_EQ(single.GetYn1(), bulk.GetYn1());
+    ASSERT_EQ(single.GetYn2(), bulk.GetYn2());
+    ASSERT_EQ(single.GetPredScale(), bulk.GetPredScale());
+    ASSERT_EQ(single.GetEndExceptionCount(), bulk.GetEndExceptionCount());
+  }
+}
+}  // Anonymous namespace
+
+TEST(DSPAccelerator, BulkReadsOfLoopingStreams)
+{
+  // Loops which end on every kind of address, including the two which loop without an ACCOV.
+  for (u32 end : {0x100u, 0x101u, 0x102u, 0x107u, 0x10eu, 0x10fu, 0x3ffu})
+  {
+    for (u32 start : {0x2u, 0x25u, 0x10u})
+    {
+      for (u32 chunk_size : {1u, 5u, 14u, 16u, 100u, 333u})
+      {
+        CompareBulkReads({start, end, start, true}, chunk_size, 2000);
+      }
+    }
+  }
+}
+
+TEST(DSPAccelerator, BulkReadsStopAtEndOfNonLoopingVoices)
+{
+  for (u32 chunk_size : {1u, 14u, 333u})
+    CompareBulkReads({0x2, 0x107, 0x2, false}, chunk_size, 1000);
+
+  std::vector<u8> memory(0x100, 0x77);
+  for (u32 header = 0; header < memory.size(); header += 8)
+    memory[header] = 0x00;
+  std::array<s16, 16> coefs{};
+  ADPCMAccelerator accelerator(memory, false);
+  ConfigureADPCM(&accelerator, {0x2, 0x2f, 0x2, false}, 0x0);
+  std::vector<s16> samples(64);
+  accelerator.ReadSamples(coefs.data(), samples.data(), static_cast<u32>(samples.size()));
+
+  // 14 samples in each of the first two frames, and 14 up to and including the end address.
+  EXPECT_EQ(1u, accelerator.GetEndExceptionCount());
+  EXPECT_EQ(0x2u, accelerator.GetCurrentAddress());
+  EXPECT_TRUE(std::all_of(samples.begin(), samples.begin() + 42, [](s16 s) { return s == 7; }));
+  EXPECT_TRUE(std::all_of(samples.begin() + 42, samples.end(), [](s16 s) { return s == 0; }));
+}
+
+TEST(DSPAccelerator, BulkReadsUpdatePredictorAndScale)
+{
+  std::vector<u8> memory(0x100);
+  // First frame: coefficients 1 (coef1 = 1.0), scale 4, every sample adds 1 * 4.
+  std::fill(memory.begin(), memory.begin() + 8, 0x11);
+  memory[0] = 0x12;
+  // Second frame: coefficients 0 (no prediction), scale 8.
+  memory[8] = 0x03;
+  memory[9] = 0x7F;
+
+  std::array<s16, 16> coefs{};
+  coefs[2] = 0x800;
+  ADPCMAccelerator accelerator(memory, false);
+  ConfigureADPCM(&accelerator, {0x2, 0x100, 0x2, false}, 0x12);
+  accelerator.SetYn1(0);
+  accelerator.SetYn2(0);
+
+  std::array<s16, 16> samples;
+  accelerator.ReadSamples(coefs.data(), samples.data(), static_cast<u32>(samples.size()));
+  for (u32 i = 0; i < 14; ++i)
+    EXPECT_EQ(static_cast<s16>(4 * (i + 1)), samples[i]);
+  EXPECT_EQ(56, samples[14]);
+  EXPECT_EQ(-8, samples[15]);
+
+  EXPECT_EQ(0x03u, accelerator.GetPredScale());
+  EXPECT_EQ(-8, accelerator.GetYn1());
+  EXPECT_EQ(56, accelerator.GetYn2());
+  EXPECT_EQ(0x14u, accelerator.GetCurrentAddress());
+  EXPECT_EQ(0u, accelerator.GetEndExceptionCount());
+}
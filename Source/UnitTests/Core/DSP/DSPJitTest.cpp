@@ -0,0 +1,177 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MemoryUtil.h"
+#include "Common/MsgHandler.h"
+#include "Core/DSP/DSPAnalyzer.h"
+#include "Core/DSP/DSPCodeUtil.h"
+#include "Core/DSP/DSPCore.h"
+#include "Core/DSP/DSPTables.h"
+
+#include <gtest/gtest.h>
+
+// Runs small ucodes on both the interpreter and the JIT, and compares the resulting state.
+// The JIT is run with several cycle budgets per call, so that linked blocks and loops are also
+// left in the middle when the budget runs out.
+
+namespace
+{
+struct DSPState
+{
+  std::array<u16, 32> regs;
+  std::array<u8, 4> stack_ptrs;
+  std::vector<u16> dram;
+};
+
+// Test ucodes do not come with DSP ROMs, so the hash check must not stop initialization.
+bool IgnoreRomHashes(const char* caption, const char* text, bool yes_no, MsgType style)
+{
+  return false;
+}
+
+DSPState RunUCode(const std::vector<u16>& code, DSP::DSPInitOptions::CoreType core_type,
+                  int cycles_per_run)
+{
+  RegisterMsgAlertHandler(IgnoreRomHashes);
+  DSP::InitInstructionTable();
+
+  DSP::DSPInitOptions options;
+  options.irom_contents.fill(0);
+  options.coef_contents.fill(0);
+  options.core_type = core_type;
+  EXPECT_TRUE(DSP::DSPCore_Init(options));
+
+  Common::UnWriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+  std::copy(code.begin(), code.end(), DSP::g_dsp.iram);
+  Common::WriteProtectMemory(DSP::g_dsp.iram, DSP::DSP_IRAM_BYTE_SIZE, false);
+
+  // Input samples for the ucodes which read from DRAM.
+  for (u16 i = 0; i < 0x400; i++)
+    DSP::g_dsp.dram[i] = static_cast<u16>(i * 0x9e37 + 0x1234);
+
+  DSP::Analyzer::Analyze();
+  DSP::g_dsp.pc = 0;
+  DSP::g_dsp.cr &= ~DSP::CR_HALT;
+
+  for (int i = 0; i < 1000000 && !(DSP::g_dsp.cr & DSP::CR_HALT); i++)
+    DSP::DSPCore_RunCycles(cycles_per_run);
+  EXPECT_TRUE(DSP::g_dsp.cr & DSP::CR_HALT) << "The ucode did not halt";
+
+  DSPState state;
+  for (size_t i = 0; i < state.regs.size(); i++)
+    state.regs[i] = DSP::DSPCore_ReadRegister(i);
+  std::copy(std::begin(DSP::g_dsp.reg_stack_ptr), std::end(DSP::g_dsp.reg_stack_ptr),
+            state.stack_ptrs.begin());
+  state.dram.assign(DSP::g_dsp.dram, DSP::g_dsp.dram + DSP::DSP_DRAM_SIZE);
+
+  DSP::DSPCore_Shutdown();
+  return state;
+}
+
+void CompareWithInterpreter(const char* text)
+{
+  std::vector<u16> code;
+  ASSERT_TRUE(DSP::Assemble(text, code));
+
+  const DSPState expected = RunUCode(code, DSP::DSPInitOptions::CORE_INTERPRETER, 4000);
+  for (int cycles_per_run : {37, 500, 4000})
+  {
+    SCOPED_TRACE(cycles_per_run);
+    const DSPState actual = RunUCode(code, DSP::DSPInitOptions::CORE_JIT, cycles_per_run);
+
+    // HALT pops the call stack in the JIT, so the call stack and the PC are not compared. The
+    // JIT only computes the arithmetic flags which are read by a later branch.
+    for (size_t i = 0; i < expected.regs.size(); i++)
+    {
+      if (i == DSP::DSP_REG_SR)
+      {
+        EXPECT_EQ(expected.regs[i] & ~0xff, actual.regs[i] & ~0xff) << "register " << i;
+      }
+      else if (i != DSP::DSP_REG_ST0)
+      {
+        EXPECT_EQ(expected.regs[i], actual.regs[i]) << "register " << i;
+      }
+    }
+    for (size_t i = 1; i < expected.stack_ptrs.size(); i++)
+      EXPECT_EQ(expected.stack_ptrs[i], actual.stack_ptrs[i]) << "stack " << i;
+    EXPECT_TRUE(expected.dram == actual.dram);
+  }
+}
+}  // Anonymous namespace
+
+TEST(DSPJit, HardwareLoops)
+{
+  CompareWithInterpreter("	lri		$AR0, #0x0800\n"
+                         "	clr		$ACC0\n"
+                         "	clr		$ACC1\n"
+                         "	lri		$AX0.H, #0x0003\n"
+                         "	lri		$AX1.L, #0x0010\n"
+                         "	bloopi	#20, outer_end\n"
+                         "	loopi	#7\n"
+                         "	inc		$ACC0\n"
+                         "	bloop	$AX1.L, inner_end\n"
+                         "	addax	$ACC1, $AX0\n"
+                         "inner_end:\n"
+                         "	srri	@$AR0, $AC1.M\n"
+                         "outer_end:\n"
+                         "	srri	@$AR0, $AC0.M\n"
+                         "	halt\n");
+}
+
+TEST(DSPJit, ConditionalBranchLoops)
+{
+  CompareWithInterpreter("	lri		$AR1, #0x0800\n"
+                         "	clr		$ACC0\n"
+                         "	clr		$ACC1\n"
+                         "	lri		$AC1.M, #300\n"
+                         "count_loop:\n"
+                         "	addis	$AC0.M, #3\n"
+                         "	cmpi	$AC0.M, #100\n"
+                         "	jle		no_wrap\n"
+                         "	clr		$ACC0\n"
+                         "no_wrap:\n"
+                         "	srri	@$AR1, $AC0.M\n"
+                         "	decm	$AC1.M\n"
+                         "	jnz		count_loop\n"
+                         "	halt\n");
+}
+
+TEST(DSPJit, CallsInLoops)
+{
+  CompareWithInterpreter("	lri		$AR2, #0x0800\n"
+                         "	clr		$ACC0\n"
+                         "	bloopi	#50, call_end\n"
+                         "	call	add_seven\n"
+                         "call_end:\n"
+                         "	srri	@$AR2, $AC0.M\n"
+                         "	halt\n"
+                         "add_seven:\n"
+                         "	addis	$AC0.M, #7\n"
+                         "	ret\n");
+}
+
+// Scales a buffer of samples by a volume many times, like the voice mixing loops of the AX
+// ucodes. This is also a rough benchmark of the JIT against the interpreter.
+TEST(DSPJit, MixingLoop)
+{
+  CompareWithInterpreter("	lri		$AX1.H, #0x4000\n"
+                         "	lri		$AX1.L, #0x0400\n"
+                         "	bloopi	#64, pass_end\n"
+                         "	lri		$AR0, #0x0000\n"
+                         "	lri		$AR1, #0x0800\n"
+                         "	bloop	$AX1.L, sample_end\n"
+                         "	lrri	$AX0.H, @$AR0\n"
+                         "	mulx	$AX0.H, $AX1.H\n"
+                         "	movp	$ACC0\n"
+                         "sample_end:\n"
+                         "	srri	@$AR1, $AC0.M\n"
+                         "pass_end:\n"
+                         "	nop\n"
+                         "	halt\n");
+}
@@ -0,0 +1,308 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <ostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Core/HW/DSPHLE/UCodes/Zelda.h"
+#include "Core/HW/Memmap.h"
+
+using namespace DSP::HLE;
+
+namespace
+{
+// Renderer flags, see Zelda.cpp.
+constexpr u32 NO_ARAM = 0x01;
+constexpr u32 MAKE_DOLBY_LOUDER = 0x02;
+constexpr u32 VOLUME_EXPLICIT_STEP = 0x20;
+
+constexpr u16 NUM_VOICES = 24;
+constexpr u32 NUM_FRAMES = 20;
+constexpr u32 FRAME_SIZE = 0x50 * sizeof(u16);
+
+// Layout of the emulated RAM. With NO_ARAM, the ARAM sample sources also read from RAM.
+constexpr u32 VPB_ADDRESS = 0x10000;
+constexpr u32 VPB_SIZE = 0xC0 * sizeof(u16);
+constexpr u32 REVERB_PB_ADDRESS = 0x20000;
+constexpr u32 REVERB_PB_SIZE = 0x10 * sizeof(u16);
+constexpr u32 REVERB_BUFFER_ADDRESS = 0x21000;
+constexpr u32 REVERB_BUFFER_FRAMES = 3;
+constexpr u32 REVERB_BUFFER_SIZE = REVERB_BUFFER_FRAMES * FRAME_SIZE;
+constexpr u32 OUTPUT_LEFT_ADDRESS = 0x30000;
+constexpr u32 OUTPUT_RIGHT_ADDRESS = 0x38000;
+constexpr u32 SAMPLE_DATA_ADDRESS = 0x100000;
+constexpr u32 SAMPLE_DATA_SIZE = 0x10000;
+
+// Word offsets of the VPB fields the test sets.
+enum VPBField : u32
+{
+  VPB_ENABLED = 0x00,
+  VPB_RESAMPLING_RATIO = 0x02,
+  VPB_RESET = 0x04,
+  VPB_CHANNELS = 0x08,
+  VPB_DOLBY_VOICE_POSITION = 0x28,
+  VPB_DOLBY_REVERB_FACTOR = 0x29,
+  VPB_DOLBY_VOLUME_CURRENT = 0x2A,
+  VPB_DOLBY_VOLUME_TARGET = 0x2B,
+  VPB_USE_DOLBY_VOLUME = 0x2C,
+  VPB_CURRENT_POSITION = 0x34,
+  VPB_REMAINING_LENGTH = 0x3A,
+  VPB_SAMPLES_SOURCE_TYPE = 0x80,
+  VPB_IS_LOOPING = 0x81,
+  VPB_LOOP_YN1 = 0x82,
+  VPB_LOOP_YN2 = 0x83,
+  VPB_END_REQUESTED = 0x85,
+  VPB_LOOP_ADDRESS = 0x88,
+  VPB_LOOP_START_POSITION = 0x8A,
+  VPB_BASE_ADDRESS = 0x8C,
+};
+
+// Sample sources which decode, generate or download samples.
+constexpr std::array<u16, 7> SAMPLE_SOURCES = {{
+    9,   // AFC from ARAM, 4-bit samples
+    5,   // AFC from ARAM, 2-bit samples
+    16,  // PCM16 from ARAM
+    8,   // PCM8 from ARAM
+    33,  // PCM16 from MRAM
+    1,   // Saw wave
+    0,   // Square wave
+}};
+
+// Front, back and reverb mixing buffers, and an unused channel.
+constexpr std::array<u16, 9> CHANNEL_BUFFERS = {
+    {0x0D00, 0x0D60, 0x0E80, 0x0EE0, 0x0C00, 0x0C50, 0x0F40, 0x0CA0, 0}};
+
+// Hashes of the RAM regions the renderer writes to.
+struct RenderResult
+{
+  u64 output_left;
+  u64 output_right;
+  u64 reverb_buffers;
+  u64 vpbs;
+};
+
+bool operator==(const RenderResult& a, const RenderResult& b)
+{
+  return a.output_left == b.output_left && a.output_right == b.output_right &&
+         a.reverb_buffers == b.reverb_buffers && a.vpbs == b.vpbs;
+}
+
+std::ostream& operator<<(std::ostream& os, const RenderResult& result)
+{
+  return os << std::hex << "{0x" << result.output_left << ", 0x" << result.output_right << ", 0x"
+            << result.reverb_buffers << ", 0x" << result.vpbs << "}";
+}
+
+// Renders frames of random voices with every kind of mixing the renderer does: volume ramps,
+// Dolby voices, reverb and output volume.
+class ZeldaAudioTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_ram.assign(Memory::RAM_SIZE, 0);
+    Memory::m_pRAM = m_ram.data();
+  }
+
+  void TearDown() override { Memory::m_pRAM = nullptr; }
+
+  // The standard distributions differ between implementations, but the raw mt19937 output does
+  // not, so random values are derived from it directly.
+  u16 Random(u32 range) { return static_cast<u16>(m_rng() % range); }
+  s16 RandomSigned(u32 range) { return static_cast<s16>(Random(range * 2) - range); }
+
+  void Write16(u32 address, u16 value)
+  {
+    m_ram[address] = static_cast<u8>(value >> 8);
+    m_ram[address + 1] = static_cast<u8>(value);
+  }
+
+  void Write32(u32 address, u32 value)
+  {
+    Write16(address, static_cast<u16>(value >> 16));
+    Write16(address + 2, static_cast<u16>(value));
+  }
+
+  void SetVPBField(u16 voice, u32 field, u16 value)
+  {
+    Write16(VPB_ADDRESS + voice * VPB_SIZE + field * sizeof(u16), value);
+  }
+
+  void SetVPBField32(u16 voice, u32 field, u32 value)
+  {
+    Write32(VPB_ADDRESS + voice * VPB_SIZE + field * sizeof(u16), value);
+  }
+
+  u64 Hash(u32 address, u32 size) const
+  {
+    u64 hash = 0xcbf29ce484222325;
+    for (u32 i = address; i < address + size; ++i)
+      hash = (hash ^ m_ram[i]) * 0x100000001b3;
+    return hash;
+  }
+
+  void WriteVoice(u16 voice, u32 flags)
+  {
+    const u16 source = SAMPLE_SOURCES[voice % SAMPLE_SOURCES.size()];
+    SetVPBField(voice, VPB_ENABLED, 1);
+    SetVPBField(voice, VPB_RESET, 1);
+    SetVPBField(voice, VPB_SAMPLES_SOURCE_TYPE, source);
+    // Both interpolated and nearest neighbour resampling.
+    SetVPBField(voice, VPB_RESAMPLING_RATIO, 0x200 + Random(0x5000));
+    // Ending voices halve their volumes, which only works with target volumes.
+    if (!(flags & VOLUME_EXPLICIT_STEP))
+      SetVPBField(voice, VPB_END_REQUESTED, voice % 5 == 4);
+
+    if (voice % 4 == 3)
+    {
+      SetVPBField(voice, VPB_USE_DOLBY_VOLUME, 1);
+      SetVPBField(voice, VPB_DOLBY_VOICE_POSITION, Random(0x10000) & 0x7F7F);
+      SetVPBField(voice, VPB_DOLBY_REVERB_FACTOR, Random(0x8000));
+      SetVPBField(voice, VPB_DOLBY_VOLUME_CURRENT, Random(0x8000));
+      SetVPBField(voice, VPB_DOLBY_VOLUME_TARGET, Random(0x8000));
+    }
+    else
+    {
+      for (u32 channel = 0; channel < 6; ++channel)
+      {
+        const u32 field = VPB_CHANNELS + channel * 4;
+        SetVPBField(voice, field, CHANNEL_BUFFERS[Random(CHANNEL_BUFFERS.size())]);
+        // Explicit steps are small enough for the volumes to stay in range over all frames.
+        if (flags & VOLUME_EXPLICIT_STEP)
+          SetVPBField(voice, field + 1, RandomSigned(0x40));
+        else
+          SetVPBField(voice, field + 1, Random(0x8000));
+        SetVPBField(voice, field + 2, Random(0x7000));
+      }
+    }
+
+    // Short sounds, so that some of them end or loop within the frames. The positions count
+    // samples, and the addresses are relative to the ARAM base, except for MRAM samples.
+    const u32 length = 0x100 + Random(0x2F00);
+    const u32 loop_address = Random(length);
+    SetVPBField(voice, VPB_IS_LOOPING, voice % 2);
+    SetVPBField(voice, VPB_LOOP_YN1, RandomSigned(0x8000));
+    SetVPBField(voice, VPB_LOOP_YN2, RandomSigned(0x8000));
+    SetVPBField32(voice, VPB_LOOP_START_POSITION, length);
+    if (source == 33)
+    {
+      const u32 base = SAMPLE_DATA_ADDRESS + Random(SAMPLE_DATA_SIZE / 2) * 2;
+      SetVPBField32(voice, VPB_BASE_ADDRESS, base);
+      SetVPBField32(voice, VPB_LOOP_ADDRESS, base + loop_address * 2);
+      SetVPBField32(voice, VPB_REMAINING_LENGTH, length * 2);
+      // Only the upper half of the position is used for MRAM samples.
+      SetVPBField32(voice, VPB_LOOP_START_POSITION, length << 16);
+    }
+    else
+    {
+      SetVPBField32(voice, VPB_BASE_ADDRESS, Random(SAMPLE_DATA_SIZE / 2) & ~1);
+      SetVPBField32(voice, VPB_LOOP_ADDRESS, loop_address);
+      SetVPBField32(voice, VPB_CURRENT_POSITION, loop_address / 2);
+    }
+  }
+
+  RenderResult Render(u32 flags, u32 seed)
+  {
+    m_rng.seed(seed);
+    ZeldaAudioRenderer renderer;
+    renderer.SetFlags(flags);
+
+    std::array<s16, 0x80> sine_table;
+    for (s16& value : sine_table)
+      value = Random(0x8000);
+    renderer.SetSineTable(std::move(sine_table));
+    std::array<s16, 0x100> resampling_coeffs;
+    for (s16& value : resampling_coeffs)
+      value = RandomSigned(0x8000);
+    renderer.SetResamplingCoeffs(std::move(resampling_coeffs));
+    // Real AFC coefficients are well below 1.0 in 5.11 format.
+    std::array<s16, 0x20> afc_coeffs;
+    for (s16& value : afc_coeffs)
+      value = RandomSigned(0x1000);
+    renderer.SetAfcCoeffs(std::move(afc_coeffs));
+
+    for (u32 i = 0; i < SAMPLE_DATA_SIZE; ++i)
+      m_ram[SAMPLE_DATA_ADDRESS + i] = static_cast<u8>(m_rng());
+    renderer.SetARAMBaseAddr(SAMPLE_DATA_ADDRESS);
+
+    for (u16 voice = 0; voice < NUM_VOICES; ++voice)
+      WriteVoice(voice, flags);
+    renderer.SetVPBBaseAddress(VPB_ADDRESS);
+
+    // The first reverb PB is disabled, and the others filter before or after mixing the
+    // previous frames into the front buffers.
+    for (u32 rpb = 0; rpb < 4; ++rpb)
+    {
+      const u32 address = REVERB_PB_ADDRESS + rpb * REVERB_PB_SIZE;
+      const u32 buffer = REVERB_BUFFER_ADDRESS + rpb * REVERB_BUFFER_SIZE;
+      Write16(address, rpb == 3 ? 2 : rpb != 0);
+      Write16(address + 2, REVERB_BUFFER_FRAMES);
+      Write32(address + 4, buffer);
+      Write16(address + 8, rpb % 2 ? 0x0D60 : 0x0D00);
+      Write16(address + 10, Random(0x10000));
+      Write16(address + 12, rpb % 2 ? 0x0EE0 : 0x0E80);
+      Write16(address + 14, Random(0x10000));
+      for (u32 i = 0; i < 8; ++i)
+        Write16(address + 16 + i * 2, RandomSigned(0x1000));
+      for (u32 i = 0; i < REVERB_BUFFER_SIZE; ++i)
+        m_ram[buffer + i] = static_cast<u8>(m_rng());
+    }
+    renderer.SetReverbPBBaseAddress(REVERB_PB_ADDRESS);
+
+    renderer.SetOutputVolume(Random(0x10000));
+    renderer.SetOutputLeftBufferAddr(OUTPUT_LEFT_ADDRESS);
+    renderer.SetOutputRightBufferAddr(OUTPUT_RIGHT_ADDRESS);
+
+    for (u32 frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+      renderer.PrepareFrame();
+      for (u16 voice = 0; voice < NUM_VOICES; ++voice)
+        renderer.AddVoice(voice);
+      renderer.FinalizeFrame();
+    }
+
+    return {Hash(OUTPUT_LEFT_ADDRESS, NUM_FRAMES * FRAME_SIZE),
+            Hash(OUTPUT_RIGHT_ADDRESS, NUM_FRAMES * FRAME_SIZE),
+            Hash(REVERB_BUFFER_ADDRESS, 4 * REVERB_BUFFER_SIZE),
+            Hash(VPB_ADDRESS, NUM_VOICES * VPB_SIZE)};
+  }
+
+  u32 CountSilentOutputSamples() const
+  {
+    u32 count = 0;
+    for (u32 i = 0; i < NUM_FRAMES * FRAME_SIZE; i += 2)
+      count += m_ram[OUTPUT_LEFT_ADDRESS + i] == 0 && m_ram[OUTPUT_LEFT_ADDRESS + i + 1] == 0;
+    return count;
+  }
+
+  std::vector<u8> m_ram;
+  std::mt19937 m_rng;
+};
+}  // namespace
+
+// The expected hashes were recorded with the scalar mixing and AFC decoding code, which the
+// vectorized kernels must match bit for bit.
+TEST_F(ZeldaAudioTest, RenderedFramesMatchScalarRenderer)
+{
+  const RenderResult result = Render(NO_ARAM, 1);
+  EXPECT_LT(CountSilentOutputSamples(), NUM_FRAMES * 0x50 / 10);
+  EXPECT_EQ((RenderResult{0xaad4837d0b47c569, 0x0f172fe98e5b9542, 0x4b886cf8d333c5d4,
+                          0x272e80085eca49a1}),
+            result);
+}
+
+TEST_F(ZeldaAudioTest, RenderedFramesWithExplicitVolumeStepsMatchScalarRenderer)
+{
+  const RenderResult result = Render(NO_ARAM | MAKE_DOLBY_LOUDER | VOLUME_EXPLICIT_STEP, 2);
+  EXPECT_LT(CountSilentOutputSamples(), NUM_FRAMES * 0x50 / 10);
+  EXPECT_EQ((RenderResult{0x086be086dab25a46, 0x03f3a8841a7ea241, 0xdd71a5324574b3da,
+                          0x65fd77804373d166}),
+            result);
+}
@@ -0,0 +1,143 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MemoryUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+
+namespace
+{
+constexpr u32 TRACKED_ADDRESS = 0x10000;
+constexpr u32 TRACKED_SIZE = 0x100;
+
+class WriteTrackingTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    SConfig::Init();
+    Memory::Init();
+    EMM::InstallExceptionHandler();
+    Memory::SetWriteTrackingEnabled(true);
+  }
+
+  void TearDown() override
+  {
+    Memory::SetWriteTrackingEnabled(false);
+    EMM::UninstallExceptionHandler();
+    Memory::Shutdown();
+    SConfig::Shutdown();
+  }
+
+  // A guest write, which faults if the page is tracked.
+  static void Write(u32 address, u8 value)
+  {
+    *static_cast<volatile u8*>(&Memory::m_pRAM[address]) = value;
+  }
+};
+}  // namespace
+
+TEST_F(WriteTrackingTest, UnwrittenRangeIsNotReported)
+{
+  // Write tracking is not available on every host.
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  EXPECT_FALSE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+}
+
+TEST_F(WriteTrackingTest, WriteIsReportedAndReachesMemory)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  Write(TRACKED_ADDRESS + TRACKED_SIZE - 1, 0x42);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+  EXPECT_EQ(0x42, Memory::m_pRAM[TRACKED_ADDRESS + TRACKED_SIZE - 1]);
+}
+
+TEST_F(WriteTrackingTest, WriteToAnotherPageIsNotReported)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u32 page_size = static_cast<u32>(Common::MemPageSize());
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  Memory::TrackWrites(TRACKED_ADDRESS + 4 * page_size, TRACKED_SIZE);
+  Write(TRACKED_ADDRESS + 4 * page_size, 0x42);
+  EXPECT_FALSE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+}
+
+TEST_F(WriteTrackingTest, TrackingAgainStartsOver)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u64 first_stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  Write(TRACKED_ADDRESS, 0x42);
+  const u64 second_stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, first_stamp));
+  EXPECT_FALSE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, second_stamp));
+
+  Write(TRACKED_ADDRESS, 0x43);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, second_stamp));
+}
+
+TEST_F(WriteTrackingTest, HostWriteIsReported)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  Memory::PrepareForHostWrite(TRACKED_ADDRESS, 4);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+
+  // The page is writable again, as a system call would need it to be.
+  std::memset(&Memory::m_pRAM[TRACKED_ADDRESS], 0x42, 4);
+  EXPECT_EQ(0x42, Memory::m_pRAM[TRACKED_ADDRESS + 3]);
+}
+
+TEST_F(WriteTrackingTest, DisablingForgetsEveryStamp)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  Memory::SetWriteTrackingEnabled(false);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+
+  // Writes while disabled are not seen, so older stamps stay invalid after enabling again.
+  Write(TRACKED_ADDRESS, 0x42);
+  Memory::SetWriteTrackingEnabled(true);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+}
+
+TEST_F(WriteTrackingTest, MemoryOutsideOfRAMIsAlwaysReported)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  const u32 mmio_address = 0x0C000000;
+  const u64 stamp = Memory::TrackWrites(mmio_address, TRACKED_SIZE);
+  EXPECT_TRUE(Memory::WasWrittenSince(mmio_address, TRACKED_SIZE, stamp));
+}
+
+TEST(WriteTracking, DisabledTrackingReportsEveryRange)
+{
+  SConfig::Init();
+  Memory::Init();
+  const u64 stamp = Memory::TrackWrites(TRACKED_ADDRESS, TRACKED_SIZE);
+  EXPECT_TRUE(Memory::WasWrittenSince(TRACKED_ADDRESS, TRACKED_SIZE, stamp));
+  EXPECT_FALSE(Memory::HandleWriteTrackingFault(reinterpret_cast<uintptr_t>(Memory::m_pRAM)));
+  Memory::Shutdown();
+  SConfig::Shutdown();
+}
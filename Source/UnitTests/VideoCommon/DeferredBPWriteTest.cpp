@@ -0,0 +1,194 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/BPMemory.h"
+#include "VideoCommon/BPStructs.h"
+#include "VideoCommon/PixelShaderManager.h"
+
+namespace
+{
+// The state a batch of vertices is drawn with: the registers, and the constants derived from them.
+struct DrawState
+{
+  u32 fog_color;
+  u32 bias;
+  std::array<s32, 3> fog_color_constant;
+  s32 bias_constant;
+
+  bool operator==(const DrawState& other) const
+  {
+    return fog_color == other.fog_color && bias == other.bias &&
+           fog_color_constant == other.fog_color_constant && bias_constant == other.bias_constant;
+  }
+};
+
+struct Draw
+{
+  DrawState state;
+  u32 vertices;
+
+  bool operator==(const Draw& other) const
+  {
+    return state == other.state && vertices == other.vertices;
+  }
+};
+
+// Follows the protocol VertexManagerBase and BPWritten use for deferred writes, without a backend.
+class Batcher
+{
+public:
+  explicit Batcher(bool defer) : m_defer(defer) {}
+
+  void WriteRegister(u32 address, u32 value)
+  {
+    if (m_pending_vertices != 0)
+    {
+      if (m_defer)
+        DeferBPWrite(address);
+      else
+        Flush();
+    }
+
+    reinterpret_cast<u32*>(&bpmem)[address] = value;
+    if (address == BPMEM_FOGCOLOR)
+      PixelShaderManager::SetFogColorChanged();
+    else
+      PixelShaderManager::SetZTextureBias();
+  }
+
+  void AddVertices(u32 count)
+  {
+    if (m_pending_vertices != 0 && HasDeferredBPWrites() && !DiscardRedundantDeferredBPWrites())
+      Flush();
+    m_pending_vertices += count;
+  }
+
+  void Flush()
+  {
+    if (m_pending_vertices == 0)
+      return;
+
+    std::optional<BPMemory> current_state;
+    if (HasDeferredBPWrites())
+      current_state.emplace(LoadPendingBPState());
+
+    const auto& constants = PixelShaderManager::constants;
+    const DrawState state = {bpmem.fog.color.hex,
+                             bpmem.ztex1.hex,
+                             {constants.fogcolor[0], constants.fogcolor[1], constants.fogcolor[2]},
+                             constants.zbias[1][3]};
+    // Batches with the same state would have been drawn as one with the other mode.
+    if (!m_draws.empty() && m_draws.back().state == state)
+      m_draws.back().vertices += m_pending_vertices;
+    else
+      m_draws.push_back({state, m_pending_vertices});
+    m_pending_vertices = 0;
+
+    if (current_state)
+      ApplyDeferredBPWrites(*current_state);
+  }
+
+  const std::vector<Draw>& GetDraws() const { return m_draws; }
+
+private:
+  bool m_defer;
+  u32 m_pending_vertices = 0;
+  std::vector<Draw> m_draws;
+};
+
+class DeferredBPWriteTest : public testing::Test
+{
+protected:
+  void SetUp() override { Reset(); }
+
+  static void Reset()
+  {
+    BPInit();
+    PixelShaderManager::Init();
+  }
+
+  // Runs the same writes and draws through both modes, and returns the draws of each.
+  static std::array<std::vector<Draw>, 2> Run(u32 seed, int operations)
+  {
+    std::array<std::vector<Draw>, 2> draws;
+    for (bool defer : {false, true})
+    {
+      Reset();
+
+      // Few distinct values, so that games setting the same state again are covered.
+      std::mt19937 rng(seed);
+      std::uniform_int_distribution<int> operation(0, 3);
+      std::uniform_int_distribution<u32> value(0, 2);
+      Batcher batcher(defer);
+      for (int i = 0; i < operations; i++)
+      {
+        switch (operation(rng))
+        {
+        case 0:
+          batcher.WriteRegister(BPMEM_FOGCOLOR, value(rng) * 0x102030);
+          break;
+        case 1:
+          batcher.WriteRegister(BPMEM_BIAS, value(rng) * 0x1234);
+          break;
+        default:
+          batcher.AddVertices(value(rng) + 1);
+          break;
+        }
+      }
+      batcher.Flush();
+      draws[defer] = batcher.GetDraws();
+    }
+    return draws;
+  }
+};
+}  // namespace
+
+TEST_F(DeferredBPWriteTest, RedundantWritesKeepBatching)
+{
+  Batcher batcher(true);
+  batcher.AddVertices(3);
+  batcher.WriteRegister(BPMEM_FOGCOLOR, 0x102030);
+  batcher.WriteRegister(BPMEM_FOGCOLOR, 0);
+  batcher.AddVertices(3);
+  batcher.Flush();
+
+  ASSERT_EQ(1u, batcher.GetDraws().size());
+  EXPECT_EQ(6u, batcher.GetDraws()[0].vertices);
+  EXPECT_EQ(0u, batcher.GetDraws()[0].state.fog_color);
+}
+
+TEST_F(DeferredBPWriteTest, PendingVerticesAreDrawnWithTheirState)
+{
+  Batcher batcher(true);
+  batcher.AddVertices(3);
+  batcher.WriteRegister(BPMEM_BIAS, 0x1234);
+  batcher.AddVertices(3);
+  batcher.Flush();
+
+  const std::vector<Draw>& draws = batcher.GetDraws();
+  ASSERT_EQ(2u, draws.size());
+  EXPECT_EQ(0u, draws[0].state.bias);
+  EXPECT_EQ(0, draws[0].state.bias_constant);
+  EXPECT_EQ(0x1234u, draws[1].state.bias);
+  EXPECT_EQ(0x1234, draws[1].state.bias_constant);
+  EXPECT_EQ(0x1234u, bpmem.ztex1.hex);
+  EXPECT_FALSE(HasDeferredBPWrites());
+}
+
+TEST_F(DeferredBPWriteTest, DeferredDrawsMatchImmediateDraws)
+{
+  for (u32 seed = 0; seed < 100; seed++)
+  {
+    const std::array<std::vector<Draw>, 2> draws = Run(seed, 200);
+    EXPECT_EQ(draws[false], draws[true]) << "seed " << seed;
+  }
+}
@@ -0,0 +1,200 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/Swap.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/MemTools.h"
+#include "VideoCommon/CPMemory.h"
+#include "VideoCommon/DataReader.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/Statistics.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+constexpr u32 LIST_ADDRESS = 0x10000;
+constexpr u32 LIST_SIZE = 32;
+// CP register holding the base address of vertex array 0.
+constexpr u8 ARRAY_BASE_REGISTER = 0xA0;
+
+class DisplayListCacheTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    SConfig::Init();
+    Memory::Init();
+    EMM::InstallExceptionHandler();
+    Memory::SetWriteTrackingEnabled(true);
+    g_ActiveConfig.bDisplayListCache = true;
+    OpcodeDecoder::Init();
+    stats.ResetFrame();
+
+    // The list loads the base address of vertex array 0, and is padded with NOPs.
+    Memory::Write_U8(OpcodeDecoder::GX_LOAD_CP_REG, LIST_ADDRESS);
+    Memory::Write_U8(ARRAY_BASE_REGISTER, LIST_ADDRESS + 1);
+    Memory::Write_U32(0x1000, LIST_ADDRESS + 2);
+    for (u32 i = 6; i < LIST_SIZE; i++)
+      Memory::Write_U8(OpcodeDecoder::GX_NOP, LIST_ADDRESS + i);
+  }
+
+  void TearDown() override
+  {
+    OpcodeDecoder::Init();
+    g_ActiveConfig.bDisplayListCache = false;
+    Memory::SetWriteTrackingEnabled(false);
+    EMM::UninstallExceptionHandler();
+    Memory::Shutdown();
+    SConfig::Shutdown();
+  }
+
+  // Runs a FIFO command calling a display list, and returns the cycles it took.
+  static u32 RunCallDisplayList(u32 list_address, u32 list_size)
+  {
+    std::array<u8, 9> fifo;
+    fifo[0] = OpcodeDecoder::GX_CMD_CALL_DL;
+    const u32 address = Common::swap32(list_address);
+    const u32 size = Common::swap32(list_size);
+    std::memcpy(&fifo[1], &address, sizeof(address));
+    std::memcpy(&fifo[5], &size, sizeof(size));
+
+    u32 cycles = 0;
+    OpcodeDecoder::Run(DataReader(fifo.data(), fifo.data() + fifo.size()), &cycles, false);
+    return cycles;
+  }
+
+  // Calls the display list, and returns the array base it loaded.
+  static u32 CallDisplayList()
+  {
+    g_main_cp_state.array_bases[0] = 0;
+    RunCallDisplayList(LIST_ADDRESS, LIST_SIZE);
+    return g_main_cp_state.array_bases[0];
+  }
+};
+}  // namespace
+
+TEST_F(DisplayListCacheTest, UnchangedListIsReplayed)
+{
+  // Write tracking is not available on every host, and the cache is off without it.
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(2, stats.thisFrame.numDListsReplayed);
+}
+
+TEST_F(DisplayListCacheTest, GuestWriteInvalidatesList)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  Memory::Write_U32(0x2000, LIST_ADDRESS + 2);
+  EXPECT_EQ(0x2000u, CallDisplayList());
+  EXPECT_EQ(0, stats.thisFrame.numDListsReplayed);
+
+  // The list is cached again after being decoded.
+  EXPECT_EQ(0x2000u, CallDisplayList());
+  EXPECT_EQ(1, stats.thisFrame.numDListsReplayed);
+}
+
+TEST_F(DisplayListCacheTest, VertexStateChangeInvalidatesList)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  g_main_cp_state.vtx_attr[0].g0.PosElements = !g_main_cp_state.vtx_attr[0].g0.PosElements;
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(0, stats.thisFrame.numDListsReplayed);
+
+  g_main_cp_state.vtx_desc.Position = g_main_cp_state.vtx_desc.Position ^ 1;
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(0, stats.thisFrame.numDListsReplayed);
+
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  EXPECT_EQ(1, stats.thisFrame.numDListsReplayed);
+}
+
+TEST_F(DisplayListCacheTest, CacheIsOffWithoutWriteTracking)
+{
+  Memory::SetWriteTrackingEnabled(false);
+  EXPECT_EQ(0x1000u, CallDisplayList());
+  Memory::Write_U32(0x2000, LIST_ADDRESS + 2);
+  EXPECT_EQ(0x2000u, CallDisplayList());
+  EXPECT_EQ(0x2000u, CallDisplayList());
+  EXPECT_EQ(0, stats.thisFrame.numDListsReplayed);
+}
+
+TEST_F(DisplayListCacheTest, ReplayMatchesInterpretedList)
+{
+  if (!Memory::IsWriteTrackingEnabled())
+    return;
+
+  // A list which loads several CP registers, including vertex state, between NOPs.
+  constexpr u32 address = 0x20000;
+  constexpr std::array<std::pair<u8, u32>, 5> loads = {{{0xA0, 0x1000},
+                                                        {0xB0, 12},
+                                                        {0xA1, 0x2000},
+                                                        {0x71, 0x40000013},
+                                                        {0x91, 0x80000000}}};
+  u32 size = 0;
+  for (const auto& load : loads)
+  {
+    Memory::Write_U8(OpcodeDecoder::GX_NOP, address + size);
+    Memory::Write_U8(OpcodeDecoder::GX_LOAD_CP_REG, address + size + 1);
+    Memory::Write_U8(load.first, address + size + 2);
+    Memory::Write_U32(load.second, address + size + 3);
+    size += 7;
+  }
+  for (; size % 32 != 0; size++)
+    Memory::Write_U8(OpcodeDecoder::GX_NOP, address + size);
+
+  struct Result
+  {
+    u32 cycles;
+    u32 array_bases[2];
+    u32 array_stride;
+    u32 vat_a;
+    u32 vat_c;
+  };
+  const auto call_list = [&] {
+    g_main_cp_state.array_bases[0] = 0;
+    g_main_cp_state.array_bases[1] = 0;
+    g_main_cp_state.array_strides[0] = 0;
+    g_main_cp_state.vtx_attr[1].g0.Hex = 0;
+    g_main_cp_state.vtx_attr[1].g2.Hex = 0;
+    const u32 cycles = RunCallDisplayList(address, size);
+    return Result{cycles,
+                  {g_main_cp_state.array_bases[0], g_main_cp_state.array_bases[1]},
+                  g_main_cp_state.array_strides[0],
+                  g_main_cp_state.vtx_attr[1].g0.Hex,
+                  g_main_cp_state.vtx_attr[1].g2.Hex};
+  };
+
+  g_ActiveConfig.bDisplayListCache = false;
+  const Result interpreted = call_list();
+  g_ActiveConfig.bDisplayListCache = true;
+  call_list();
+  const Result replayed = call_list();
+  ASSERT_EQ(1, stats.thisFrame.numDListsReplayed);
+
+  EXPECT_EQ(interpreted.cycles, replayed.cycles);
+  EXPECT_EQ(0x1000u, replayed.array_bases[0]);
+  EXPECT_EQ(interpreted.array_bases[0], replayed.array_bases[0]);
+  EXPECT_EQ(interpreted.array_bases[1], replayed.array_bases[1]);
+  EXPECT_EQ(interpreted.array_stride, replayed.array_stride);
+  EXPECT_EQ(interpreted.vat_a, replayed.vat_a);
+  EXPECT_EQ(interpreted.vat_c, replayed.vat_c);
+}
@@ -0,0 +1,220 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>  // NOLINT
+
+#include "Common/CommonTypes.h"
+#include "VideoCommon/IndexGenerator.h"
+#include "VideoCommon/OpcodeDecoding.h"
+#include "VideoCommon/VideoConfig.h"
+
+namespace
+{
+using Triangle = std::array<u16, 3>;
+
+constexpr u16 PRIMITIVE_RESTART = UINT16_MAX;
+
+// Rotates a triangle so that its smallest index comes first, keeping the winding.
+Triangle Normalize(Triangle tri)
+{
+  std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+  return tri;
+}
+
+// The triangles GX draws for a primitive, as the scalar index generator always produced them.
+std::vector<Triangle> ExpectedTriangles(int primitive, u32 num_verts, u16 base)
+{
+  std::vector<Triangle> triangles;
+  const auto add = [&](u32 a, u32 b, u32 c) {
+    triangles.push_back(Normalize({u16(base + a), u16(base + b), u16(base + c)}));
+  };
+
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_QUADS:
+  case OpcodeDecoder::GX_DRAW_QUADS_2:
+    for (u32 i = 0; i + 4 <= num_verts; i += 4)
+    {
+      add(i, i + 1, i + 2);
+      add(i, i + 2, i + 3);
+    }
+    if (num_verts % 4 == 3)
+      add(num_verts - 3, num_verts - 2, num_verts - 1);
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLES:
+    for (u32 i = 0; i + 3 <= num_verts; i += 3)
+      add(i, i + 1, i + 2);
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP:
+    for (u32 i = 2; i < num_verts; i++)
+    {
+      if (i % 2 == 0)
+        add(i - 2, i - 1, i);
+      else
+        add(i - 2, i, i - 1);
+    }
+    break;
+  case OpcodeDecoder::GX_DRAW_TRIANGLE_FAN:
+    for (u32 i = 2; i < num_verts; i++)
+      add(0, i - 1, i);
+    break;
+  }
+
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+// Decodes an index buffer as a triangle list, or as triangle strips split by primitive restart.
+std::vector<Triangle> DecodeTriangles(const std::vector<u16>& indices, bool primitive_restart)
+{
+  std::vector<Triangle> triangles;
+  if (!primitive_restart)
+  {
+    for (size_t i = 0; i + 3 <= indices.size(); i += 3)
+      triangles.push_back(Normalize({indices[i], indices[i + 1], indices[i + 2]}));
+  }
+  else
+  {
+    size_t strip_start = 0;
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+      if (indices[i] == PRIMITIVE_RESTART)
+      {
+        strip_start = i + 1;
+        continue;
+      }
+      const size_t j = i - strip_start;
+      if (j < 2)
+        continue;
+      if (j % 2 == 0)
+        triangles.push_back(Normalize({indices[i - 2], indices[i - 1], indices[i]}));
+      else
+        triangles.push_back(Normalize({indices[i - 1], indices[i - 2], indices[i]}));
+    }
+  }
+
+  // Strips may draw degenerate triangles, which are invisible.
+  triangles.erase(std::remove_if(triangles.begin(), triangles.end(),
+                                 [](const Triangle& tri) {
+                                   return tri[0] == tri[1] || tri[1] == tri[2] ||
+                                          tri[0] == tri[2];
+                                 }),
+                  triangles.end());
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+std::vector<u16> ExpectedIndices(int primitive, u32 num_verts, u16 base)
+{
+  std::vector<u16> indices;
+  switch (primitive)
+  {
+  case OpcodeDecoder::GX_DRAW_LINES:
+    for (u32 i = 1; i < num_verts; i += 2)
+      indices.insert(indices.end(), {u16(base + i - 1), u16(base + i)});
+    break;
+  case OpcodeDecoder::GX_DRAW_LINE_STRIP:
+    for (u32 i = 1; i < num_verts; i++)
+      indices.insert(indices.end(), {u16(base + i - 1), u16(base + i)});
+    break;
+  case OpcodeDecoder::GX_DRAW_POINTS:
+    for (u32 i = 0; i < num_verts; i++)
+      indices.push_back(u16(base + i));
+    break;
+  }
+  return indices;
+}
+
+std::vector<u16> GenerateIndices(int primitive, u32 num_verts, u32 base)
+{
+  std::vector<u16> buffer(8 * num_verts + 64, 0xCDCD);
+  IndexGenerator::Start(buffer.data());
+  // Draw some points first to move the base index.
+  if (base)
+    IndexGenerator::AddIndices(OpcodeDecoder::GX_DRAW_POINTS, base);
+  const u32 start = IndexGenerator::GetIndexLen();
+  IndexGenerator::AddIndices(primitive, num_verts);
+  const u32 end = IndexGenerator::GetIndexLen();
+
+  // Nothing must be written past the end of the generated indices.
+  EXPECT_EQ(0xCDCD, buffer[end]);
+  return std::vector<u16>(buffer.begin() + start, buffer.begin() + end);
+}
+}  // Anonymous namespace
+
+class IndexGeneratorTest : public testing::TestWithParam<bool>
+{
+protected:
+  void SetUp() override
+  {
+    g_Config.backend_info.bSupportsPrimitiveRestart = GetParam();
+    IndexGenerator::Init();
+  }
+};
+
+TEST_P(IndexGeneratorTest, Triangles)
+{
+  const bool primitive_restart = GetParam();
+  for (int primitive : {OpcodeDecoder::GX_DRAW_QUADS, OpcodeDecoder::GX_DRAW_QUADS_2,
+                        OpcodeDecoder::GX_DRAW_TRIANGLES, OpcodeDecoder::GX_DRAW_TRIANGLE_STRIP,
+                        OpcodeDecoder::GX_DRAW_TRIANGLE_FAN})
+  {
+    for (u32 base : {0, 1, 7})
+    {
+      for (u32 num_verts = 0; num_verts < 100; num_verts++)
+      {
+        SCOPED_TRACE(testing::Message() << "primitive " << primitive << ", base " << base
+                                        << ", " << num_verts << " vertices");
+        const std::vector<u16> indices = GenerateIndices(primitive, num_verts, base);
+        EXPECT_EQ(ExpectedTriangles(primitive, num_verts, base),
+                  DecodeTriangles(indices, primitive_restart));
+      }
+    }
+  }
+}
+
+TEST_P(IndexGeneratorTest, LinesAndPoints)
+{
+  for (int primitive : {OpcodeDecoder::GX_DRAW_LINES, OpcodeDecoder::GX_DRAW_LINE_STRIP,
+                        OpcodeDecoder::GX_DRAW_POINTS})
+  {
+    for (u32 base : {0, 1, 7})
+    {
+      for (u32 num_verts = 0; num_verts < 100; num_verts++)
+      {
+        SCOPED_TRACE(testing::Message() << "primitive " << primitive << ", base " << base
+                                        << ", " << num_verts << " vertices");
+        EXPECT_EQ(ExpectedIndices(primitive, num_verts, base),
+                  GenerateIndices(primitive, num_verts, base));
+      }
+    }
+  }
+}
+
+TEST_P(IndexGeneratorTest, Speed)
+{
+  // Fills the index buffer over and over with every primitive type at a range of sizes, from the
+  // small draws most games issue to large batched ones.
+  std::vector<u16> buffer(65536 * 8);
+  for (int iteration = 0; iteration < 100; iteration++)
+  {
+    for (int primitive = 0; primitive < 8; primitive++)
+    {
+      for (u32 num_verts : {3, 4, 6, 16, 64, 256, 1024, 4096})
+      {
+        IndexGenerator::Start(buffer.data());
+        while (IndexGenerator::GetRemainingIndices() > num_verts)
+          IndexGenerator::AddIndices(primitive, num_verts);
+      }
+    }
+  }
+}
+
+extern int gtest_PrimitiveRestartIndexGeneratorTest_dummy_;
+INSTANTIATE_TEST_CASE_P(PrimitiveRestart, IndexGeneratorTest, testing::Bool());
@@ -0,0 +1,131 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "VideoCommon/AbstractStagingTexture.h"
+#include "VideoCommon/PendingEFBCopies.h"
+#include "VideoCommon/TextureConfig.h"
+
+namespace
+{
+constexpr u32 BYTES_PER_ROW = 8;
+constexpr u32 NUM_ROWS = 2;
+constexpr u32 MEMORY_STRIDE = 16;
+
+// A readback texture whose encoded EFB copy is filled with a single value.
+class FakeStagingTexture final : public AbstractStagingTexture
+{
+public:
+  explicit FakeStagingTexture(u8 value)
+      : AbstractStagingTexture(StagingTextureType::Readback,
+                               TextureConfig(BYTES_PER_ROW / sizeof(u32), NUM_ROWS, 1, 1, 1,
+                                             AbstractTextureFormat::BGRA8, false)),
+        m_data(BYTES_PER_ROW * NUM_ROWS, value)
+  {
+  }
+
+  void CopyFromTexture(const AbstractTexture*, const MathUtil::Rectangle<int>&, u32, u32,
+                       const MathUtil::Rectangle<int>&) override
+  {
+  }
+  void CopyToTexture(const MathUtil::Rectangle<int>&, AbstractTexture*,
+                     const MathUtil::Rectangle<int>&, u32, u32) override
+  {
+  }
+
+  bool Map() override
+  {
+    m_map_pointer = reinterpret_cast<char*>(m_data.data());
+    m_map_stride = BYTES_PER_ROW;
+    return true;
+  }
+  void Unmap() override { m_map_pointer = nullptr; }
+  void Flush() override {}
+
+private:
+  std::vector<u8> m_data;
+};
+
+class PendingEFBCopiesTest : public testing::Test
+{
+protected:
+  void Add(u32 address, u8 value)
+  {
+    m_copies.Add({address, BYTES_PER_ROW, NUM_ROWS, MEMORY_STRIDE, false, 0,
+                  std::make_unique<FakeStagingTexture>(value)});
+  }
+
+  // Writes the pending copies to RAM the way TextureCacheBase does.
+  PendingEFBCopies::StagingTextures Flush()
+  {
+    return m_copies.Flush([this](const PendingEFBCopies::Copy& copy) {
+      const MathUtil::Rectangle<int> rect(0, 0, copy.bytes_per_row / sizeof(u32),
+                                          copy.num_blocks_y);
+      copy.texture->ReadTexels(rect, &m_ram[copy.dst_addr], copy.memory_stride);
+    });
+  }
+
+  PendingEFBCopies m_copies;
+  std::array<u8, 64> m_ram{};
+};
+}  // namespace
+
+TEST_F(PendingEFBCopiesTest, FlushWritesEveryRowOfTheCopy)
+{
+  Add(0, 0x11);
+  EXPECT_EQ(1u, Flush().size());
+  EXPECT_TRUE(m_copies.IsEmpty());
+
+  for (u32 i = 0; i < MEMORY_STRIDE * NUM_ROWS; i++)
+  {
+    // Only bytes_per_row of every memory_stride bytes are written.
+    EXPECT_EQ(i % MEMORY_STRIDE < BYTES_PER_ROW ? 0x11 : 0, m_ram[i]) << "offset " << i;
+  }
+}
+
+TEST_F(PendingEFBCopiesTest, LaterCopiesOverwriteEarlierOnes)
+{
+  Add(0, 0x11);
+  Add(BYTES_PER_ROW / 2, 0x22);
+  Add(0, 0x33);
+  Flush();
+
+  EXPECT_EQ(0x33, m_ram[0]);
+  EXPECT_EQ(0x33, m_ram[BYTES_PER_ROW - 1]);
+  EXPECT_EQ(0x22, m_ram[BYTES_PER_ROW]);
+}
+
+TEST_F(PendingEFBCopiesTest, OverlapCoversTheWholeCopy)
+{
+  Add(MEMORY_STRIDE, 0x11);
+  const u32 end = MEMORY_STRIDE * NUM_ROWS + BYTES_PER_ROW;
+  EXPECT_FALSE(m_copies.Overlaps(0, MEMORY_STRIDE));
+  EXPECT_TRUE(m_copies.Overlaps(0, MEMORY_STRIDE + 1));
+  EXPECT_TRUE(m_copies.Overlaps(end - 1, 1));
+  EXPECT_FALSE(m_copies.Overlaps(end, MEMORY_STRIDE));
+}
+
+TEST_F(PendingEFBCopiesTest, DiscardDoesNotWrite)
+{
+  Add(0, 0x11);
+  Add(MEMORY_STRIDE * NUM_ROWS, 0x22);
+
+  // Loading a savestate replaces RAM, so the copies made before it are dropped.
+  const PendingEFBCopies::StagingTextures textures = m_copies.Discard();
+  ASSERT_EQ(2u, textures.size());
+  EXPECT_NE(nullptr, textures[0]);
+  EXPECT_TRUE(m_copies.IsEmpty());
+  EXPECT_FALSE(m_copies.Overlaps(0, sizeof(m_ram)));
+
+  EXPECT_TRUE(Flush().empty());
+  for (u8 value : m_ram)
+    EXPECT_EQ(0, value);
+}
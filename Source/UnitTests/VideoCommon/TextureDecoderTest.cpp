@@ -0,0 +1,147 @@
+// Copyright 2018 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "Common/CPUDetect.h"
+#include "Common/CommonTypes.h"
+#include "Common/WorkerPool.h"
+#include "VideoCommon/TextureDecoder.h"
+
+namespace
+{
+constexpr int TEXTURE_SIZE = 1024;
+constexpr u32 WORKER_THREADS = 3;
+
+const TextureFormat s_formats[] = {
+    TextureFormat::I4,     TextureFormat::I8,     TextureFormat::IA4, TextureFormat::IA8,
+    TextureFormat::RGB565, TextureFormat::RGB5A3, TextureFormat::RGBA8, TextureFormat::C4,
+    TextureFormat::C8,     TextureFormat::C14X2,  TextureFormat::CMPR,
+};
+
+// Sizes are multiples of the largest block size (8x8), and include single-block textures.
+const std::pair<int, int> s_comparison_sizes[] = {{8, 8}, {16, 8}, {8, 16}, {24, 40}, {256, 128}};
+
+std::vector<TLUTFormat> GetTLUTFormats(TextureFormat format)
+{
+  if (IsColorIndexed(format))
+    return {TLUTFormat::IA8, TLUTFormat::RGB565, TLUTFormat::RGB5A3};
+  return {TLUTFormat::IA8};
+}
+
+class TextureDecoderTest : public testing::TestWithParam<TextureFormat>
+{
+protected:
+  void SetUp() override
+  {
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<int> byte(0, 255);
+
+    m_src.resize(TexDecoder_GetTextureSizeInBytes(TEXTURE_SIZE, TEXTURE_SIZE, GetParam()));
+    std::generate(m_src.begin(), m_src.end(), [&] { return static_cast<u8>(byte(rng)); });
+    std::generate(std::begin(m_tlut), std::end(m_tlut), [&] { return static_cast<u8>(byte(rng)); });
+
+    m_serial.resize(TEXTURE_SIZE * TEXTURE_SIZE * sizeof(u32));
+    m_parallel.resize(m_serial.size());
+    m_workers.Start(WORKER_THREADS, "TextureDecoderTest");
+    m_saved_cpu_info = cpu_info;
+  }
+
+  // The decoder tests pick code paths by changing cpu_info, which other tests rely on.
+  void TearDown() override { cpu_info = m_saved_cpu_info; }
+
+  void DecodeSerial(TLUTFormat tlutfmt)
+  {
+    TexDecoder_Decode(m_serial.data(), m_src.data(), TEXTURE_SIZE, TEXTURE_SIZE, GetParam(),
+                      m_tlut, tlutfmt);
+  }
+
+  void DecodeParallel(TLUTFormat tlutfmt)
+  {
+    const int block_rows = TEXTURE_SIZE / TexDecoder_GetBlockHeightInTexels(GetParam());
+    const u32 bands = WORKER_THREADS + 1;
+    const int rows_per_band = (block_rows + bands - 1) / bands;
+    m_workers.ParallelFor(bands, [&](u32 band) {
+      const int first_row = static_cast<int>(band) * rows_per_band;
+      TexDecoder_DecodeBlockRows(m_parallel.data(), m_src.data(), TEXTURE_SIZE, first_row,
+                                 std::min(rows_per_band, block_rows - first_row), GetParam(),
+                                 m_tlut, tlutfmt);
+    });
+  }
+
+  std::vector<u8> m_src;
+  alignas(16) u8 m_tlut[2 * 16384];
+  std::vector<u8> m_serial;
+  std::vector<u8> m_parallel;
+  Common::WorkerPool m_workers;
+  CPUInfo m_saved_cpu_info;
+};
+}  // namespace
+
+TEST_P(TextureDecoderTest, ParallelMatchesSerial)
+{
+  for (TLUTFormat tlutfmt : GetTLUTFormats(GetParam()))
+  {
+    DecodeSerial(tlutfmt);
+    DecodeParallel(tlutfmt);
+    EXPECT_EQ(m_serial, m_parallel);
+  }
+}
+
+// Runs every code path the host supports, picked through cpu_info, against the portable decoder.
+TEST_P(TextureDecoderTest, MatchesGenericDecoder)
+{
+  struct CodePath
+  {
+    const char* name;
+    bool avx2;
+    bool ssse3;
+  };
+  const CodePath paths[] = {{"AVX2", true, true}, {"SSSE3", false, true}, {"plain", false, false}};
+
+  const bool has_avx2 = cpu_info.bAVX2;
+  const bool has_ssse3 = cpu_info.bSSSE3;
+  std::vector<u32> expected(TEXTURE_SIZE * TEXTURE_SIZE);
+  std::vector<u32> actual(expected.size());
+
+  for (const CodePath& path : paths)
+  {
+    if ((path.avx2 && !has_avx2) || (path.ssse3 && !has_ssse3))
+    {
+      std::printf("skipping %s decoders, not supported by this CPU\n", path.name);
+      continue;
+    }
+
+    cpu_info.bAVX2 = path.avx2;
+    cpu_info.bSSSE3 = path.ssse3;
+    for (TLUTFormat tlutfmt : GetTLUTFormats(GetParam()))
+    {
+      for (const auto& size : s_comparison_sizes)
+      {
+        const size_t texels = static_cast<size_t>(size.first) * size.second;
+        std::fill_n(expected.begin(), texels, 0xDEADBEEF);
+        std::fill_n(actual.begin(), texels, 0xDEADBEEF);
+        TexDecoder_DecodeImplGeneric(expected.data(), m_src.data(), size.first, size.second,
+                                     GetParam(), m_tlut, tlutfmt);
+        _TexDecoder_DecodeImpl(actual.data(), m_src.data(), size.first, size.second, GetParam(),
+                               m_tlut, tlutfmt);
+
+        const auto mismatch = std::mismatch(expected.begin(), expected.begin() + texels,
+                                            actual.begin());
+        EXPECT_EQ(expected.begin() + texels, mismatch.first)
+            << path.name << " decoder, tlut " << static_cast<int>(tlutfmt) << ", " << size.first
+            << "x" << size.second << ": texel " << (mismatch.first - expected.begin())
+            << " differs";
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(AllFormats, TextureDecoderTest, testing::ValuesIn(s_formats));
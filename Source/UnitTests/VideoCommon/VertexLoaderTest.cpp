@@ -7,6 +7,7 @@
 #include <tuple>
 #include <type_traits>
 #include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest.h>  // NOLINT
 
@@ -355,3 +356,60 @@ TEST_F(VertexLoaderTest, LargeFloatVertexSpeed)
   for (int i = 0; i < 100; ++i)
     RunVertices(100000);
 }
+
+TEST_F(VertexLoaderTest, FormatSwitchingSpeed)
+{
+  // A synthetic draw stream which switches vertex formats on every draw, like games which reuse a
+  // single VAT slot for everything. This mostly measures the loader lookup.
+  struct Format
+  {
+    TVtxDesc vtx_desc;
+    VAT vtx_attr;
+    int vertex_size;
+  };
+  std::vector<Format> formats;
+  for (int pos_format : {FORMAT_UBYTE, FORMAT_BYTE, FORMAT_USHORT, FORMAT_SHORT, FORMAT_FLOAT})
+  {
+    for (int color : {NOT_PRESENT, DIRECT, INDEX8})
+    {
+      for (int tex_coord : {NOT_PRESENT, DIRECT, INDEX16})
+      {
+        Format format;
+        memset(&format.vtx_desc, 0, sizeof(format.vtx_desc));
+        memset(&format.vtx_attr, 0, sizeof(format.vtx_attr));
+        format.vtx_desc.Position = DIRECT;
+        format.vtx_desc.Color0 = color;
+        format.vtx_desc.Tex0Coord = tex_coord;
+        format.vtx_attr.g0.PosElements = 1;  // XYZ
+        format.vtx_attr.g0.PosFormat = pos_format;
+        format.vtx_attr.g0.Color0Elements = 1;  // Has Alpha
+        format.vtx_attr.g0.Color0Comp = FORMAT_32B_8888;
+        format.vtx_attr.g0.Tex0CoordElements = 1;  // ST
+        format.vtx_attr.g0.Tex0CoordFormat = FORMAT_FLOAT;
+        format.vertex_size =
+            VertexLoaderBase::CreateVertexLoader(format.vtx_desc, format.vtx_attr)->m_VertexSize;
+        formats.push_back(format);
+      }
+    }
+  }
+
+  VertexLoaderManager::Init();
+  for (int draw = 0; draw < 1000000; draw++)
+  {
+    const Format& format = formats[(draw * 7) % formats.size()];
+    const int vtx_attr_group = draw & 7;
+    LoadCPReg(0x50, format.vtx_desc.Hex & 0x1FFFF, true);
+    LoadCPReg(0x60, format.vtx_desc.Hex >> 17, true);
+    LoadCPReg(0x70 + vtx_attr_group, format.vtx_attr.g0.Hex, true);
+    LoadCPReg(0x80 + vtx_attr_group, format.vtx_attr.g1.Hex, true);
+    LoadCPReg(0x90 + vtx_attr_group, format.vtx_attr.g2.Hex, true);
+
+    const int size = VertexLoaderManager::RunVertices(vtx_attr_group, 0, 3, m_src, true);
+    if (size != 3 * format.vertex_size)
+    {
+      ADD_FAILURE() << "draw " << draw << " used the wrong loader";
+      break;
+    }
+  }
+  VertexLoaderManager::Clear();
+}